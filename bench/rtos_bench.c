@@ -0,0 +1,548 @@
+// Headless microbenchmarks for the scheduler, ML engine, memory matrix and
+// fault-tolerance hot paths. Results go to a JSON report as ns/op with
+// percentiles over batched samples.
+//
+// Usage: rtos_bench [--output <report.json>] [--samples <n>] [--filter <name>] [--threads <n>]
+
+#include "../include/system_config.h"
+#include "../include/task_manager.h"
+#include "../include/scheduler.h"
+#include "../include/ml_engine.h"
+#include "../include/memory_matrix.h"
+#include "../include/fault_tolerance.h"
+#include "../include/tmr_vote.h"
+#include "../include/schedulability.h"
+#include "../include/sched_policy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#define BENCH_DEFAULT_SAMPLES 1000
+#define BENCH_BATCH_NS 20000    // Shortest batch, so timer overhead stays negligible
+#define BENCH_MAX_RUN_MS 2000   // Per-benchmark cap; slow cases keep fewer samples
+#define BENCH_MIN_SAMPLES 10
+#define BENCH_MAX_THREADS 16
+#define BENCH_MAX_TASKS 4096
+#define BENCH_MEMORY_BYTES 64
+#define BENCH_VOTE_BYTES (64 * 1024)
+
+// External functions
+extern void kernel_init(void);
+extern TaskHotTable *kernel_get_hot_tasks(void);
+extern int kernel_read_task_slot(int slot, Task *snapshot);
+extern int kernel_set_task_release_gated(uint32_t taskId, uint8_t gated);
+extern int kernel_has_dispatchable_task(void);
+
+// Runs one batch of the operation under test
+typedef void (*BenchFn)(void *arg, uint32_t iterations);
+
+typedef struct
+{
+    const char *outputPath;
+    uint32_t samples;
+    const char *filter; // Only benchmarks whose name contains this
+    int maxThreads;
+} BenchConfig;
+
+// One sampling thread of a benchmark
+typedef struct
+{
+    BenchFn fn;
+    void *arg;
+    uint32_t iterations;
+    uint32_t samples;
+    uint32_t taken;
+    double *nsPerOp;
+    HANDLE start;
+} BenchWorker;
+
+typedef struct
+{
+    const TaskHotTable *hot;
+    SystemStateVector state;
+} DecideArgs;
+
+typedef struct
+{
+    Task task;
+    SystemStateVector state;
+} PriorityArgs;
+
+typedef struct
+{
+    uint8_t *replicas[3];
+    uint8_t *out;
+    size_t size;
+} VoteArgs;
+
+static BenchConfig g_config;
+static FILE *g_report = NULL;
+static int g_reportedCount = 0;
+static double g_nsPerCount = 1.0;
+static volatile uint32_t g_sink = 0; // Keeps results alive so batches are not optimized away
+
+static uint64_t bench_now_ns(void)
+{
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * g_nsPerCount);
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double left = *(const double *)a;
+    double right = *(const double *)b;
+    return (left > right) - (left < right);
+}
+
+static double percentile(const double *sorted, uint32_t count, double fraction)
+{
+    uint32_t index = (uint32_t)(fraction * (count - 1) + 0.5);
+    return sorted[index];
+}
+
+static void bench_task_body(void *args)
+{
+    (void)args;
+}
+
+// Time batches of the operation until the sample count or the time cap is reached
+static void bench_sample(BenchWorker *worker)
+{
+    uint64_t deadline = bench_now_ns() + (uint64_t)BENCH_MAX_RUN_MS * 1000000;
+
+    worker->fn(worker->arg, worker->iterations); // Warm caches and branch predictors
+    for (worker->taken = 0; worker->taken < worker->samples; worker->taken++)
+    {
+        uint64_t start = bench_now_ns();
+        worker->fn(worker->arg, worker->iterations);
+        uint64_t end = bench_now_ns();
+        worker->nsPerOp[worker->taken] = (double)(end - start) / worker->iterations;
+
+        if (end > deadline && worker->taken + 1 >= BENCH_MIN_SAMPLES)
+        {
+            worker->taken++;
+            break;
+        }
+    }
+}
+
+static DWORD WINAPI bench_worker_func(LPVOID lpParam)
+{
+    BenchWorker *worker = (BenchWorker *)lpParam;
+    WaitForSingleObject(worker->start, INFINITE);
+    bench_sample(worker);
+    return 0;
+}
+
+// Smallest power-of-two batch that takes at least BENCH_BATCH_NS
+static uint32_t bench_calibrate(BenchFn fn, void *arg)
+{
+    uint32_t iterations = 1;
+    for (;;)
+    {
+        uint64_t start = bench_now_ns();
+        fn(arg, iterations);
+        if (bench_now_ns() - start >= BENCH_BATCH_NS || iterations >= (1u << 24))
+        {
+            return iterations;
+        }
+        iterations *= 2;
+    }
+}
+
+// Run a benchmark on the given number of threads at once and append its
+// merged per-operation latencies to the report. params is a JSON fragment
+// ending in ", " (or empty).
+static void bench_run(const char *name, const char *params, BenchFn fn, void *arg, int threads)
+{
+    if (g_config.filter && !strstr(name, g_config.filter))
+    {
+        return;
+    }
+
+    BenchWorker workers[BENCH_MAX_THREADS];
+    HANDLE handles[BENCH_MAX_THREADS];
+    uint32_t iterations = bench_calibrate(fn, arg);
+    double *samples = (double *)malloc((size_t)threads * g_config.samples * sizeof(double));
+    HANDLE start = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (!samples || !start)
+    {
+        printf("Error: Out of resources for benchmark %s\n", name);
+        free(samples);
+        if (start)
+        {
+            CloseHandle(start);
+        }
+        return;
+    }
+
+    for (int i = 0; i < threads; i++)
+    {
+        workers[i].fn = fn;
+        workers[i].arg = arg;
+        workers[i].iterations = iterations;
+        workers[i].samples = g_config.samples;
+        workers[i].taken = 0;
+        workers[i].nsPerOp = samples + (size_t)i * g_config.samples;
+        workers[i].start = start;
+    }
+
+    if (threads == 1)
+    {
+        bench_sample(&workers[0]);
+    }
+    else
+    {
+        for (int i = 0; i < threads; i++)
+        {
+            handles[i] = CreateThread(NULL, 0, bench_worker_func, &workers[i], 0, NULL);
+            if (!handles[i])
+            {
+                printf("Error: Failed to create benchmark thread\n");
+                exit(1);
+            }
+        }
+        SetEvent(start); // Release them together so they really contend
+        WaitForMultipleObjects(threads, handles, TRUE, INFINITE);
+        for (int i = 0; i < threads; i++)
+        {
+            CloseHandle(handles[i]);
+        }
+    }
+    CloseHandle(start);
+
+    // Pack the per-thread samples together, then sort for percentiles
+    uint32_t count = 0;
+    double sum = 0.0;
+    for (int i = 0; i < threads; i++)
+    {
+        for (uint32_t s = 0; s < workers[i].taken; s++)
+        {
+            sum += workers[i].nsPerOp[s];
+            samples[count++] = workers[i].nsPerOp[s];
+        }
+    }
+    qsort(samples, count, sizeof(double), compare_doubles);
+
+    fprintf(g_report, "%s\n    {\"name\": \"%s\", %s\"threads\": %d, \"batch\": %u, \"samples\": %u, ",
+            g_reportedCount ? "," : "", name, params, threads, iterations, count);
+    fprintf(g_report, "\"nsPerOp\": {\"mean\": %.2f, \"min\": %.2f, \"p50\": %.2f, \"p90\": %.2f, \"p99\": %.2f, \"max\": %.2f}}",
+            sum / count, samples[0], percentile(samples, count, 0.50), percentile(samples, count, 0.90),
+            percentile(samples, count, 0.99), samples[count - 1]);
+    fflush(g_report);
+    g_reportedCount++;
+
+    printf("%-24s %sthreads=%d: p50 %.1f ns/op, p99 %.1f ns/op\n",
+           name, params, threads, percentile(samples, count, 0.50), percentile(samples, count, 0.99));
+    free(samples);
+}
+
+static void bench_decide(void *arg, uint32_t iterations)
+{
+    DecideArgs *args = (DecideArgs *)arg;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        g_sink += fpga_scheduler_decide(args->hot, &args->state).taskId;
+    }
+}
+
+static void bench_dynamic_priority(void *arg, uint32_t iterations)
+{
+    PriorityArgs *args = (PriorityArgs *)arg;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        g_sink += (uint32_t)(compute_dynamic_priority(&args->task, &args->state) * 1000.0f);
+    }
+}
+
+static void bench_predict_urgency(void *arg, uint32_t iterations)
+{
+    PriorityArgs *args = (PriorityArgs *)arg;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        g_sink += (uint32_t)(ml_predict_urgency(&args->task, &args->state) * 1000.0f);
+    }
+}
+
+static void bench_memory_write(void *arg, uint32_t iterations)
+{
+    uint8_t data[BENCH_MEMORY_BYTES];
+    memset(data, (int)(uintptr_t)arg, sizeof(data));
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        data[0] = (uint8_t)i;
+        memory_matrix_write(SHM_USER_DATA, data, sizeof(data));
+    }
+}
+
+static void bench_memory_read(void *arg, uint32_t iterations)
+{
+    uint8_t data[BENCH_MEMORY_BYTES];
+    (void)arg;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        memory_matrix_read(SHM_USER_DATA, data, sizeof(data));
+        g_sink += data[0];
+    }
+}
+
+static void bench_fault_check_idle(void *arg, uint32_t iterations)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        g_sink += (uint32_t)fault_check_system();
+    }
+}
+
+// Report, collect and (with no recovery pool running) recover inline
+static void bench_fault_round_trip(void *arg, uint32_t iterations)
+{
+    uint32_t taskId = (uint32_t)(uintptr_t)arg;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        fault_report(COMMUNICATION_FAULT, taskId, 0);
+        g_sink += (uint32_t)fault_check_system();
+    }
+}
+
+static void bench_tmr_voting(void *arg, uint32_t iterations)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        g_sink += tmr_voting(i, i ^ 0x10u, i);
+    }
+}
+
+static void bench_tmr_vote_buffers(void *arg, uint32_t iterations)
+{
+    VoteArgs *args = (VoteArgs *)arg;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        g_sink += (uint32_t)tmr_vote_buffers(args->replicas[0], args->replicas[1], args->replicas[2],
+                                             args->size, args->out, 0, NULL);
+    }
+}
+
+// Grow the task table to count tasks with spread-out periods and deadlines
+static void bench_add_tasks(int count)
+{
+    static int created = 0;
+    char name[32];
+
+    for (; created < count; created++)
+    {
+        Task task;
+        uint32_t periodMs = 10 + (uint32_t)(created * 37) % 990;
+        snprintf(name, sizeof(name), "Bench%d", created);
+        // DAL_C/D only: no watchdogs or replicas, which the benchmarks do not exercise
+        if (task_create(&task, name, bench_task_body, NULL, periodMs, periodMs - periodMs / 10,
+                        created % 2 ? DAL_D : DAL_C) < 0)
+        {
+            printf("Error: Failed to create benchmark task %d\n", created);
+            exit(1);
+        }
+        // The kernel is not started, so no release ever arrives; ungated,
+        // every task stays dispatchable and the policies decide over all of them
+        kernel_set_task_release_gated(task.id, 0);
+    }
+}
+
+// Every registered policy, through the kernel's decision entry point
+static void bench_scheduler(void)
+{
+    char params[96];
+    DecideArgs args;
+
+    memset(&args.state, 0, sizeof(args.state));
+    args.state.cpuLoad = 0.6f;
+    args.state.memoryUsage = 0.5f;
+    args.state.temperature = 45.0f;
+    args.state.powerConsumption = 2.0f;
+
+    for (int tasks = 4; tasks <= BENCH_MAX_TASKS; tasks *= 4)
+    {
+        bench_add_tasks(tasks);
+        args.hot = kernel_get_hot_tasks();
+        if (!kernel_has_dispatchable_task())
+        {
+            printf("Error: No dispatchable benchmark task; decisions would be timed over an empty set\n");
+            exit(1);
+        }
+        for (int p = 0; p < sched_policy_count(); p++)
+        {
+            const char *policy = sched_policy_at(p)->name;
+            scheduler_set_policy(policy);
+            snprintf(params, sizeof(params), "\"policy\": \"%s\", \"tasks\": %d, ", policy, tasks);
+            bench_run("fpga_scheduler_decide", params, bench_decide, &args, 1);
+        }
+    }
+    scheduler_set_policy(SCHEDULER_DEFAULT_POLICY);
+}
+
+static void bench_ml(void)
+{
+    PriorityArgs args;
+
+    if (kernel_read_task_slot(0, &args.task) != 0)
+    {
+        return;
+    }
+    memset(&args.state, 0, sizeof(args.state));
+    args.state.cpuLoad = 0.6f;
+    args.state.memoryUsage = 0.5f;
+    args.state.temperature = 45.0f;
+    args.state.powerConsumption = 2.0f;
+
+    bench_run("compute_dynamic_priority", "", bench_dynamic_priority, &args, 1);
+    bench_run("ml_predict_urgency", "", bench_predict_urgency, &args, 1);
+}
+
+static void bench_memory(void)
+{
+    char params[64];
+    snprintf(params, sizeof(params), "\"bytes\": %d, ", BENCH_MEMORY_BYTES);
+
+    for (int threads = 1; threads <= g_config.maxThreads; threads *= 2)
+    {
+        bench_run("memory_matrix_write", params, bench_memory_write, (void *)(uintptr_t)0x5A, threads);
+        bench_run("memory_matrix_read", params, bench_memory_read, NULL, threads);
+    }
+}
+
+static void bench_fault(void)
+{
+    Task snapshot;
+
+    bench_run("fault_check_system", "\"pending\": 0, ", bench_fault_check_idle, NULL, 1);
+    if (kernel_read_task_slot(1, &snapshot) == 0)
+    {
+        bench_run("fault_check_system", "\"pending\": 1, ", bench_fault_round_trip, (void *)(uintptr_t)snapshot.id, 1);
+    }
+}
+
+static void bench_tmr(void)
+{
+    VoteArgs args;
+    char params[96];
+
+    bench_run("tmr_voting", "", bench_tmr_voting, NULL, 1);
+
+    args.size = BENCH_VOTE_BYTES;
+    args.out = (uint8_t *)malloc(args.size);
+    for (int i = 0; i < 3; i++)
+    {
+        args.replicas[i] = (uint8_t *)malloc(args.size);
+        if (args.replicas[i])
+        {
+            memset(args.replicas[i], 0xA5, args.size);
+        }
+    }
+    if (args.out && args.replicas[0] && args.replicas[1] && args.replicas[2])
+    {
+        snprintf(params, sizeof(params), "\"bytes\": %d, \"isa\": \"%s\", ", BENCH_VOTE_BYTES, tmr_vote_isa());
+        bench_run("tmr_vote_buffers", params, bench_tmr_vote_buffers, &args, 1);
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        free(args.replicas[i]);
+    }
+    free(args.out);
+}
+
+static int parse_bench_args(int argc, char *argv[], BenchConfig *config)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+
+    memset(config, 0, sizeof(BenchConfig));
+    config->outputPath = "rtos_bench.json";
+    config->samples = BENCH_DEFAULT_SAMPLES;
+    config->maxThreads = info.dwNumberOfProcessors < BENCH_MAX_THREADS ? (int)info.dwNumberOfProcessors : BENCH_MAX_THREADS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *option = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value)
+        {
+            return -1;
+        }
+        i++;
+
+        if (strcmp(option, "--output") == 0)
+        {
+            config->outputPath = value;
+        }
+        else if (strcmp(option, "--samples") == 0)
+        {
+            config->samples = (uint32_t)strtoul(value, NULL, 10);
+        }
+        else if (strcmp(option, "--filter") == 0)
+        {
+            config->filter = value;
+        }
+        else if (strcmp(option, "--threads") == 0)
+        {
+            config->maxThreads = atoi(value);
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    if (config->samples < BENCH_MIN_SAMPLES || config->maxThreads < 1 || config->maxThreads > BENCH_MAX_THREADS)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (parse_bench_args(argc, argv, &g_config) != 0)
+    {
+        printf("Usage: %s [--output <report.json>] [--samples <n>] [--filter <name>] [--threads <1-%d>]\n",
+               argv[0], BENCH_MAX_THREADS);
+        return 1;
+    }
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    g_nsPerCount = 1000000000.0 / (double)frequency.QuadPart;
+
+    g_report = fopen(g_config.outputPath, "w");
+    if (!g_report)
+    {
+        printf("Error: Cannot create %s\n", g_config.outputPath);
+        return 1;
+    }
+
+    // The kernel is initialized but not started: no scheduler, monitor or
+    // recovery threads compete with the code under test
+    kernel_init();
+    sched_analysis_set_mode(ADMISSION_OFF); // Synthetic sets of up to 4096 tasks overload on purpose
+    bench_add_tasks(4);
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    fprintf(g_report, "{\n  \"timerResolutionNs\": %.1f,\n  \"processors\": %u,\n  \"benchmarks\": [",
+            g_nsPerCount, (unsigned)info.dwNumberOfProcessors);
+
+    bench_ml();
+    bench_memory();
+    bench_fault();
+    bench_tmr();
+    bench_scheduler(); // Last, since it grows the task table
+
+    fprintf(g_report, "\n  ]\n}\n");
+    fclose(g_report);
+
+    printf("%d benchmarks written to %s\n", g_reportedCount, g_config.outputPath);
+    return 0;
+}
@@ -0,0 +1,39 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CHECKPOINT_MAX_AREAS 64
+#define CHECKPOINT_NO_AREA 0 // Area IDs are never 0, so zeroed structures hold no area
+
+// Copy accounting for one area, or summed over all areas
+typedef struct
+{
+    uint64_t checkpoints;
+    uint64_t pagesCopied;
+    uint64_t rollbacks;
+    uint64_t pagesRestored;
+    uint64_t rejected;         // Checkpoints skipped because a written page failed verification
+    uint64_t lastCheckpointUs; // timer_wheel_now_us() of the latest checkpoint
+} CheckpointStats;
+
+// Called for one written page at offset; a verifier returns nonzero to
+// reject the page
+typedef int (*CheckpointPageFn)(void *arg, size_t offset, size_t size);
+
+// Function prototypes
+void checkpoint_init(void);
+int checkpoint_create(size_t size, const char *name, void **memory);
+void checkpoint_destroy(int areaId);
+int checkpoint_pin(int areaId);
+void checkpoint_unpin(int areaId);
+int checkpoint_take(int areaId, CheckpointPageFn verify, void *arg);
+int checkpoint_take_if_due(int areaId, uint32_t periodMs);
+int checkpoint_rollback(int areaId, CheckpointPageFn restored, void *arg);
+int checkpoint_request_rollback(int areaId);
+int checkpoint_apply_pending(int areaId);
+int checkpoint_get_stats(int areaId, CheckpointStats *stats);
+void checkpoint_get_totals(CheckpointStats *stats);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,54 @@
+#ifndef CYCLIC_SCHEDULE_H
+#define CYCLIC_SCHEDULE_H
+
+#include "system_config.h"
+#include "scheduler.h"
+#include <stdint.h>
+
+#define CYCLIC_IDLE 0xFFFFu // Table entry that starts no job
+
+// A task as the table was built for it; live tasks are matched by name
+typedef struct
+{
+    char name[32];
+    uint32_t periodMs;
+    uint32_t deadlineMs;
+    uint32_t executionTimeMs;
+} CyclicTableTask;
+
+// Static dispatch table over one hyperperiod, one entry per quantum. An
+// entry names the task whose job starts in that quantum, or CYCLIC_IDLE for
+// a free quantum or one a running job still occupies.
+typedef struct
+{
+    uint32_t quantumUs;
+    uint32_t length; // Entries; the hyperperiod is length x quantumUs
+    uint32_t taskCount;
+    const CyclicTableTask *tasks;
+    const uint16_t *entries; // Index into tasks, or CYCLIC_IDLE
+} CyclicTable;
+
+typedef struct
+{
+    uint8_t enabled;  // A table is driving dispatch
+    uint32_t length;
+    uint32_t quantumUs;
+    uint32_t taskCount;
+    uint64_t dispatches;    // Jobs started from the table
+    uint64_t idleFrames;    // Quanta that started nothing, including inactive tasks' entries
+    uint64_t skippedFrames; // Job starts passed over while an earlier job overran
+    uint32_t fallbacks;     // Tables dropped because the task set changed
+} CyclicStats;
+
+// Function prototypes
+int cyclic_build_table(const CyclicTableTask *tasks, uint32_t taskCount, uint32_t quantumUs, CyclicTable *table);
+int cyclic_build_live_table(CyclicTable *table);
+void cyclic_free_table(CyclicTable *table);
+int cyclic_emit_source(const CyclicTable *table, const char *path, const char *symbol);
+int cyclic_enable(const CyclicTable *table);
+void cyclic_disable(void);
+int cyclic_dispatch(const TaskHotTable *hot, uint64_t nowUs, ScheduleDecision *decision);
+uint64_t cyclic_next_event_us(uint64_t nowUs);
+void cyclic_get_stats(CyclicStats *stats);
+
+#endif // CYCLIC_SCHEDULE_H
@@ -0,0 +1,28 @@
+#ifndef FAULT_CAMPAIGN_H
+#define FAULT_CAMPAIGN_H
+
+#include "system_config.h"
+#include "fault_tolerance.h"
+#include <stdint.h>
+
+#define FAULT_CAMPAIGN_DRAIN_MS 2000   // Max wait for outstanding recoveries at the end
+#define FAULT_CAMPAIGN_MAX_RATE 1000000 // Faults per second; injections are scheduled in whole microseconds
+
+// Headless fault-injection campaign. Faults come from a script when
+// scriptPath is set, otherwise at a fixed rate into random live tasks.
+typedef struct
+{
+    uint32_t durationMs;
+    uint32_t faultsPerSecond;
+    uint32_t typeMask; // Bit (1 << FaultType) for each type to draw from
+    uint32_t seed;
+    const char *scriptPath; // Lines of "<offset ms> <TYPE> <task name>"
+    const char *outputPath; // JSON report
+} FaultCampaignConfig;
+
+// Function prototypes
+void fault_campaign_defaults(FaultCampaignConfig *config);
+int fault_campaign_parse_types(const char *list, uint32_t *typeMask);
+int fault_campaign_run(const FaultCampaignConfig *config);
+
+#endif // FAULT_CAMPAIGN_H
@@ -15,6 +15,9 @@ typedef enum
     POWER_FAULT
 } FaultType;
 
+#define FAULT_TYPE_COUNT (POWER_FAULT + 1)
+#define FAULT_LATENCY_BUCKETS 128 // Log-linear, four buckets per power of two microseconds
+
 // Fault detection result
 typedef struct
 {
@@ -23,15 +26,43 @@ typedef struct
     uint32_t taskId;
     uint32_t address;
     uint64_t timestamp;
+    uint64_t raisedUs;   // Injected, reported or expired (timer wheel clock)
+    uint64_t detectedUs; // Collected by the fault monitor
 } FaultDetectionResult;
 
+// Latency distribution for one fault type at one criticality level
+typedef struct
+{
+    uint64_t count;
+    uint64_t detectSumUs; // Raised to detected
+    uint64_t detectMaxUs;
+    uint64_t recoverSumUs; // Raised to recovery complete
+    uint64_t recoverMaxUs;
+    uint32_t detectHistogram[FAULT_LATENCY_BUCKETS];
+    uint32_t recoverHistogram[FAULT_LATENCY_BUCKETS];
+} FaultLatencyStats;
+
 // Function prototypes
 void fault_tolerance_init(void);
-FaultDetectionResult fault_check_system(void);
+void fault_recovery_start(void);
+void fault_recovery_stop(void);
+int fault_tolerance_reserve(int taskCapacity);
+void fault_tolerance_release(int slot);
+int fault_check_system(void);
+int fault_report(FaultType type, uint32_t taskId, uint32_t address);
+int fault_wait(uint32_t timeoutMs);
+void fault_wake_monitor(void);
 int fault_inject(FaultType type, uint32_t taskId, uint32_t address); // For testing
 void fault_recovery_action(FaultDetectionResult *result);
-uint8_t tmr_voting(uint32_t result1, uint32_t result2, uint32_t result3);
+uint32_t tmr_voting(uint32_t result1, uint32_t result2, uint32_t result3);
 float get_fault_recovery_factor(uint32_t taskId);
 void set_watchdog_timer(uint32_t taskId, uint32_t timeoutMs);
+const char *fault_type_name(FaultType type);
+
+// Recovery latency instrumentation
+int fault_get_latency_stats(FaultType type, CriticalityLevel criticality, FaultLatencyStats *stats);
+void fault_reset_latency_stats(void);
+uint64_t fault_latency_percentile(const uint32_t *histogram, uint64_t count, double percentile);
+void fault_latency_dump(void);
 
 #endif // FAULT_TOLERANCE_H
@@ -0,0 +1,35 @@
+#ifndef JOB_EXECUTOR_H
+#define JOB_EXECUTOR_H
+
+#include "system_config.h"
+#include "task_manager.h"
+#include <stdint.h>
+
+// job_execute outcomes
+#define JOB_COMPLETED 0
+#define JOB_OVERRAN 1   // Finished, but over budget
+#define JOB_DETACHED 2  // Demoted and left running on its own worker
+#define JOB_ABORTED -2
+#define JOB_NOT_RUN -1
+
+// Budget enforcement accounting
+typedef struct
+{
+    uint64_t jobs;
+    uint64_t overruns;
+    uint64_t demotions;
+    uint64_t aborts;
+    uint64_t detachedWorkers; // Workers left behind by demoted or unresponsive jobs
+    uint64_t detachRefusals;  // Detach attempts refused at BUDGET_MAX_DETACHED; retried on later polls
+    uint64_t maxOverrunUs;    // Largest CPU time past budget at detection
+} JobExecutorStats;
+
+// Function prototypes
+void job_executor_start(void);
+void job_executor_stop(void);
+uint32_t job_budget_us(const Task *task);
+int job_execute(const Task *task, uint32_t budgetUs, uint32_t *cpuUs);
+void job_abort_point(void);
+void job_executor_get_stats(JobExecutorStats *stats);
+
+#endif // JOB_EXECUTOR_H
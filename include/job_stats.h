@@ -0,0 +1,41 @@
+#ifndef JOB_STATS_H
+#define JOB_STATS_H
+
+#include "system_config.h"
+#include <stdint.h>
+
+#define JOB_TIMING_BUCKETS 128 // Log-linear, four buckets per power of two microseconds
+
+// Timing of one task's released jobs, from release to start and to finish
+typedef struct
+{
+    uint32_t taskId;
+    uint64_t jobs;      // Released jobs dispatched
+    uint64_t hits;      // Finished by their deadline
+    uint64_t misses;    // Finished late, abandoned or skipped
+    uint64_t abandoned; // Aborted, detached, or replicas out of time: no finish time
+    uint64_t skipped;   // Releases overwritten in the queue before they could run
+    uint64_t completed; // Jobs with a finish time (hits plus late finishes)
+    uint64_t latencySumUs; // Release to start
+    uint64_t latencyMaxUs;
+    uint64_t responseSumUs; // Release to finish
+    uint64_t responseMaxUs;
+    int64_t latenessSumUs; // Finish minus absolute deadline; negative when early
+    int64_t latenessMaxUs;
+    uint64_t tardinessMaxUs; // Lateness of late finishes
+    uint32_t latencyHistogram[JOB_TIMING_BUCKETS];
+    uint32_t responseHistogram[JOB_TIMING_BUCKETS];
+    uint32_t tardinessHistogram[JOB_TIMING_BUCKETS]; // Late finishes only
+} JobTimingStats;
+
+// Function prototypes
+int job_stats_reserve(int taskCapacity);
+void job_stats_release(int slot);
+int job_stats_record(uint32_t taskId, uint64_t releaseUs, uint64_t startUs, uint64_t finishUs,
+                     uint32_t deadlineMs, int completed);
+void job_stats_skip(uint32_t taskId, uint32_t releases);
+int job_stats_get(uint32_t taskId, JobTimingStats *stats);
+void job_stats_get_totals(JobTimingStats *stats);
+uint64_t job_stats_percentile(const uint32_t *histogram, uint64_t count, double percentile);
+
+#endif // JOB_STATS_H
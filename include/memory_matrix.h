@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "tmr_vote.h"
 
 // Shared memory region IDs
 typedef enum
@@ -16,6 +17,59 @@ typedef enum
     SHM_COUNT
 } SharedMemoryRegion;
 
+// Locking protocol used for a region lock
+typedef enum
+{
+    MM_LOCK_PLAIN,        // Plain critical section, no priority adjustment
+    MM_LOCK_PRIO_INHERIT, // Owner inherits the priority of a higher-priority waiter
+    MM_LOCK_PRIO_CEILING  // Owner runs at the region ceiling while it holds the lock
+} MemoryLockProtocol;
+
+// Blocking-time accounting for a region lock
+typedef struct
+{
+    uint64_t acquisitions;
+    uint64_t blockedAcquisitions;
+    uint64_t totalBlockingNs;
+    uint64_t maxBlockingNs;
+    uint32_t priorityBoosts;
+} MemoryLockStats;
+
+// Lock profiling: log2 histograms of nanoseconds, bucket i covers [2^i, 2^(i+1))
+#define MM_HISTOGRAM_BUCKETS 24
+#define MM_TOP_HOLDERS 4
+#define MM_NO_TASK 0xFFFFFFFFu
+
+// Fault addresses inside a region: flag, region in bits 24-30, byte offset below
+#define MM_FAULT_ADDRESS_FLAG 0x80000000u
+#define MM_FAULT_ADDRESS(region, offset) (MM_FAULT_ADDRESS_FLAG | ((uint32_t)(region) << 24) | ((uint32_t)(offset) & 0xFFFFFFu))
+
+typedef struct
+{
+    uint32_t taskId;
+    uint64_t acquisitions;
+    uint64_t holdNs;
+} MemoryLockHolder;
+
+typedef struct
+{
+    uint64_t acquisitions;
+    uint64_t contendedAcquisitions;
+    uint64_t totalWaitNs;
+    uint64_t totalHoldNs;
+    uint64_t waitHistogram[MM_HISTOGRAM_BUCKETS];
+    uint64_t holdHistogram[MM_HISTOGRAM_BUCKETS];
+    MemoryLockHolder topHolders[MM_TOP_HOLDERS]; // Sorted by hold time, unused entries have MM_NO_TASK
+} MemoryLockProfile;
+
+// Triple modular redundancy accounting for a replicated region
+typedef struct
+{
+    uint64_t votes;
+    uint64_t mismatchedWords;
+    uint64_t correctedBits;
+} MemoryTmrStats;
+
 // Function prototypes
 void memory_matrix_init(void);
 void *memory_matrix_get_region(SharedMemoryRegion region);
@@ -25,4 +79,28 @@ int memory_matrix_lock(SharedMemoryRegion region);
 int memory_matrix_unlock(SharedMemoryRegion region);
 void memory_matrix_barrier(void);
 
+// Priority-inversion control (ceilingPriority is a Win32 thread priority level)
+int memory_matrix_set_lock_protocol(SharedMemoryRegion region, MemoryLockProtocol protocol, int ceilingPriority);
+int memory_matrix_get_lock_stats(SharedMemoryRegion region, MemoryLockStats *stats);
+void memory_matrix_reset_lock_stats(void);
+
+// Contention and hold-time profiling (per region, collected per thread without locks)
+void memory_matrix_set_holder_task(uint32_t taskId);
+int memory_matrix_get_profile(SharedMemoryRegion region, MemoryLockProfile *profile);
+int memory_matrix_get_thread_profile(uint32_t threadSlot, SharedMemoryRegion region,
+                                     MemoryLockProfile *profile, uint32_t *threadId);
+void memory_matrix_profile_dump(void);
+void memory_matrix_profile_tick(void);
+
+// TMR replicas: writes go to all three copies, voting repairs the minority in place
+int memory_matrix_enable_tmr(SharedMemoryRegion region, int enabled);
+int memory_matrix_tmr_vote(SharedMemoryRegion region, TmrVoteReport *report);
+size_t memory_matrix_tmr_vote_all(void);
+int memory_matrix_get_tmr_stats(SharedMemoryRegion region, MemoryTmrStats *stats);
+
+// Incremental checkpoints: only pages written since the last checkpoint are copied
+int memory_matrix_checkpoint_all(void);
+int memory_matrix_rollback(SharedMemoryRegion region);
+int memory_matrix_region_from_address(uint32_t address, SharedMemoryRegion *region);
+
 #endif // MEMORY_MATRIX_H
@@ -0,0 +1,38 @@
+#ifndef MIXED_CRITICALITY_H
+#define MIXED_CRITICALITY_H
+
+#include "system_config.h"
+#include "task_manager.h"
+#include <stdint.h>
+
+// What happens to tasks less critical than the system's criticality mode
+typedef enum
+{
+    MC_SHED_DROP,    // Not dispatched until the system is back in DAL_D mode
+    MC_SHED_THROTTLE // Dispatched at most once every AMC_THROTTLE_FACTOR periods
+} McShedAction;
+
+typedef struct
+{
+    CriticalityLevel mode;      // DAL_D while every task runs
+    uint32_t modeSwitches;      // Raises of the mode by an overrun
+    uint32_t restores;          // Returns to DAL_D mode at an idle instant
+    uint32_t shedTasks;         // Tasks currently held back by the mode
+    uint64_t droppedJobs;       // Releases of shed tasks that never ran
+    uint64_t throttledJobs;     // Jobs shed tasks ran while throttled
+    uint64_t raisedUs;          // Time spent above DAL_D mode, up to the last restore
+    uint32_t lastTriggerTaskId; // Task whose overrun raised the mode last
+} McStats;
+
+// Function prototypes
+void mc_init(void);
+void mc_set_shed_action(McShedAction action);
+uint32_t mc_budget_us(const Task *task, CriticalityLevel mode);
+uint32_t mc_job_budget_us(const Task *task, uint32_t budgetUs);
+void mc_tick(uint64_t nowUs);
+uint64_t mc_next_event_us(uint64_t nowUs);
+void mc_job_complete(const Task *task, uint32_t usedUs, uint64_t nowUs);
+CriticalityLevel mc_get_mode(void);
+void mc_get_stats(McStats *stats);
+
+#endif // MIXED_CRITICALITY_H
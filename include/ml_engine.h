@@ -16,6 +16,7 @@ float ml_predict_urgency(Task *task, SystemStateVector *sysState);
 float fuzzy_adjust_priority(Task *task, float baseScore, SystemStateVector *sysState);
 void ml_update_task_history(Task *task);
 float compute_dynamic_priority(Task *task, SystemStateVector *sysState);
+float ml_dynamic_priority(Task *task, SystemStateVector *sysState, float faultFactor);
 void ml_model_integrity_check(void);
 int ml_load_model(const char *modelPath);
 
@@ -0,0 +1,40 @@
+#ifndef RESERVATION_SERVER_H
+#define RESERVATION_SERVER_H
+
+#include "system_config.h"
+#include "task_manager.h"
+#include <stdint.h>
+
+// How a server's budget comes back
+typedef enum
+{
+    SERVER_CBS,     // Hard constant-bandwidth server: full budget at each server deadline
+    SERVER_SPORADIC // Sporadic server: what a run consumed returns one period after it started
+} ServerKind;
+
+typedef struct
+{
+    char name[32];
+    ServerKind kind;
+    uint32_t taskId; // Task the scheduler dispatches for the server
+    uint32_t budgetUs;
+    uint32_t periodUs;
+    int64_t remainingUs; // Negative after an overrun; repaid from the next replenishment
+    uint32_t queued;
+    uint64_t jobs;        // Aperiodic jobs run
+    uint64_t rejected;    // Submitted while the queue was full
+    uint64_t exhaustions; // Runs that ended with work queued that did not fit the budget left
+    uint64_t consumedUs;
+    uint64_t responseSumUs; // Submit to finish
+    uint64_t responseMaxUs;
+} ServerStats;
+
+// Function prototypes
+int server_create(const char *name, ServerKind kind, uint32_t budgetMs, uint32_t periodMs,
+                  CriticalityLevel criticality);
+int server_submit(int serverId, void (*handler)(void *), void *args, uint32_t maxMs);
+int server_attach_task(int serverId, uint32_t taskId);
+int server_count(void);
+int server_get_stats(int serverId, ServerStats *stats);
+
+#endif // RESERVATION_SERVER_H
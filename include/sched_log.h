@@ -0,0 +1,59 @@
+#ifndef SCHED_LOG_H
+#define SCHED_LOG_H
+
+#include "scheduler.h"
+#include <stdint.h>
+
+// Scheduler input log: everything a policy decision depends on, recorded
+// from a live run so policy_eval can replay it against every policy
+typedef enum
+{
+    SCHED_LOG_TASK,    // Task added or changed: args period, deadline, execution ms, base priority
+    SCHED_LOG_REMOVE,  // Task deleted
+    SCHED_LOG_STATE,   // Scheduler system state: values load, memory, temperature, power
+    SCHED_LOG_RELEASE, // Job released
+    SCHED_LOG_JOB,     // Job ran: args[0] CPU time in us
+    SCHED_LOG_FAULT    // Fault recovered for the task: args[0] FaultType
+} SchedLogType;
+
+// Flags of a SCHED_LOG_TASK record
+#define SCHED_LOG_FLAG_ACTIVE 0x01
+#define SCHED_LOG_FLAG_SPORADIC 0x02
+
+// One fixed-size record; the log is a SchedLogHeader followed by these in time order
+typedef struct
+{
+    uint64_t timeUs; // timer_wheel_now_us
+    uint8_t type;    // SchedLogType
+    uint8_t criticality;
+    uint8_t flags; // SCHED_LOG_FLAG_* for tasks, SystemState for SCHED_LOG_STATE
+    uint8_t reserved;
+    uint32_t taskId; // Active task count for SCHED_LOG_STATE
+    union
+    {
+        uint32_t args[4];
+        float values[4];
+    };
+} SchedLogRecord;
+
+#define SCHED_LOG_MAGIC "RTOSREC1"
+#define SCHED_LOG_VERSION 1
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize; // sizeof(SchedLogRecord)
+} SchedLogHeader;
+
+// Function prototypes
+int sched_log_start(const char *path);
+void sched_log_stop(void);
+void sched_log_task(const Task *task);
+void sched_log_remove(uint32_t taskId);
+void sched_log_state(const SystemStateVector *state);
+void sched_log_release(uint32_t taskId);
+void sched_log_job(uint32_t taskId, uint32_t cpuUs);
+void sched_log_fault(uint32_t taskId, uint32_t faultType);
+
+#endif // SCHED_LOG_H
@@ -0,0 +1,59 @@
+#ifndef SCHED_POLICY_H
+#define SCHED_POLICY_H
+
+#include "scheduler.h"
+#include <stdint.h>
+
+#define SCHED_POLICY_MAX 16 // Built-in and registered policies
+
+// Dispatch order the admission test can analyze a policy under
+typedef enum
+{
+    SCHED_ORDER_NONE,    // No fixed order; admission uses the EDF demand test
+    SCHED_ORDER_PERIOD,  // Fixed priorities by period
+    SCHED_ORDER_DEADLINE // Fixed priorities by relative deadline
+} SchedPolicyOrder;
+
+// A scheduling policy. Every hook but pickNext is optional. Each user of a
+// policy (the kernel, each policy_eval replay) owns an instance with its own
+// state from init; the instance's hooks are called from one thread only.
+typedef struct
+{
+    const char *name;
+    SchedPolicyOrder order;
+    void *(*init)(void);           // Returns the instance state
+    void (*destroy)(void *state);
+    void (*onRelease)(void *state, uint32_t taskId, uint64_t releaseUs);
+    void (*onComplete)(void *state, uint32_t taskId, uint64_t finishUs, int missed);
+    ScheduleDecision (*pickNext)(void *state, const TaskHotTable *hot, SystemStateVector *system,
+                                 const SchedulerTaskView *view);
+} SchedPolicy;
+
+typedef struct
+{
+    const SchedPolicy *policy;
+    void *state;
+} SchedPolicyInstance;
+
+// Decision cost of a policy, summed over every instance
+typedef struct
+{
+    uint64_t decisions;
+    uint64_t decideNs;
+    uint64_t maxDecideNs;
+} SchedPolicyStats;
+
+// Function prototypes
+int sched_policy_register(const SchedPolicy *policy);
+const SchedPolicy *sched_policy_find(const char *name);
+int sched_policy_count(void);
+const SchedPolicy *sched_policy_at(int index);
+int sched_policy_instance_init(SchedPolicyInstance *instance, const SchedPolicy *policy);
+void sched_policy_instance_destroy(SchedPolicyInstance *instance);
+ScheduleDecision sched_policy_pick(SchedPolicyInstance *instance, const TaskHotTable *hot, SystemStateVector *system,
+                                   const SchedulerTaskView *view);
+void sched_policy_release(SchedPolicyInstance *instance, uint32_t taskId, uint64_t releaseUs);
+void sched_policy_complete(SchedPolicyInstance *instance, uint32_t taskId, uint64_t finishUs, int missed);
+int sched_policy_get_stats(const char *name, SchedPolicyStats *stats);
+
+#endif // SCHED_POLICY_H
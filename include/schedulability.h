@@ -0,0 +1,46 @@
+#ifndef SCHEDULABILITY_H
+#define SCHEDULABILITY_H
+
+#include "system_config.h"
+#include "task_manager.h"
+#include <stdint.h>
+
+// What task_create does with a task the admitted set cannot absorb
+typedef enum
+{
+    ADMISSION_OFF,     // Admit everything; the set is still tracked
+    ADMISSION_REJECT,  // Refuse the task
+    ADMISSION_DEGRADE  // Admit it at the shortest stretched period that fits, else refuse
+} AdmissionMode;
+
+typedef enum
+{
+    ADMISSION_ADMITTED,
+    ADMISSION_DEGRADED, // Admitted with a longer period and deadline
+    ADMISSION_REJECTED
+} AdmissionVerdict;
+
+typedef struct
+{
+    uint32_t admitted;
+    uint32_t rejected;
+    uint32_t degraded;
+    float utilization; // Of the admitted set, in dispatch quanta
+    uint8_t fixedPriority; // RMS or EDF: response times and worstSlackUs are known
+    uint32_t worstSlackUs; // Smallest deadline minus response time
+} SchedAnalysisStats;
+
+// Function prototypes
+void sched_analysis_init(void);
+void sched_analysis_set_mode(AdmissionMode mode);
+AdmissionVerdict sched_analysis_admit(uint32_t *periodMs, uint32_t *deadlineMs, uint32_t executionTimeMs,
+                                      uint32_t *reservation);
+void sched_analysis_commit(uint32_t reservation, uint32_t taskId);
+void sched_analysis_cancel(uint32_t reservation);
+int sched_analysis_update(uint32_t taskId, uint32_t executionTimeMs);
+int sched_analysis_check_modes(uint32_t taskId, CriticalityLevel criticality, const uint32_t budgetMs[4]);
+void sched_analysis_remove(uint32_t taskId);
+int sched_analysis_response_us(uint32_t taskId, uint64_t *responseUs);
+void sched_analysis_get_stats(SchedAnalysisStats *stats);
+
+#endif // SCHEDULABILITY_H
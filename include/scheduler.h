@@ -2,6 +2,7 @@
 #define SCHEDULER_H
 
 #include "task_manager.h"
+#include "task_table.h"
 
 // Scheduler decisions
 typedef struct
@@ -22,16 +23,28 @@ typedef struct
     SystemState state;
 } SystemStateVector;
 
+// Where a policy reads what the hot table does not hold: the live kernel by
+// default, or a replayed task set (see policy_eval)
+typedef struct
+{
+    int (*readTask)(void *context, int slot, Task *snapshot); // 0 if the slot holds a task
+    float (*faultFactor)(void *context, uint32_t taskId);     // As get_fault_recovery_factor
+    void *context;
+} SchedulerTaskView;
+
 // Function prototypes
 void scheduler_init(void);
 void scheduler_start(void);
 void scheduler_tick(void);
+uint64_t scheduler_next_event_us(void);
 ScheduleDecision scheduler_next_task(void);
 void scheduler_update_system_state(SystemStateVector *state);
 uint32_t scheduler_get_jitter_ns(void);
-void scheduler_set_policy(const char *policy);
+int scheduler_set_policy(const char *policy);
+const char *scheduler_get_policy(void);
+void scheduler_notify_release(uint32_t taskId, uint64_t releaseUs);
 
 // Simulated FPGA scheduler interface
-ScheduleDecision fpga_scheduler_decide(Task *tasks, int taskCount, SystemStateVector *state);
+ScheduleDecision fpga_scheduler_decide(const TaskHotTable *hot, SystemStateVector *state);
 
 #endif // SCHEDULER_H
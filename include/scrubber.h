@@ -0,0 +1,34 @@
+#ifndef SCRUBBER_H
+#define SCRUBBER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Scrub progress and findings
+typedef struct
+{
+    uint64_t blocksVerified;
+    uint64_t failures;       // Blocks whose checksum no longer matched
+    uint64_t cycles;         // Completed passes over every protected block
+    uint64_t lastCycleUs;
+    uint64_t maxCycleUs;
+    uint32_t protectedBlocks;
+} ScrubberStats;
+
+// Optional lock held around checksum reads and updates of an area
+typedef void (*ScrubLockFn)(void *arg);
+
+// Function prototypes
+void scrubber_init(void);
+int scrubber_protect(const char *name, const void *base, size_t size, uint32_t ownerTaskId,
+                     uint32_t faultAddressBase, ScrubLockFn lock, ScrubLockFn unlock, void *lockArg);
+void scrubber_unprotect(int areaId);
+void scrubber_update(int areaId, size_t offset, size_t size);
+int scrubber_run(uint32_t blockBudget);
+int scrubber_verify(int areaId);
+int scrubber_verify_range(int areaId, size_t offset, size_t size);
+void scrubber_get_stats(ScrubberStats *stats);
+uint32_t scrubber_crc32c(const void *data, size_t size);
+const char *scrubber_isa(void);
+
+#endif // SCRUBBER_H
@@ -2,10 +2,19 @@
 #define SYSTEM_CONFIG_H
 
 // System constants
-#define MAX_TASKS 32
+#define TASK_TABLE_INITIAL_CAPACITY 32 // Grows on demand up to TASK_TABLE_MAX_CAPACITY
+#define TASK_TABLE_CHUNK_SIZE 64        // Task descriptors are allocated in stable chunks
 #define MAX_PRIORITY_LEVELS 16
 #define SYSTEM_TICK_MS 1
 #define SCHEDULER_PERIOD_MS 10
+#define SCHEDULER_DEFAULT_POLICY "ML_HYBRID"
+#define SCHEDULER_TICKLESS 0 // 1 starts in tickless mode (see kernel_set_tickless)
+#define SCHED_RELEASE_QUEUE_SIZE 1024 // Releases awaiting the policy's onRelease hook, power of two
+
+// Timing wheel (watchdogs, delays, release timers)
+#define TIMER_WHEEL_TICK_US 100 // Expiry resolution
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_SLOT_BITS 6 // 64 slots per level
 
 // ML constants
 #define ML_FEATURE_COUNT 23
@@ -14,7 +23,66 @@
 // Fault tolerance
 #define FAULT_DETECTION_ENABLED 1
 #define TMR_ENABLED 1 // Triple Modular Redundancy
+#define TMR_MIN_CRITICALITY DAL_A // Tasks at or above this level run as three replicas
 #define VOTING_PERIOD_MS 10
+#define FAULT_EVENT_QUEUE_SIZE 256 // Pending fault reports, power of two
+#define FAULT_RECOVERY_WORKERS 4   // Recovery pool size; tasks are sharded across workers
+
+// Incremental checkpoints of memory-matrix regions and task state
+#define CHECKPOINT_ENABLED 1
+#define CHECKPOINT_PERIOD_MS 100
+
+// Background memory scrubbing (CRC32C per block, verified in idle-priority slots)
+#define SCRUB_ENABLED 1
+#define SCRUB_BLOCK_SIZE 256
+#define SCRUB_SLOT_MS 10
+#define SCRUB_BLOCKS_PER_SLOT 16 // Full cycle: ceil(protected blocks / 16) slots
+#define SCRUB_MAX_AREAS 32
+
+// CPU-time execution budgets
+#define BUDGET_ENABLED 1
+#define BUDGET_MARGIN_PERCENT 150 // Budget = margin x max(executionTimeMs, history mean + 3 sigma)
+#define BUDGET_POLL_MS 1          // Dispatcher accounting interval
+#define BUDGET_ABORT_GRACE_MS 5   // Time an aborted job gets to reach job_abort_point
+#define BUDGET_MAX_DETACHED 4     // Detached jobs alive at once; past this the dispatcher waits and retries
+
+// Per-job timing accounting
+#define JOB_RELEASE_QUEUE_DEPTH 16 // Pending releases per task whose release times are kept
+
+// Admission control: schedulability analysis in task_create
+#define ADMISSION_DEFAULT_MODE 1            // 0 admit all, 1 reject, 2 degrade (see AdmissionMode)
+#define ADMISSION_SYSTEM_BLOCKING_US 500    // Longest shared-region hold by kernel threads
+#define ADMISSION_MAX_STRETCH 4             // A degraded task runs at most 4x its requested period
+#define ADMISSION_MAX_DEMAND_POINTS 100000  // Larger EDF demand checks are refused, not trusted
+
+// Adaptive mixed criticality: an overrun of a task's budget for the current
+// mode raises the mode and sheds less critical tasks until an idle instant
+#define AMC_ENABLED 1
+#define AMC_DEFAULT_SHED 0     // 0 drop, 1 throttle (see McShedAction)
+#define AMC_THROTTLE_FACTOR 4  // A throttled task runs at most once per 4 of its periods
+
+// Reservation servers for aperiodic work (CBS and sporadic server)
+#define SERVER_MAX 16
+#define SERVER_QUEUE_DEPTH 64       // Queued aperiodic jobs per server
+#define SERVER_MAX_REPLENISHMENTS 8 // Pending sporadic-server replenishments; later ones merge
+
+// Cyclic executive: static dispatch tables over the hyperperiod
+#define CYCLIC_MAX_TABLE_ENTRIES 65536 // Longer hyperperiods are refused
+
+// Binary event tracing (per-thread rings drained to a file)
+#define TRACE_COMPILE_CATEGORIES 0x7F // TRACE_CAT_* bits compiled in; the rest cost nothing
+#define TRACE_RING_EVENTS 4096        // Per-thread ring capacity, power of two
+#define TRACE_MAX_THREADS 64
+#define TRACE_DRAIN_MS 20
+
+// Scheduler input log for offline policy evaluation (lossless, double-buffered)
+#define SCHED_LOG_BUFFER_RECORDS 8192 // Initial records per buffer; full buffers grow
+#define SCHED_LOG_FLUSH_MS 50
+
+// Memory matrix lock profiling
+#define MEMORY_PROFILER_ENABLED 1
+#define MEMORY_PROFILER_MAX_THREADS 16
+#define MEMORY_PROFILER_DUMP_PERIOD_MS 5000
 
 // Task criticality levels (DAL - Design Assurance Level)
 typedef enum
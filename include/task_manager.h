@@ -4,6 +4,33 @@
 #include "system_config.h"
 #include <stdint.h>
 
+// Task IDs are handles: the low bits index a table slot, the high bits carry a
+// generation that is bumped whenever the slot is recycled, so stale IDs are rejected
+#define TASK_HANDLE_SLOT_BITS 20
+#define TASK_HANDLE_GENERATION_MASK 0x7FFu // Keeps handles positive as int
+#define TASK_HANDLE_SLOT(handle) ((uint32_t)(handle) & ((1u << TASK_HANDLE_SLOT_BITS) - 1))
+#define TASK_HANDLE_GENERATION(handle) (((uint32_t)(handle) >> TASK_HANDLE_SLOT_BITS) & TASK_HANDLE_GENERATION_MASK)
+#define TASK_HANDLE_MAKE(slot, generation) \
+    ((((uint32_t)(generation) & TASK_HANDLE_GENERATION_MASK) << TASK_HANDLE_SLOT_BITS) | (uint32_t)(slot))
+#define TASK_TABLE_MAX_CAPACITY (1 << TASK_HANDLE_SLOT_BITS)
+#define TASK_INVALID_ID 0xFFFFFFFFu
+
+// Redundant execution of a task
+typedef enum
+{
+    TMR_MODE_OFF,
+    TMR_MODE_FULL, // Vote once all three replicas finish
+    TMR_MODE_EARLY // Commit as soon as two replicas agree
+} TmrMode;
+
+// What happens when a job exceeds its CPU-time budget
+typedef enum
+{
+    BUDGET_ACTION_NOTIFY, // Report a TIMING_FAULT and let the job finish
+    BUDGET_ACTION_DEMOTE, // Also drop the job to low priority and stop waiting for it
+    BUDGET_ACTION_ABORT   // Also abort the job at its next job_abort_point
+} BudgetAction;
+
 // Task structure
 typedef struct
 {
@@ -14,6 +41,7 @@ typedef struct
     uint32_t periodMs;
     uint32_t deadlineMs;
     uint32_t executionTimeMs;
+    uint32_t criticalityBudgetMs[4]; // CPU time per criticality mode (CriticalityLevel); 0 = no budget there
     uint32_t basePriority;
     uint32_t dynamicPriority;
     CriticalityLevel criticality;
@@ -22,12 +50,22 @@ typedef struct
     uint32_t missedDeadlines;
     uint8_t coreAffinity;
     uint8_t active;
+    uint8_t tmrMode;       // TmrMode
+    uint8_t overrunAction; // BudgetAction
+    uint8_t sporadic;      // Released by task_release; periodMs is the minimum inter-arrival time
+    uint8_t server;        // Reservation server its jobs run in, as server ID + 1; 0 = dispatched itself
+    void *output;        // Committed output; replicas write private copies that are voted into it
+    uint32_t outputSize;
+    int32_t stateArea; // Checkpoint area backing output when allocated by task_alloc_state
 } Task;
 
 // Function prototypes
 int task_create(Task *task, char *name, void (*entryPoint)(void *),
                 void *args, uint32_t periodMs, uint32_t deadlineMs,
                 CriticalityLevel criticality);
+int task_create_ex(Task *task, char *name, void (*entryPoint)(void *),
+                   void *args, uint32_t periodMs, uint32_t deadlineMs,
+                   uint32_t executionTimeMs, CriticalityLevel criticality);
 void task_delete(uint32_t taskId);
 Task *task_get_current(void);
 void task_yield(void);
@@ -36,5 +74,13 @@ void task_set_priority(uint32_t taskId, uint32_t priority);
 int task_ready(uint32_t taskId);
 int task_suspend(uint32_t taskId);
 int task_resume(uint32_t taskId);
+int task_set_tmr_mode(uint32_t taskId, TmrMode mode);
+int task_set_overrun_action(uint32_t taskId, BudgetAction action);
+int task_set_execution_time(uint32_t taskId, uint32_t executionTimeMs);
+int task_set_criticality_budgets(uint32_t taskId, const uint32_t budgetMs[4]);
+int task_set_sporadic(uint32_t taskId);
+int task_release(uint32_t taskId);
+int task_set_output(uint32_t taskId, void *output, uint32_t outputSize);
+void *task_alloc_state(uint32_t taskId, uint32_t size);
 
 #endif // TASK_MANAGER_H
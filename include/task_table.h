@@ -0,0 +1,44 @@
+#ifndef TASK_TABLE_H
+#define TASK_TABLE_H
+
+#include "task_manager.h"
+
+#define TASK_TABLE_ALIGNMENT 64
+#define TASK_TABLE_MAX_CHUNKS (TASK_TABLE_MAX_CAPACITY / TASK_TABLE_CHUNK_SIZE)
+
+// Hot scheduling fields kept as one cache-aligned array per field (structure
+// of arrays). Selection loops scan only the arrays they need; the full Task
+// descriptor is the cold view and is touched only for the chosen task.
+//
+// The arrays are sized at runtime. Growing builds a new table and publishes
+// it, so a reader holding the old table keeps scanning valid memory.
+typedef struct TaskHotTable
+{
+    uint8_t *active;    // Dispatchable: active, not shed and, unless ungated, with a release pending
+    uint8_t *allocated; // Slot holds a live task (suspended tasks are allocated but inactive)
+    uint8_t *criticality;
+    uint8_t *coreAffinity;
+    uint16_t *generation;
+    uint32_t *periodMs;
+    uint32_t *deadlineMs;
+    uint32_t *executionTimeMs;
+    uint32_t *basePriority;
+    uint32_t *dynamicPriority;
+    volatile int count; // Slots in use so far (scan bound), published after a slot is filled
+    int capacity;
+    Task *const *coldChunks; // Chunk directory of the cold descriptors
+    struct TaskHotTable *retired;
+    void *block;
+} TaskHotTable;
+
+// Function prototypes
+TaskHotTable *task_table_create(int capacity, Task *const *coldChunks);
+void task_table_destroy(TaskHotTable *hot);
+void task_table_copy(TaskHotTable *dst, const TaskHotTable *src);
+void task_table_store(TaskHotTable *hot, int slot, const Task *task);
+void task_table_load(const TaskHotTable *hot, int slot, Task *task);
+Task *task_table_cold(const TaskHotTable *hot, int slot);
+uint32_t task_table_handle(const TaskHotTable *hot, int slot);
+int task_table_argmin(const TaskHotTable *hot, const uint32_t *keys);
+
+#endif // TASK_TABLE_H
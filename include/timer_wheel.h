@@ -0,0 +1,33 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "system_config.h"
+#include <stdint.h>
+
+typedef void (*TimerCallback)(void *arg);
+
+// Intrusive timer node; owned by the caller, so arming never allocates
+typedef struct TimerWheelTimer
+{
+    struct TimerWheelTimer *next;
+    struct TimerWheelTimer *prev;
+    uint64_t expiresTick;
+    uint64_t periodTicks; // 0 for one-shot timers
+    TimerCallback callback;
+    void *arg;
+    volatile uint8_t state;
+} TimerWheelTimer;
+
+// Function prototypes
+void timer_wheel_init(void);
+void timer_wheel_start(void);
+void timer_wheel_stop(void);
+uint64_t timer_wheel_now_us(void);
+void timer_wheel_arm(TimerWheelTimer *timer, uint64_t delayUs, uint64_t periodUs,
+                     TimerCallback callback, void *arg);
+int timer_wheel_cancel(TimerWheelTimer *timer);
+int timer_wheel_is_armed(const TimerWheelTimer *timer);
+uint64_t timer_wheel_next_expiry_us(void);
+void timer_wheel_sleep_us(uint64_t delayUs);
+
+#endif // TIMER_WHEEL_H
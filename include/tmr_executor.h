@@ -0,0 +1,30 @@
+#ifndef TMR_EXECUTOR_H
+#define TMR_EXECUTOR_H
+
+#include "system_config.h"
+#include "task_manager.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define TMR_REPLICAS 3
+#define TMR_QUEUE_DEPTH 16 // Jobs per replica worker, including stragglers from early votes
+
+// Redundant execution accounting
+typedef struct
+{
+    uint64_t executions;
+    uint64_t earlyCommits; // Committed once two replicas agreed
+    uint64_t fullVotes;    // Committed by a three-way vote
+    uint64_t deadlineMisses;
+    uint64_t disagreements[TMR_REPLICAS]; // Times each replica worker was outvoted
+} TmrExecutorStats;
+
+// Function prototypes
+void tmr_executor_start(void);
+void tmr_executor_stop(void);
+int tmr_execute(const Task *task, uint64_t deadlineUs);
+void *tmr_replica_output(size_t *size);
+int tmr_replica_index(void);
+void tmr_executor_get_stats(TmrExecutorStats *stats);
+
+#endif // TMR_EXECUTOR_H
@@ -0,0 +1,31 @@
+#ifndef TMR_VOTE_H
+#define TMR_VOTE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define TMR_VOTE_CORRECT 0x1 // Overwrite minority copies with the majority
+#define TMR_MAX_REPORTED_MISMATCHES 16
+
+// One disagreeing 64-bit word
+typedef struct
+{
+    size_t offset;        // Byte offset of the word within the buffers
+    uint8_t minorityMask; // Bit i set if replica i differed from the majority
+} TmrMismatch;
+
+// Result of a bulk vote; locations holds the first mismatches in address order
+typedef struct
+{
+    size_t mismatchedWords;
+    uint64_t minorityBits[3]; // Bits outvoted in each replica
+    uint32_t locationCount;
+    TmrMismatch locations[TMR_MAX_REPORTED_MISMATCHES];
+} TmrVoteReport;
+
+// Function prototypes
+size_t tmr_vote_buffers(void *replica0, void *replica1, void *replica2, size_t size,
+                        void *out, int flags, TmrVoteReport *report);
+const char *tmr_vote_isa(void);
+
+#endif // TMR_VOTE_H
@@ -0,0 +1,116 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "system_config.h"
+#include <stdint.h>
+
+// Event categories; TRACE_COMPILE_CATEGORIES removes the others at build time
+#define TRACE_CAT_META 0x01 // Thread and task names, drop counts; always recorded
+#define TRACE_CAT_SCHED 0x02
+#define TRACE_CAT_TASK 0x04
+#define TRACE_CAT_FAULT 0x08
+#define TRACE_CAT_MEMORY 0x10
+#define TRACE_CAT_TMR 0x20
+#define TRACE_CAT_BUDGET 0x40
+#define TRACE_CAT_ALL 0x7F
+
+// X(event, category, phase, name, arg0..arg3). Phases follow the Chrome
+// trace format: 'B'/'E' begin and end a slice on the emitting thread, 'i'
+// is an instant, 'C' a counter and 'M' metadata; names travel 8 chars per
+// metadata event in args 2-3. An arg0 named "taskId" lets the decoder label
+// the event with the task's name.
+#define TRACE_EVENT_LIST(X)                                                                                          \
+    X(TRACE_THREAD_NAME, TRACE_CAT_META, 'M', "thread_name", "", "offset", "chars", "")                              \
+    X(TRACE_TASK_NAME, TRACE_CAT_META, 'M', "task_name", "taskId", "offset", "chars", "")                            \
+    X(TRACE_DROPPED, TRACE_CAT_META, 'i', "events dropped", "count", "", "", "")                                     \
+    X(TRACE_SCHED_DECISION, TRACE_CAT_SCHED, 'i', "decide", "taskId", "core", "sliceMs", "")                         \
+    X(TRACE_SCHED_TICK_NS, TRACE_CAT_SCHED, 'C', "tick ns", "ns", "", "", "")                                        \
+    X(TRACE_JOB_BEGIN, TRACE_CAT_SCHED, 'B', "job", "taskId", "", "", "")                                            \
+    X(TRACE_JOB_END, TRACE_CAT_SCHED, 'E', "job", "taskId", "cpuUs", "outcome", "")                                  \
+    X(TRACE_TASK_CREATE, TRACE_CAT_TASK, 'i', "create", "taskId", "periodMs", "deadlineMs", "dal")                   \
+    X(TRACE_TASK_DELETE, TRACE_CAT_TASK, 'i', "delete", "taskId", "", "", "")                                        \
+    X(TRACE_TASK_YIELD, TRACE_CAT_TASK, 'i', "yield", "taskId", "", "", "")                                          \
+    X(TRACE_TASK_DELAY, TRACE_CAT_TASK, 'i', "delay", "taskId", "ms", "", "")                                        \
+    X(TRACE_TASK_PRIORITY, TRACE_CAT_TASK, 'i', "priority", "taskId", "priority", "", "")                            \
+    X(TRACE_TASK_SUSPEND, TRACE_CAT_TASK, 'i', "suspend", "taskId", "", "", "")                                      \
+    X(TRACE_TASK_RESUME, TRACE_CAT_TASK, 'i', "resume", "taskId", "", "", "")                                        \
+    X(TRACE_TASK_ROLLBACK, TRACE_CAT_TASK, 'i', "state rollback", "taskId", "", "", "")                              \
+    X(TRACE_FAULT_INJECTED, TRACE_CAT_FAULT, 'i', "fault injected", "taskId", "type", "", "")                        \
+    X(TRACE_FAULT_DETECTED, TRACE_CAT_FAULT, 'i', "fault detected", "taskId", "type", "address", "source")           \
+    X(TRACE_FAULT_RECOVERY_BEGIN, TRACE_CAT_FAULT, 'B', "recovery", "taskId", "type", "", "")                        \
+    X(TRACE_FAULT_RECOVERY_END, TRACE_CAT_FAULT, 'E', "recovery", "taskId", "type", "", "")                          \
+    X(TRACE_FAULT_DROPPED, TRACE_CAT_FAULT, 'i', "fault dropped", "taskId", "type", "dal", "")                       \
+    X(TRACE_MM_ROLLBACK, TRACE_CAT_MEMORY, 'i', "region rollback", "region", "pages", "", "")                        \
+    X(TRACE_MM_TMR_CORRECTED, TRACE_CAT_MEMORY, 'i', "region corrected", "region", "words", "offset", "replicaMask") \
+    X(TRACE_SCRUB_MISMATCH, TRACE_CAT_MEMORY, 'i', "scrub mismatch", "taskId", "address", "offset", "")              \
+    X(TRACE_TMR_OUTVOTED, TRACE_CAT_TMR, 'i', "replica outvoted", "taskId", "replica", "offset", "")                 \
+    X(TRACE_TMR_DEADLINE_MISS, TRACE_CAT_TMR, 'i', "replica deadline miss", "taskId", "", "", "")                    \
+    X(TRACE_BUDGET_OVERRUN, TRACE_CAT_BUDGET, 'i', "budget overrun", "taskId", "usedUs", "budgetUs", "action")       \
+    X(TRACE_BUDGET_DETACHED, TRACE_CAT_BUDGET, 'i', "worker detached", "taskId", "", "", "")                         \
+    X(TRACE_MC_MODE, TRACE_CAT_SCHED, 'i', "criticality mode", "taskId", "mode", "usedUs", "budgetUs")
+
+#define TRACE_ENUM_ID(event, category, phase, name, a0, a1, a2, a3) event,
+#define TRACE_ENUM_CATEGORY(event, category, phase, name, a0, a1, a2, a3) event##_CATEGORY = category,
+
+typedef enum
+{
+    TRACE_EVENT_LIST(TRACE_ENUM_ID)
+    TRACE_EVENT_COUNT
+} TraceEventId;
+
+enum
+{
+    TRACE_EVENT_LIST(TRACE_ENUM_CATEGORY)
+};
+
+// Sources of a TRACE_FAULT_DETECTED event
+#define TRACE_SOURCE_WATCHDOG 0
+#define TRACE_SOURCE_INJECTED 1
+#define TRACE_SOURCE_REPORTED 2
+
+// One fixed-size binary event; the trace file is a TraceFileHeader followed by these
+typedef struct
+{
+    uint64_t tsc;
+    uint32_t threadId;
+    uint16_t event; // TraceEventId
+    uint16_t reserved;
+    uint32_t args[4];
+} TraceEvent;
+
+#define TRACE_FILE_MAGIC "RTOSTRC1"
+#define TRACE_FILE_VERSION 1
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t eventSize; // sizeof(TraceEvent)
+    double tscPerUs;
+    uint64_t startTsc;
+} TraceFileHeader;
+
+// Runtime category filter; events need their bit here and in TRACE_COMPILE_CATEGORIES
+extern volatile uint32_t g_traceCategories;
+
+// Record an event with up to four integer arguments. The category test is a
+// constant for compiled-out categories, so those calls generate no code.
+#define TRACE(event, a0, a1, a2, a3)                                                                 \
+    do                                                                                               \
+    {                                                                                                \
+        if ((TRACE_COMPILE_CATEGORIES & event##_CATEGORY) && (g_traceCategories & event##_CATEGORY)) \
+        {                                                                                            \
+            trace_emit(event, (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2), (uint32_t)(a3));       \
+        }                                                                                            \
+    } while (0)
+
+// Function prototypes
+int trace_start(const char *path, uint32_t categories);
+void trace_stop(void);
+void trace_emit(TraceEventId event, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+void trace_thread_name(const char *name);
+void trace_task_name(uint32_t taskId, const char *name);
+void trace_set_categories(uint32_t categories);
+int trace_parse_categories(const char *list, uint32_t *categories);
+
+#endif // TRACE_H
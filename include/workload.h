@@ -0,0 +1,69 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "system_config.h"
+#include <stdint.h>
+
+#define WORKLOAD_MAX_TASKS 65536
+
+// Parameters of a synthetic task set
+typedef struct
+{
+    uint32_t taskCount;
+    float utilization;         // Total, split across the tasks
+    float dirichletAlpha;      // 0 splits with UUniFast, else Dirichlet(alpha, ..., alpha)
+    uint32_t periodMinMs;      // Periods are log-uniform in [min, max]
+    uint32_t periodMaxMs;
+    float deadlineMinRatio;    // Deadlines uniform in [C + ratio * (T - C), T]; 1 = implicit
+    uint32_t criticalityMix[4]; // Relative weights of DAL_A..DAL_D
+    uint32_t sporadicPercent;  // Tasks released by arrivals instead of a timer
+    uint32_t durationMs;       // Arrival horizon for the sporadic tasks
+    uint32_t seed;
+} WorkloadConfig;
+
+typedef struct
+{
+    char name[32];
+    uint32_t periodMs; // Minimum inter-arrival time for sporadic tasks
+    uint32_t deadlineMs;
+    uint32_t wcetUs;
+    CriticalityLevel criticality;
+    uint8_t sporadic;
+    uint32_t taskId; // Set by workload_apply
+} WorkloadTask;
+
+// One job arrival of a sporadic task
+typedef struct
+{
+    uint32_t offsetMs;
+    uint32_t task; // Index into the set's tasks
+} WorkloadJob;
+
+typedef struct
+{
+    WorkloadTask *tasks;
+    uint32_t taskCount;
+    WorkloadJob *jobs; // Sorted by offset
+    uint32_t jobCount;
+    uint32_t durationMs;
+} WorkloadSet;
+
+typedef struct
+{
+    uint32_t released;
+    uint32_t skipped; // Arrivals for tasks that were deleted or never created
+    uint64_t maxLagUs; // Worst lateness of a release against its trace offset
+} WorkloadReplayStats;
+
+// Function prototypes
+void workload_defaults(WorkloadConfig *config);
+int workload_generate(const WorkloadConfig *config, WorkloadSet *set);
+int workload_load(const char *path, WorkloadSet *set);
+int workload_save(const char *path, const WorkloadSet *set);
+void workload_free(WorkloadSet *set);
+float workload_utilization(const WorkloadSet *set);
+int workload_apply(WorkloadSet *set);
+int workload_replay_start(const WorkloadSet *set);
+void workload_replay_stop(WorkloadReplayStats *stats);
+
+#endif // WORKLOAD_H
@@ -0,0 +1,390 @@
+#include "../../include/checkpoint.h"
+#include "../../include/timer_wheel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#ifndef MEM_WRITE_WATCH
+#define MEM_WRITE_WATCH 0x00200000
+#endif
+#ifndef WRITE_WATCH_FLAG_RESET
+#define WRITE_WATCH_FLAG_RESET 0x01
+#endif
+
+// One checkpointed area. The live memory is allocated with MEM_WRITE_WATCH
+// so the kernel tracks written pages for us; the image holds the state as
+// of the last checkpoint and only ever receives pages that changed.
+typedef struct
+{
+    uint8_t *memory;
+    uint8_t *image;
+    size_t size; // Rounded up to whole pages
+    size_t pageCount;
+    PVOID *dirtyPages; // GetWriteWatch output, one entry per page
+    int watched;       // 0 if write watch is unavailable; every page then counts as dirty
+    int inUse;
+    int retired;         // Destroyed while pinned; freed when the last pin goes
+    LONG pins;           // Jobs that may still touch the memory (checkpoint_pin)
+    uint32_t generation; // Bumped on every create, so stale area IDs stop resolving
+    volatile LONG rollbackPending;
+    char name[32];
+    CheckpointStats stats;
+} CheckpointArea;
+
+// An area ID holds index + 1 in its low CHECKPOINT_INDEX_BITS and the
+// slot's generation above them
+#define CHECKPOINT_INDEX_BITS 8
+#define CHECKPOINT_INDEX_MASK ((1 << CHECKPOINT_INDEX_BITS) - 1)
+#define CHECKPOINT_GENERATION_MASK (0x7FFFFFFFu >> CHECKPOINT_INDEX_BITS)
+
+static CheckpointArea g_areas[CHECKPOINT_MAX_AREAS];
+static CRITICAL_SECTION g_checkpointLock; // Guards area creation, destruction and pins
+static DWORD g_pageSize = 0;
+static int g_initialized = 0;
+
+// Slot of an allocated area, retired or not, whose generation matches the ID
+static CheckpointArea *checkpoint_slot(int areaId)
+{
+    int index = (areaId & CHECKPOINT_INDEX_MASK) - 1;
+    if (areaId <= CHECKPOINT_NO_AREA || index < 0 || index >= CHECKPOINT_MAX_AREAS || !g_areas[index].inUse ||
+        g_areas[index].generation != ((uint32_t)areaId >> CHECKPOINT_INDEX_BITS))
+    {
+        return NULL;
+    }
+    return &g_areas[index];
+}
+
+// Live area; a destroyed one stops resolving even while pins keep its memory
+static CheckpointArea *checkpoint_area(int areaId)
+{
+    CheckpointArea *area = checkpoint_slot(areaId);
+    return area && !area->retired ? area : NULL;
+}
+
+static void checkpoint_free(CheckpointArea *area)
+{
+    area->inUse = 0;
+    area->retired = 0;
+    VirtualFree(area->memory, 0, MEM_RELEASE);
+    VirtualFree(area->image, 0, MEM_RELEASE);
+    free(area->dirtyPages);
+    area->memory = NULL;
+    area->image = NULL;
+    area->dirtyPages = NULL;
+}
+
+// Pages written since the write-watch state was last reset
+static size_t checkpoint_collect_dirty(CheckpointArea *area, DWORD flags)
+{
+    ULONG_PTR count = area->pageCount;
+    ULONG granularity = 0;
+
+    if (area->watched &&
+        GetWriteWatch(flags, area->memory, area->size, area->dirtyPages, &count, &granularity) == 0)
+    {
+        return (size_t)count;
+    }
+
+    // No tracking: treat the whole area as written
+    for (size_t i = 0; i < area->pageCount; i++)
+    {
+        area->dirtyPages[i] = area->memory + i * g_pageSize;
+    }
+    return area->pageCount;
+}
+
+void checkpoint_init(void)
+{
+    if (g_initialized)
+    {
+        return;
+    }
+
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    g_pageSize = systemInfo.dwPageSize;
+
+    InitializeCriticalSection(&g_checkpointLock);
+    memset(g_areas, 0, sizeof(g_areas));
+    g_initialized = 1;
+
+    printf("Checkpoint store initialized: %u byte pages, up to %d areas\n", (unsigned)g_pageSize,
+           CHECKPOINT_MAX_AREAS);
+}
+
+// Allocate a zeroed, write-tracked area and its checkpoint image.
+// Returns the area ID and the live memory through memory, or -1.
+int checkpoint_create(size_t size, const char *name, void **memory)
+{
+    if (!g_initialized || size == 0 || !memory)
+    {
+        return -1;
+    }
+
+    size_t rounded = (size + g_pageSize - 1) / g_pageSize * g_pageSize;
+    EnterCriticalSection(&g_checkpointLock);
+
+    int index = 0;
+    while (index < CHECKPOINT_MAX_AREAS && g_areas[index].inUse)
+    {
+        index++;
+    }
+    if (index == CHECKPOINT_MAX_AREAS)
+    {
+        LeaveCriticalSection(&g_checkpointLock);
+        printf("Error: No free checkpoint area for '%s'\n", name ? name : "unnamed");
+        return -1;
+    }
+
+    CheckpointArea *area = &g_areas[index];
+    uint32_t generation = (area->generation + 1) & CHECKPOINT_GENERATION_MASK;
+    memset(area, 0, sizeof(CheckpointArea));
+    area->generation = generation;
+    area->watched = 1;
+    area->memory = (uint8_t *)VirtualAlloc(NULL, rounded, MEM_RESERVE | MEM_COMMIT | MEM_WRITE_WATCH, PAGE_READWRITE);
+    if (!area->memory)
+    {
+        area->watched = 0;
+        area->memory = (uint8_t *)VirtualAlloc(NULL, rounded, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    }
+    area->image = (uint8_t *)VirtualAlloc(NULL, rounded, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    area->pageCount = rounded / g_pageSize;
+    area->dirtyPages = (PVOID *)malloc(area->pageCount * sizeof(PVOID));
+
+    if (!area->memory || !area->image || !area->dirtyPages)
+    {
+        if (area->memory)
+        {
+            VirtualFree(area->memory, 0, MEM_RELEASE);
+        }
+        if (area->image)
+        {
+            VirtualFree(area->image, 0, MEM_RELEASE);
+        }
+        free(area->dirtyPages);
+        LeaveCriticalSection(&g_checkpointLock);
+        printf("Error: Failed to allocate checkpoint area '%s'\n", name ? name : "unnamed");
+        return -1;
+    }
+
+    // Both copies start zeroed, so the empty state is already checkpointed
+    area->size = rounded;
+    strncpy(area->name, name ? name : "unnamed", sizeof(area->name) - 1);
+    if (area->watched)
+    {
+        ResetWriteWatch(area->memory, area->size);
+    }
+    area->stats.lastCheckpointUs = timer_wheel_now_us();
+    area->inUse = 1;
+    LeaveCriticalSection(&g_checkpointLock);
+
+    *memory = area->memory;
+    return (int)((generation << CHECKPOINT_INDEX_BITS) | (uint32_t)(index + 1));
+}
+
+// The ID stops resolving at once; the memory goes when the last job
+// pinning it is over, so a job still running for a deleted task keeps
+// writing valid memory
+void checkpoint_destroy(int areaId)
+{
+    EnterCriticalSection(&g_checkpointLock);
+    CheckpointArea *area = checkpoint_area(areaId);
+    if (area)
+    {
+        area->retired = 1;
+        if (area->pins == 0)
+        {
+            checkpoint_free(area);
+        }
+    }
+    LeaveCriticalSection(&g_checkpointLock);
+}
+
+// Keep the area's memory allocated until checkpoint_unpin, even if it is
+// destroyed meanwhile. Jobs pin their task's state for as long as they may
+// write it. Fails once the area is freed; CHECKPOINT_NO_AREA always pins.
+int checkpoint_pin(int areaId)
+{
+    if (areaId == CHECKPOINT_NO_AREA)
+    {
+        return 0;
+    }
+
+    EnterCriticalSection(&g_checkpointLock);
+    CheckpointArea *area = checkpoint_slot(areaId);
+    if (area)
+    {
+        area->pins++;
+    }
+    LeaveCriticalSection(&g_checkpointLock);
+    return area ? 0 : -1;
+}
+
+void checkpoint_unpin(int areaId)
+{
+    if (areaId == CHECKPOINT_NO_AREA)
+    {
+        return;
+    }
+
+    EnterCriticalSection(&g_checkpointLock);
+    CheckpointArea *area = checkpoint_slot(areaId);
+    if (area && area->pins > 0 && --area->pins == 0 && area->retired)
+    {
+        checkpoint_free(area);
+    }
+    LeaveCriticalSection(&g_checkpointLock);
+}
+
+// Copy the pages written since the last checkpoint into the image.
+// Checkpoints and rollbacks of one area must not overlap each other or
+// writers; memory-matrix regions hold the region lock, task state is only
+// touched from the scheduler thread. If verify is given, every written
+// page must pass it first, or nothing is copied and the pages stay
+// pending. Returns the number of pages copied, -2 if a page was rejected.
+int checkpoint_take(int areaId, CheckpointPageFn verify, void *arg)
+{
+    CheckpointArea *area = checkpoint_area(areaId);
+    if (!area)
+    {
+        return -1;
+    }
+
+    // Pages stay marked written until they pass; without a verifier the
+    // marks are reset as they are read, so concurrent writes are not lost
+    size_t count = checkpoint_collect_dirty(area, verify ? 0 : WRITE_WATCH_FLAG_RESET);
+    for (size_t i = 0; verify && i < count; i++)
+    {
+        size_t offset = (size_t)((uint8_t *)area->dirtyPages[i] - area->memory);
+        if (verify(arg, offset, g_pageSize) != 0)
+        {
+            area->stats.rejected++;
+            return -2;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t offset = (size_t)((uint8_t *)area->dirtyPages[i] - area->memory);
+        memcpy(area->image + offset, area->memory + offset, g_pageSize);
+    }
+    if (verify && area->watched)
+    {
+        ResetWriteWatch(area->memory, area->size);
+    }
+
+    area->stats.checkpoints++;
+    area->stats.pagesCopied += count;
+    area->stats.lastCheckpointUs = timer_wheel_now_us();
+    return (int)count;
+}
+
+int checkpoint_take_if_due(int areaId, uint32_t periodMs)
+{
+    CheckpointArea *area = checkpoint_area(areaId);
+    if (!area)
+    {
+        return -1;
+    }
+    if (timer_wheel_now_us() - area->stats.lastCheckpointUs < (uint64_t)periodMs * 1000)
+    {
+        return 0;
+    }
+    return checkpoint_take(areaId, NULL, NULL);
+}
+
+// Restore the area to its last checkpoint. Only pages written since then
+// are copied back, each then passed to restored if given, so copies of the
+// area can follow page by page. Returns the number of pages restored.
+int checkpoint_rollback(int areaId, CheckpointPageFn restored, void *arg)
+{
+    CheckpointArea *area = checkpoint_area(areaId);
+    if (!area)
+    {
+        return -1;
+    }
+
+    size_t count = checkpoint_collect_dirty(area, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t offset = (size_t)((uint8_t *)area->dirtyPages[i] - area->memory);
+        memcpy(area->memory + offset, area->image + offset, g_pageSize);
+        if (restored)
+        {
+            restored(arg, offset, g_pageSize);
+        }
+    }
+
+    // The restore itself wrote those pages; the area now matches the image again
+    if (area->watched)
+    {
+        ResetWriteWatch(area->memory, area->size);
+    }
+
+    area->rollbackPending = 0;
+    area->stats.rollbacks++;
+    area->stats.pagesRestored += count;
+    return (int)count;
+}
+
+// Ask the area's owner to roll back at its next safe point (checkpoint_apply_pending)
+int checkpoint_request_rollback(int areaId)
+{
+    CheckpointArea *area = checkpoint_area(areaId);
+    if (!area)
+    {
+        return -1;
+    }
+
+    InterlockedExchange(&area->rollbackPending, 1);
+    return 0;
+}
+
+// Perform a requested rollback. Returns pages restored, 0 if none was pending.
+int checkpoint_apply_pending(int areaId)
+{
+    CheckpointArea *area = checkpoint_area(areaId);
+    if (!area || !InterlockedExchange(&area->rollbackPending, 0))
+    {
+        return 0;
+    }
+    return checkpoint_rollback(areaId, NULL, NULL);
+}
+
+int checkpoint_get_stats(int areaId, CheckpointStats *stats)
+{
+    CheckpointArea *area = checkpoint_area(areaId);
+    if (!area || !stats)
+    {
+        return -1;
+    }
+
+    *stats = area->stats;
+    return 0;
+}
+
+void checkpoint_get_totals(CheckpointStats *stats)
+{
+    memset(stats, 0, sizeof(CheckpointStats));
+
+    EnterCriticalSection(&g_checkpointLock);
+    for (int i = 0; i < CHECKPOINT_MAX_AREAS; i++)
+    {
+        if (!g_areas[i].inUse || g_areas[i].retired)
+        {
+            continue;
+        }
+        stats->checkpoints += g_areas[i].stats.checkpoints;
+        stats->pagesCopied += g_areas[i].stats.pagesCopied;
+        stats->rollbacks += g_areas[i].stats.rollbacks;
+        stats->pagesRestored += g_areas[i].stats.pagesRestored;
+        stats->rejected += g_areas[i].stats.rejected;
+        if (g_areas[i].stats.lastCheckpointUs > stats->lastCheckpointUs)
+        {
+            stats->lastCheckpointUs = g_areas[i].stats.lastCheckpointUs;
+        }
+    }
+    LeaveCriticalSection(&g_checkpointLock);
+}
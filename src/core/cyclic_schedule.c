@@ -0,0 +1,448 @@
+#include "../../include/cyclic_schedule.h"
+#include "../../include/task_table.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+// External functions
+extern int kernel_read_task_slot(int slot, Task *snapshot);
+extern int kernel_get_task_slot_count(void);
+extern LONG kernel_get_task_set_version(void);
+
+// A table resolved against the live task set. Only the scheduler thread
+// touches the active one.
+typedef struct
+{
+    uint32_t quantumUs;
+    uint32_t length;
+    uint32_t taskCount;
+    uint16_t *entries;
+    uint32_t *taskIds; // Live task for each table task
+    LONG version;      // Task-set version the table was resolved against
+    uint8_t started;
+    uint64_t startUs;   // Start of frame 0
+    uint64_t nextFrame; // First frame not dispatched yet
+} CyclicRuntime;
+
+static CyclicRuntime *g_runtime = NULL;                   // Scheduler thread only
+static CyclicRuntime *volatile g_pendingRuntime = NULL;   // Adopted at the next dispatch
+static CyclicRuntime g_disableRequest;                    // Pending value that turns the table off
+static CyclicStats g_stats;
+
+static uint64_t gcd_u64(uint64_t a, uint64_t b)
+{
+    while (b)
+    {
+        uint64_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+static void cyclic_free_runtime(CyclicRuntime *runtime)
+{
+    if (runtime && runtime != &g_disableRequest)
+    {
+        free(runtime->entries);
+        free(runtime->taskIds);
+        free(runtime);
+    }
+}
+
+// Build the table for a synchronous periodic task set by simulating
+// non-preemptive EDF over one hyperperiod at the given quantum, with costs
+// rounded up to whole quanta as admission control does. Deadlines must not
+// exceed periods. Returns 0, or -1 if the hyperperiod is too long or a job
+// would miss its deadline; the table is then empty.
+int cyclic_build_table(const CyclicTableTask *tasks, uint32_t taskCount, uint32_t quantumUs, CyclicTable *table)
+{
+    memset(table, 0, sizeof(CyclicTable));
+    if (taskCount == 0 || taskCount >= CYCLIC_IDLE || quantumUs == 0)
+    {
+        printf("Error: A cyclic table needs 1 to %u tasks\n", CYCLIC_IDLE - 1);
+        return -1;
+    }
+
+    uint64_t hyperperiodUs = quantumUs;
+    for (uint32_t i = 0; i < taskCount; i++)
+    {
+        if (tasks[i].periodMs == 0 || tasks[i].deadlineMs > tasks[i].periodMs)
+        {
+            printf("Error: Task '%s' needs a period no shorter than its deadline for a cyclic table\n",
+                   tasks[i].name);
+            return -1;
+        }
+
+        uint64_t periodUs = (uint64_t)tasks[i].periodMs * 1000;
+        hyperperiodUs = hyperperiodUs / gcd_u64(hyperperiodUs, periodUs) * periodUs;
+        if (hyperperiodUs / quantumUs > CYCLIC_MAX_TABLE_ENTRIES)
+        {
+            printf("Error: Hyperperiod exceeds %u quanta of %u us\n", CYCLIC_MAX_TABLE_ENTRIES, quantumUs);
+            return -1;
+        }
+    }
+
+    uint32_t length = (uint32_t)(hyperperiodUs / quantumUs);
+    uint16_t *entries = (uint16_t *)malloc(length * sizeof(uint16_t));
+    CyclicTableTask *tableTasks = (CyclicTableTask *)malloc(taskCount * sizeof(CyclicTableTask));
+    uint64_t *nextReleaseUs = (uint64_t *)calloc(taskCount, sizeof(uint64_t));
+    uint64_t *jobDeadlineUs = (uint64_t *)calloc(taskCount, sizeof(uint64_t));
+    uint8_t *pending = (uint8_t *)calloc(taskCount, sizeof(uint8_t));
+    int result = entries && tableTasks && nextReleaseUs && jobDeadlineUs && pending ? 0 : -1;
+
+    for (uint32_t t = 0; result == 0 && t < length;)
+    {
+        uint64_t nowUs = (uint64_t)t * quantumUs;
+        int best = -1;
+
+        entries[t] = CYCLIC_IDLE;
+        for (uint32_t i = 0; i < taskCount; i++)
+        {
+            if (!pending[i] && nextReleaseUs[i] <= nowUs)
+            {
+                pending[i] = 1;
+                jobDeadlineUs[i] = nextReleaseUs[i] + (uint64_t)tasks[i].deadlineMs * 1000;
+                nextReleaseUs[i] += (uint64_t)tasks[i].periodMs * 1000;
+            }
+            if (pending[i] && (best < 0 || jobDeadlineUs[i] < jobDeadlineUs[best]))
+            {
+                best = (int)i;
+            }
+        }
+        if (best < 0)
+        {
+            t++;
+            continue;
+        }
+
+        uint32_t costQuanta = (uint32_t)(((uint64_t)tasks[best].executionTimeMs * 1000 + quantumUs - 1) / quantumUs);
+        costQuanta = costQuanta ? costQuanta : 1;
+        if ((uint64_t)(t + costQuanta) * quantumUs > jobDeadlineUs[best])
+        {
+            printf("Error: No cyclic schedule: task '%s' misses its deadline at %llu ms\n", tasks[best].name,
+                   (unsigned long long)(jobDeadlineUs[best] / 1000));
+            result = -1;
+            break;
+        }
+
+        entries[t] = (uint16_t)best;
+        pending[best] = 0;
+        for (uint32_t busy = 1; busy < costQuanta && t + busy < length; busy++)
+        {
+            entries[t + busy] = CYCLIC_IDLE;
+        }
+        t += costQuanta;
+    }
+
+    // Every job released in the hyperperiod must have been placed
+    for (uint32_t i = 0; result == 0 && i < taskCount; i++)
+    {
+        if (pending[i] || nextReleaseUs[i] < hyperperiodUs)
+        {
+            printf("Error: No cyclic schedule: task '%s' does not fit the hyperperiod\n", tasks[i].name);
+            result = -1;
+        }
+    }
+
+    free(nextReleaseUs);
+    free(jobDeadlineUs);
+    free(pending);
+    if (result != 0)
+    {
+        free(entries);
+        free(tableTasks);
+        return -1;
+    }
+
+    memcpy(tableTasks, tasks, taskCount * sizeof(CyclicTableTask));
+    table->quantumUs = quantumUs;
+    table->length = length;
+    table->taskCount = taskCount;
+    table->tasks = tableTasks;
+    table->entries = entries;
+    return 0;
+}
+
+// Table for the periodic tasks now in the kernel, at the dispatch quantum.
+// Tasks attached to a reservation server run inside it and are left out.
+int cyclic_build_live_table(CyclicTable *table)
+{
+    int slotCount = kernel_get_task_slot_count();
+    CyclicTableTask *tasks = (CyclicTableTask *)malloc((size_t)(slotCount ? slotCount : 1) * sizeof(CyclicTableTask));
+    uint32_t taskCount = 0;
+
+    if (!tasks)
+    {
+        return -1;
+    }
+    for (int i = 0; i < slotCount; i++)
+    {
+        Task snapshot;
+        if (kernel_read_task_slot(i, &snapshot) == 0 && snapshot.periodMs > 0 && !snapshot.server)
+        {
+            CyclicTableTask *task = &tasks[taskCount++];
+            memcpy(task->name, snapshot.name, sizeof(task->name));
+            task->periodMs = snapshot.periodMs;
+            task->deadlineMs = snapshot.deadlineMs;
+            task->executionTimeMs = snapshot.executionTimeMs;
+        }
+    }
+
+    int result = cyclic_build_table(tasks, taskCount, SCHEDULER_PERIOD_MS * 1000, table);
+    free(tasks);
+    return result;
+}
+
+// Frees a table from cyclic_build_table; emitted tables are static
+void cyclic_free_table(CyclicTable *table)
+{
+    free((void *)table->tasks);
+    free((void *)table->entries);
+    memset(table, 0, sizeof(CyclicTable));
+}
+
+// Write the table as C source defining a CyclicTable named symbol
+int cyclic_emit_source(const CyclicTable *table, const char *path, const char *symbol)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        printf("Error: Cannot write cyclic table %s\n", path);
+        return -1;
+    }
+
+    fprintf(file, "// Cyclic-executive dispatch table; generated, do not edit.\n");
+    fprintf(file, "// %u entries of %u us: a %llu ms hyperperiod\n\n", table->length, table->quantumUs,
+            (unsigned long long)table->length * table->quantumUs / 1000);
+    fprintf(file, "#include \"cyclic_schedule.h\"\n\n");
+
+    fprintf(file, "static const CyclicTableTask %sTasks[] = {\n", symbol);
+    for (uint32_t i = 0; i < table->taskCount; i++)
+    {
+        const CyclicTableTask *task = &table->tasks[i];
+        fprintf(file, "    {\"");
+        for (const char *c = task->name; *c; c++)
+        {
+            fprintf(file, *c == '"' || *c == '\\' ? "\\%c" : "%c", *c);
+        }
+        fprintf(file, "\", %u, %u, %u},\n", task->periodMs, task->deadlineMs, task->executionTimeMs);
+    }
+    fprintf(file, "};\n\n");
+
+    fprintf(file, "static const uint16_t %sEntries[] = {", symbol);
+    for (uint32_t i = 0; i < table->length; i++)
+    {
+        fprintf(file, i % 16 == 0 ? "\n    " : " ");
+        if (table->entries[i] == CYCLIC_IDLE)
+        {
+            fprintf(file, "CYCLIC_IDLE,");
+        }
+        else
+        {
+            fprintf(file, "%u,", table->entries[i]);
+        }
+    }
+    fprintf(file, "\n};\n\n");
+
+    fprintf(file, "const CyclicTable %s = {%u, %u, %u, %sTasks, %sEntries};\n", symbol, table->quantumUs,
+            table->length, table->taskCount, symbol, symbol);
+
+    int result = ferror(file) ? -1 : 0;
+    fclose(file);
+    if (result != 0)
+    {
+        printf("Error: Failed writing cyclic table %s\n", path);
+    }
+    return result;
+}
+
+// Dispatch from a table instead of the scheduling policy. Each table task
+// must match one live task by name, period, deadline and execution time,
+// and every live periodic task must be in the table. The table is copied.
+// Returns 0, or -1 if it does not fit the task set.
+int cyclic_enable(const CyclicTable *table)
+{
+    LONG version = kernel_get_task_set_version(); // Read first: later changes must invalidate
+    int slotCount = kernel_get_task_slot_count();
+    CyclicRuntime *runtime = (CyclicRuntime *)calloc(1, sizeof(CyclicRuntime));
+    uint8_t *matched = (uint8_t *)calloc((size_t)(slotCount ? slotCount : 1), sizeof(uint8_t));
+    int result = -1;
+
+    if (!runtime || !matched)
+    {
+        goto done;
+    }
+    runtime->entries = (uint16_t *)malloc(table->length * sizeof(uint16_t));
+    runtime->taskIds = (uint32_t *)malloc((table->taskCount ? table->taskCount : 1) * sizeof(uint32_t));
+    if (!runtime->entries || !runtime->taskIds)
+    {
+        goto done;
+    }
+
+    for (uint32_t i = 0; i < table->taskCount; i++)
+    {
+        const CyclicTableTask *task = &table->tasks[i];
+        int found = -1;
+        Task snapshot;
+
+        for (int slot = 0; slot < slotCount && found < 0; slot++)
+        {
+            if (!matched[slot] && kernel_read_task_slot(slot, &snapshot) == 0 &&
+                strncmp(snapshot.name, task->name, sizeof(snapshot.name)) == 0 && !snapshot.server)
+            {
+                found = slot;
+            }
+        }
+        if (found < 0 || snapshot.periodMs != task->periodMs || snapshot.deadlineMs != task->deadlineMs ||
+            snapshot.executionTimeMs != task->executionTimeMs)
+        {
+            printf("Error: Cyclic table task '%s' does not match the task set\n", task->name);
+            goto done;
+        }
+        matched[found] = 1;
+        runtime->taskIds[i] = snapshot.id;
+    }
+
+    for (int slot = 0; slot < slotCount; slot++)
+    {
+        Task snapshot;
+        if (!matched[slot] && kernel_read_task_slot(slot, &snapshot) == 0 && snapshot.periodMs > 0 &&
+            !snapshot.server)
+        {
+            printf("Error: Task '%s' is missing from the cyclic table\n", snapshot.name);
+            goto done;
+        }
+    }
+
+    memcpy(runtime->entries, table->entries, table->length * sizeof(uint16_t));
+    runtime->quantumUs = table->quantumUs;
+    runtime->length = table->length;
+    runtime->taskCount = table->taskCount;
+    runtime->version = version;
+
+    cyclic_free_runtime((CyclicRuntime *)InterlockedExchangePointer((PVOID volatile *)&g_pendingRuntime, runtime));
+    printf("Cyclic executive: %u tasks in a %u-entry table, %llu ms hyperperiod\n", table->taskCount, table->length,
+           (unsigned long long)table->length * table->quantumUs / 1000);
+    runtime = NULL;
+    result = 0;
+
+done:
+    free(matched);
+    cyclic_free_runtime(runtime);
+    return result;
+}
+
+// Back to the scheduling policy from the next decision
+void cyclic_disable(void)
+{
+    cyclic_free_runtime(
+        (CyclicRuntime *)InterlockedExchangePointer((PVOID volatile *)&g_pendingRuntime, &g_disableRequest));
+}
+
+// Scheduler thread: O(1) table lookup for the frame the time falls in.
+// Returns 1 with the decision (possibly no task) while a table is active,
+// or 0 if the policy has to decide.
+int cyclic_dispatch(const TaskHotTable *hot, uint64_t nowUs, ScheduleDecision *decision)
+{
+    if (g_pendingRuntime)
+    {
+        CyclicRuntime *next = (CyclicRuntime *)InterlockedExchangePointer((PVOID volatile *)&g_pendingRuntime, NULL);
+        if (next)
+        {
+            cyclic_free_runtime(g_runtime);
+            g_runtime = next == &g_disableRequest ? NULL : next;
+            g_stats.enabled = g_runtime != NULL;
+            g_stats.length = g_runtime ? g_runtime->length : 0;
+            g_stats.quantumUs = g_runtime ? g_runtime->quantumUs : 0;
+            g_stats.taskCount = g_runtime ? g_runtime->taskCount : 0;
+        }
+    }
+
+    CyclicRuntime *runtime = g_runtime;
+    if (!runtime)
+    {
+        return 0;
+    }
+    if (kernel_get_task_set_version() != runtime->version)
+    {
+        printf("Cyclic executive: Task set changed, falling back to %s\n", scheduler_get_policy());
+        cyclic_free_runtime(runtime);
+        g_runtime = NULL;
+        g_stats.enabled = 0;
+        g_stats.fallbacks++;
+        return 0;
+    }
+
+    // Frame 0 starts half a quantum back, so ticks land mid-frame and
+    // tolerate jitter either way
+    if (!runtime->started)
+    {
+        runtime->started = 1;
+        runtime->startUs = nowUs - runtime->quantumUs / 2;
+    }
+
+    memset(decision, 0, sizeof(ScheduleDecision));
+    decision->taskId = TASK_INVALID_ID;
+
+    uint64_t frame = (nowUs - runtime->startUs) / runtime->quantumUs;
+    if (frame < runtime->nextFrame)
+    {
+        return 1; // This frame was dispatched already
+    }
+    for (uint64_t f = runtime->nextFrame; f < frame && f < runtime->nextFrame + runtime->length; f++)
+    {
+        if (runtime->entries[f % runtime->length] != CYCLIC_IDLE)
+        {
+            g_stats.skippedFrames++;
+        }
+    }
+    runtime->nextFrame = frame + 1;
+
+    uint16_t entry = runtime->entries[frame % runtime->length];
+    uint32_t taskId = entry != CYCLIC_IDLE ? runtime->taskIds[entry] : TASK_INVALID_ID;
+    int slot = (int)TASK_HANDLE_SLOT(taskId);
+    if (entry == CYCLIC_IDLE || slot >= hot->count || !hot->allocated[slot] || !hot->active[slot] ||
+        hot->generation[slot] != TASK_HANDLE_GENERATION(taskId))
+    {
+        g_stats.idleFrames++; // Free frame, or its task is suspended, shed or has no job pending
+        return 1;
+    }
+
+    decision->taskId = taskId;
+    decision->targetCore = hot->coreAffinity[slot];
+    decision->timeSliceMs = hot->executionTimeMs[slot];
+    g_stats.dispatches++;
+    return 1;
+}
+
+// Scheduler thread, tickless mode: start of the next frame that starts a
+// job, now if a table is waiting to be adopted, or UINT64_MAX without one
+uint64_t cyclic_next_event_us(uint64_t nowUs)
+{
+    CyclicRuntime *runtime = g_runtime;
+    if (g_pendingRuntime || (runtime && !runtime->started))
+    {
+        return nowUs;
+    }
+    if (!runtime)
+    {
+        return UINT64_MAX;
+    }
+
+    for (uint64_t frame = runtime->nextFrame; frame < runtime->nextFrame + runtime->length; frame++)
+    {
+        if (runtime->entries[frame % runtime->length] != CYCLIC_IDLE)
+        {
+            return runtime->startUs + frame * runtime->quantumUs;
+        }
+    }
+    return UINT64_MAX; // A table of idle frames only
+}
+
+void cyclic_get_stats(CyclicStats *stats)
+{
+    *stats = g_stats;
+}
@@ -0,0 +1,387 @@
+#include "../../include/job_executor.h"
+#include "../../include/checkpoint.h"
+#include "../../include/fault_tolerance.h"
+#include "../../include/timer_wheel.h"
+#include "../../include/trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <setjmp.h>
+#include <windows.h>
+
+#define JOB_WORKER_PRIORITY THREAD_PRIORITY_NORMAL
+#define JOB_CALIBRATION_US 10000
+
+// External functions
+extern int kernel_set_task_held(uint32_t taskId, uint8_t held);
+
+// Worker states; the dispatcher and the worker race to move a job out of RUNNING
+enum
+{
+    JOB_WORKER_IDLE,
+    JOB_WORKER_RUNNING,
+    JOB_WORKER_DETACHED // The dispatcher gave up waiting; the worker exits after this job
+};
+
+// Thread that runs jobs for the dispatcher, one at a time
+typedef struct
+{
+    HANDLE thread;
+    HANDLE start; // Auto-reset; a job (or shutdown, with no entry point) is ready
+    HANDLE done;  // Auto-reset; the job returned or was aborted
+    volatile LONG refs;
+    volatile LONG state;
+    volatile LONG abortRequested;
+    volatile int aborted;
+    void (*entryPoint)(void *);
+    void *args;
+    uint32_t taskId;
+    int32_t stateArea; // Pinned while the job runs detached
+    jmp_buf abortJump;
+} JobWorker;
+
+static JobWorker *g_jobWorker = NULL;
+static volatile int g_jobRunning = 0;
+static volatile LONG g_detachedAlive = 0; // Detached workers whose job has not returned yet
+static DWORD g_jobTlsIndex = TLS_OUT_OF_INDEXES;
+static double g_cyclesPerUs = 0.0;
+static JobExecutorStats g_jobStats;
+
+static void job_worker_release(JobWorker *worker)
+{
+    if (InterlockedDecrement(&worker->refs) == 0)
+    {
+        CloseHandle(worker->thread);
+        CloseHandle(worker->start);
+        CloseHandle(worker->done);
+        free(worker);
+    }
+}
+
+static DWORD WINAPI job_worker_func(LPVOID lpParam)
+{
+    JobWorker *worker = (JobWorker *)lpParam;
+    TlsSetValue(g_jobTlsIndex, worker);
+    trace_thread_name("job worker");
+
+    for (;;)
+    {
+        WaitForSingleObject(worker->start, INFINITE);
+        if (!worker->entryPoint)
+        {
+            break; // Shutdown
+        }
+
+        worker->aborted = 0;
+        if (setjmp(worker->abortJump) == 0)
+        {
+            worker->entryPoint(worker->args);
+        }
+        else
+        {
+            worker->aborted = 1;
+        }
+
+        LONG previous = InterlockedCompareExchange(&worker->state, JOB_WORKER_IDLE, JOB_WORKER_RUNNING);
+        SetEvent(worker->done);
+        if (previous == JOB_WORKER_DETACHED)
+        {
+            // The task may be dispatched again now that its job is over
+            kernel_set_task_held(worker->taskId, 0);
+            checkpoint_unpin(worker->stateArea);
+            InterlockedDecrement(&g_detachedAlive);
+            break;
+        }
+    }
+
+    job_worker_release(worker);
+    return 0;
+}
+
+static JobWorker *job_worker_create(void)
+{
+    JobWorker *worker = (JobWorker *)calloc(1, sizeof(JobWorker));
+    if (!worker)
+    {
+        return NULL;
+    }
+
+    worker->refs = 2; // Worker thread and dispatcher
+    worker->start = CreateEvent(NULL, FALSE, FALSE, NULL);
+    worker->done = CreateEvent(NULL, FALSE, FALSE, NULL);
+    worker->thread = (worker->start && worker->done) ? CreateThread(NULL, 0, job_worker_func, worker, 0, NULL) : NULL;
+    if (!worker->thread)
+    {
+        if (worker->start)
+        {
+            CloseHandle(worker->start);
+        }
+        if (worker->done)
+        {
+            CloseHandle(worker->done);
+        }
+        free(worker);
+        return NULL;
+    }
+
+    SetThreadPriority(worker->thread, JOB_WORKER_PRIORITY);
+    return worker;
+}
+
+// QueryThreadCycleTime counts CPU cycles, not time; measure the rate once
+static void job_calibrate_cycles(void)
+{
+    ULONG64 startCycles = 0, endCycles = 0;
+    uint64_t startUs = timer_wheel_now_us();
+    uint64_t elapsedUs;
+
+    QueryThreadCycleTime(GetCurrentThread(), &startCycles);
+    while ((elapsedUs = timer_wheel_now_us() - startUs) < JOB_CALIBRATION_US)
+    {
+        YieldProcessor();
+    }
+    QueryThreadCycleTime(GetCurrentThread(), &endCycles);
+
+    g_cyclesPerUs = endCycles > startCycles ? (double)(endCycles - startCycles) / (double)elapsedUs : 1000.0;
+}
+
+// Stop waiting for a running job and leave it on its worker at the given
+// priority; subsequent jobs go to a fresh worker. The task is held back
+// from dispatch until the job returns, so its jobs never overlap. Returns
+// 0 if the job finished first, in which case the worker is kept, or if
+// BUDGET_MAX_DETACHED jobs are already detached, in which case the
+// dispatcher keeps waiting and tries again later.
+static int job_detach(JobWorker *worker, int priority)
+{
+    if (InterlockedIncrement(&g_detachedAlive) > BUDGET_MAX_DETACHED)
+    {
+        InterlockedDecrement(&g_detachedAlive);
+        g_jobStats.detachRefusals++;
+        return 0;
+    }
+
+    // Held and pinned before the job can see itself detached, so both are
+    // released after it; the pin keeps the task's state allocated should
+    // the task be deleted while the job runs on
+    kernel_set_task_held(worker->taskId, 1);
+    checkpoint_pin(worker->stateArea);
+    SetThreadPriority(worker->thread, priority);
+    if (InterlockedCompareExchange(&worker->state, JOB_WORKER_DETACHED, JOB_WORKER_RUNNING) != JOB_WORKER_RUNNING)
+    {
+        SetThreadPriority(worker->thread, JOB_WORKER_PRIORITY);
+        checkpoint_unpin(worker->stateArea);
+        kernel_set_task_held(worker->taskId, 0);
+        InterlockedDecrement(&g_detachedAlive);
+        return 0;
+    }
+
+    g_jobWorker = job_worker_create();
+    if (!g_jobWorker)
+    {
+        printf("Error: Failed to replace detached job worker\n");
+    }
+    job_worker_release(worker);
+    g_jobStats.detachedWorkers++;
+    return 1;
+}
+
+static void job_report_overrun(const Task *task, uint32_t usedUs, uint32_t budgetUs)
+{
+    g_jobStats.overruns++;
+    if (usedUs - budgetUs > g_jobStats.maxOverrunUs)
+    {
+        g_jobStats.maxOverrunUs = usedUs - budgetUs;
+    }
+
+    TRACE(TRACE_BUDGET_OVERRUN, task->id, usedUs, budgetUs, task->overrunAction);
+    fault_report(TIMING_FAULT, task->id, 0);
+}
+
+void job_executor_start(void)
+{
+    if (g_jobRunning)
+    {
+        return;
+    }
+
+    if (g_jobTlsIndex == TLS_OUT_OF_INDEXES)
+    {
+        g_jobTlsIndex = TlsAlloc();
+        if (g_jobTlsIndex == TLS_OUT_OF_INDEXES)
+        {
+            printf("Error: Failed to allocate job TLS slot\n");
+            exit(1);
+        }
+    }
+
+    job_calibrate_cycles();
+    memset(&g_jobStats, 0, sizeof(g_jobStats));
+
+    g_jobWorker = job_worker_create();
+    if (!g_jobWorker)
+    {
+        printf("Error: Failed to create job worker\n");
+        exit(1);
+    }
+    g_jobRunning = 1;
+
+    printf("Job executor started: %.0f cycles/us, %d%% budget margin\n", g_cyclesPerUs, BUDGET_MARGIN_PERCENT);
+}
+
+// Stop the current worker; detached workers finish their jobs on their own.
+// Call only once nothing can be inside job_execute.
+void job_executor_stop(void)
+{
+    if (!g_jobRunning)
+    {
+        return;
+    }
+
+    g_jobRunning = 0;
+    JobWorker *worker = g_jobWorker;
+    g_jobWorker = NULL;
+    if (worker)
+    {
+        worker->entryPoint = NULL;
+        SetEvent(worker->start);
+        WaitForSingleObject(worker->thread, INFINITE);
+        job_worker_release(worker);
+    }
+}
+
+// Per-job CPU budget: the larger of the declared execution time and the
+// history mean plus three standard deviations, scaled by the margin
+uint32_t job_budget_us(const Task *task)
+{
+    float mean = 0.0f, variance = 0.0f;
+
+    for (int i = 0; i < 10; i++)
+    {
+        mean += task->executionHistory[i];
+    }
+    mean /= 10.0f;
+    for (int i = 0; i < 10; i++)
+    {
+        variance += (task->executionHistory[i] - mean) * (task->executionHistory[i] - mean);
+    }
+
+    float expectedMs = mean + 3.0f * sqrtf(variance / 10.0f);
+    if (expectedMs < (float)task->executionTimeMs)
+    {
+        expectedMs = (float)task->executionTimeMs;
+    }
+    return (uint32_t)(expectedMs * 1000.0f * BUDGET_MARGIN_PERCENT / 100.0f);
+}
+
+// Run one job of a task on the worker and enforce its CPU budget (0 = none)
+// by sampling the worker's cycle count every BUDGET_POLL_MS. The action on
+// overrun is the task's overrunAction. Returns a JOB_* outcome; the CPU
+// time used is stored in cpuUs.
+int job_execute(const Task *task, uint32_t budgetUs, uint32_t *cpuUs)
+{
+    JobWorker *worker = g_jobWorker;
+    if (!g_jobRunning || !worker || !task || !task->entryPoint)
+    {
+        return JOB_NOT_RUN;
+    }
+
+    ULONG64 startCycles = 0, cycles = 0;
+    QueryThreadCycleTime(worker->thread, &startCycles);
+    worker->entryPoint = task->entryPoint;
+    worker->args = task->args;
+    worker->taskId = task->id;
+    worker->stateArea = task->stateArea;
+    worker->abortRequested = 0;
+    worker->state = JOB_WORKER_RUNNING;
+    SetEvent(worker->start);
+    g_jobStats.jobs++;
+
+    int result = JOB_COMPLETED;
+    uint64_t abortRequestedUs = 0;
+    int demotePending = 0;
+    uint32_t usedUs = 0;
+
+    for (;;)
+    {
+        DWORD wait = WaitForSingleObject(worker->done, BUDGET_POLL_MS);
+        QueryThreadCycleTime(worker->thread, &cycles);
+        usedUs = (uint32_t)((double)(cycles - startCycles) / g_cyclesPerUs);
+
+        if (wait == WAIT_OBJECT_0)
+        {
+            if (worker->aborted)
+            {
+                result = JOB_ABORTED;
+            }
+            break;
+        }
+        if (budgetUs == 0 || usedUs <= budgetUs)
+        {
+            continue;
+        }
+
+        if (result == JOB_COMPLETED)
+        {
+            result = JOB_OVERRAN;
+            job_report_overrun(task, usedUs, budgetUs);
+            demotePending = task->overrunAction == BUDGET_ACTION_DEMOTE;
+
+            if (task->overrunAction == BUDGET_ACTION_ABORT)
+            {
+                InterlockedExchange(&worker->abortRequested, 1);
+                abortRequestedUs = timer_wheel_now_us();
+                g_jobStats.aborts++;
+            }
+        }
+        else if (abortRequestedUs && timer_wheel_now_us() - abortRequestedUs > BUDGET_ABORT_GRACE_MS * 1000)
+        {
+            // The job never reached an abort point; leave it behind at idle
+            // priority, or try again after another grace period if too many
+            // jobs are detached already
+            if (job_detach(worker, THREAD_PRIORITY_IDLE))
+            {
+                TRACE(TRACE_BUDGET_DETACHED, task->id, 0, 0, 0);
+                result = JOB_ABORTED;
+                break;
+            }
+            abortRequestedUs = timer_wheel_now_us();
+        }
+
+        // A refused demotion is retried every poll until a detached job ends
+        if (demotePending && job_detach(worker, THREAD_PRIORITY_LOWEST))
+        {
+            g_jobStats.demotions++;
+            TRACE(TRACE_BUDGET_DETACHED, task->id, 0, 0, 0);
+            result = JOB_DETACHED;
+            break;
+        }
+    }
+
+    if (cpuUs)
+    {
+        *cpuUs = usedUs;
+    }
+    return result;
+}
+
+// Cooperative abort point for job code. Unwinds the job if its budget
+// enforcement asked for an abort; call it only where the job holds no
+// locks, since nothing between here and the job entry gets to clean up.
+void job_abort_point(void)
+{
+    JobWorker *worker = g_jobTlsIndex == TLS_OUT_OF_INDEXES ? NULL : (JobWorker *)TlsGetValue(g_jobTlsIndex);
+    if (worker && worker->abortRequested)
+    {
+        longjmp(worker->abortJump, 1);
+    }
+}
+
+void job_executor_get_stats(JobExecutorStats *stats)
+{
+    if (stats)
+    {
+        *stats = g_jobStats;
+    }
+}
@@ -0,0 +1,245 @@
+#include "../../include/job_stats.h"
+#include "../../include/task_manager.h"
+#include "../../include/task_table.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Per-slot job timing, allocated in chunks alongside the task descriptors.
+// Only the scheduler thread records, so the counters need no locking;
+// readers copy them and may see a job half-counted.
+static JobTimingStats *g_jobStatsChunks[TASK_TABLE_MAX_CHUNKS] = {NULL};
+
+static JobTimingStats *job_stats_slot(uint32_t slot)
+{
+    if (slot >= TASK_TABLE_MAX_CAPACITY)
+    {
+        return NULL;
+    }
+
+    JobTimingStats *chunk = g_jobStatsChunks[slot / TASK_TABLE_CHUNK_SIZE];
+    return chunk ? &chunk[slot % TASK_TABLE_CHUNK_SIZE] : NULL;
+}
+
+// Stats for the task, cleared first if the slot last held another task
+static JobTimingStats *job_stats_for(uint32_t taskId)
+{
+    JobTimingStats *stats = job_stats_slot(TASK_HANDLE_SLOT(taskId));
+    if (stats && stats->taskId != taskId)
+    {
+        memset(stats, 0, sizeof(JobTimingStats));
+        stats->taskId = taskId;
+    }
+    return stats;
+}
+
+static int timing_bucket(uint64_t us)
+{
+    if (us < 4)
+    {
+        return (int)us;
+    }
+
+    int msb = 63;
+    while (!(us >> msb))
+    {
+        msb--;
+    }
+
+    int bucket = (msb - 1) * 4 + (int)((us >> (msb - 2)) & 3);
+    return bucket < JOB_TIMING_BUCKETS ? bucket : JOB_TIMING_BUCKETS - 1;
+}
+
+// Smallest time that falls into the bucket after this one
+static uint64_t timing_bucket_limit(int bucket)
+{
+    bucket++;
+    if (bucket < 4)
+    {
+        return (uint64_t)bucket;
+    }
+
+    int msb = bucket / 4 + 1;
+    return (uint64_t)(4 + bucket % 4) << (msb - 2);
+}
+
+// Make sure stats exist for the first taskCapacity slots
+int job_stats_reserve(int taskCapacity)
+{
+    for (int chunk = 0; chunk * TASK_TABLE_CHUNK_SIZE < taskCapacity; chunk++)
+    {
+        if (chunk >= TASK_TABLE_MAX_CHUNKS)
+        {
+            return -1;
+        }
+        if (g_jobStatsChunks[chunk] == NULL)
+        {
+            g_jobStatsChunks[chunk] = (JobTimingStats *)calloc(TASK_TABLE_CHUNK_SIZE, sizeof(JobTimingStats));
+            if (!g_jobStatsChunks[chunk])
+            {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Forget a recycled slot's history so its next task starts clean
+void job_stats_release(int slot)
+{
+    JobTimingStats *stats = job_stats_slot((uint32_t)slot);
+    if (stats)
+    {
+        memset(stats, 0, sizeof(JobTimingStats));
+        stats->taskId = TASK_INVALID_ID;
+    }
+}
+
+// Account one released job. completed is 0 if the job has no finish time
+// (aborted, detached or out of time), which always counts as a miss.
+// Returns 1 if the job missed its deadline, 0 if it met it.
+int job_stats_record(uint32_t taskId, uint64_t releaseUs, uint64_t startUs, uint64_t finishUs,
+                     uint32_t deadlineMs, int completed)
+{
+    JobTimingStats *stats = job_stats_for(taskId);
+    if (!stats)
+    {
+        return 0;
+    }
+
+    uint64_t latencyUs = startUs > releaseUs ? startUs - releaseUs : 0;
+    stats->jobs++;
+    stats->latencySumUs += latencyUs;
+    stats->latencyMaxUs = latencyUs > stats->latencyMaxUs ? latencyUs : stats->latencyMaxUs;
+    stats->latencyHistogram[timing_bucket(latencyUs)]++;
+
+    if (!completed)
+    {
+        stats->abandoned++;
+        stats->misses++;
+        return 1;
+    }
+
+    uint64_t responseUs = finishUs > releaseUs ? finishUs - releaseUs : 0;
+    int64_t latenessUs = (int64_t)responseUs - (int64_t)deadlineMs * 1000;
+    stats->completed++;
+    stats->responseSumUs += responseUs;
+    stats->responseMaxUs = responseUs > stats->responseMaxUs ? responseUs : stats->responseMaxUs;
+    stats->responseHistogram[timing_bucket(responseUs)]++;
+    stats->latenessSumUs += latenessUs;
+    if (stats->completed == 1 || latenessUs > stats->latenessMaxUs)
+    {
+        stats->latenessMaxUs = latenessUs;
+    }
+
+    if (latenessUs <= 0)
+    {
+        stats->hits++;
+        return 0;
+    }
+
+    stats->misses++;
+    stats->tardinessMaxUs = (uint64_t)latenessUs > stats->tardinessMaxUs ? (uint64_t)latenessUs : stats->tardinessMaxUs;
+    stats->tardinessHistogram[timing_bucket((uint64_t)latenessUs)]++;
+    return 1;
+}
+
+// Releases that never ran because later ones overwrote them in the queue
+void job_stats_skip(uint32_t taskId, uint32_t releases)
+{
+    JobTimingStats *stats = job_stats_for(taskId);
+    if (stats)
+    {
+        stats->skipped += releases;
+        stats->misses += releases;
+    }
+}
+
+// Returns 0, or -1 if the ID is stale (its slot now holds another task's jobs)
+int job_stats_get(uint32_t taskId, JobTimingStats *stats)
+{
+    const JobTimingStats *current = job_stats_slot(TASK_HANDLE_SLOT(taskId));
+    if (current && current->taskId == taskId)
+    {
+        *stats = *current;
+        return 0;
+    }
+    if (current && (current->jobs > 0 || current->skipped > 0))
+    {
+        return -1;
+    }
+
+    memset(stats, 0, sizeof(JobTimingStats)); // Not dispatched yet
+    stats->taskId = taskId;
+    return 0;
+}
+
+// Every slot's jobs summed, maxima over all tasks
+void job_stats_get_totals(JobTimingStats *stats)
+{
+    memset(stats, 0, sizeof(JobTimingStats));
+    stats->taskId = TASK_INVALID_ID;
+
+    for (int chunk = 0; chunk < TASK_TABLE_MAX_CHUNKS && g_jobStatsChunks[chunk]; chunk++)
+    {
+        for (int i = 0; i < TASK_TABLE_CHUNK_SIZE; i++)
+        {
+            const JobTimingStats *task = &g_jobStatsChunks[chunk][i];
+            if (task->jobs == 0 && task->skipped == 0)
+            {
+                continue;
+            }
+
+            if (task->completed > 0 && (stats->completed == 0 || task->latenessMaxUs > stats->latenessMaxUs))
+            {
+                stats->latenessMaxUs = task->latenessMaxUs;
+            }
+            stats->jobs += task->jobs;
+            stats->hits += task->hits;
+            stats->misses += task->misses;
+            stats->abandoned += task->abandoned;
+            stats->skipped += task->skipped;
+            stats->completed += task->completed;
+            stats->latencySumUs += task->latencySumUs;
+            stats->latencyMaxUs = task->latencyMaxUs > stats->latencyMaxUs ? task->latencyMaxUs : stats->latencyMaxUs;
+            stats->responseSumUs += task->responseSumUs;
+            stats->responseMaxUs = task->responseMaxUs > stats->responseMaxUs ? task->responseMaxUs : stats->responseMaxUs;
+            stats->latenessSumUs += task->latenessSumUs;
+            stats->tardinessMaxUs = task->tardinessMaxUs > stats->tardinessMaxUs ? task->tardinessMaxUs : stats->tardinessMaxUs;
+            for (int bucket = 0; bucket < JOB_TIMING_BUCKETS; bucket++)
+            {
+                stats->latencyHistogram[bucket] += task->latencyHistogram[bucket];
+                stats->responseHistogram[bucket] += task->responseHistogram[bucket];
+                stats->tardinessHistogram[bucket] += task->tardinessHistogram[bucket];
+            }
+        }
+    }
+}
+
+// Upper bound (us) of the bucket holding the given percentile (0-100)
+uint64_t job_stats_percentile(const uint32_t *histogram, uint64_t count, double percentile)
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)count + 0.5);
+    uint64_t seen = 0;
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+
+    for (int bucket = 0; bucket < JOB_TIMING_BUCKETS; bucket++)
+    {
+        seen += histogram[bucket];
+        if (seen >= rank)
+        {
+            return timing_bucket_limit(bucket);
+        }
+    }
+
+    return timing_bucket_limit(JOB_TIMING_BUCKETS - 1);
+}
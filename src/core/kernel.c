@@ -1,9 +1,20 @@
 #include "../../include/system_config.h"
 #include "../../include/task_manager.h"
+#include "../../include/task_table.h"
 #include "../../include/scheduler.h"
 #include "../../include/ml_engine.h"
 #include "../../include/fault_tolerance.h"
 #include "../../include/memory_matrix.h"
+#include "../../include/timer_wheel.h"
+#include "../../include/tmr_executor.h"
+#include "../../include/checkpoint.h"
+#include "../../include/scrubber.h"
+#include "../../include/job_executor.h"
+#include "../../include/trace.h"
+#include "../../include/sched_log.h"
+#include "../../include/schedulability.h"
+#include "../../include/job_stats.h"
+#include "../../include/mixed_criticality.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -12,14 +23,57 @@
 
 // Global system state
 static SystemStateVector g_systemState = {0};
-static Task g_tasks[MAX_TASKS] = {0};
-static int g_taskCount = 0;
+static Task *g_taskChunks[TASK_TABLE_MAX_CHUNKS] = {NULL}; // Cold descriptors, also the Task view
+static TaskHotTable *volatile g_hotTasks = NULL;            // Hot fields scanned by the schedulers
+static int *g_freeSlots = NULL;                             // Recycled slots, reused before the table grows
+static int g_freeSlotCount = 0;
+static int g_freeSlotCapacity = 0;
+// Bumped on every change a static schedule depends on: a task coming (with
+// the period admission control gave it, stretched or not), going, changing
+// execution time or turning sporadic, which server attachment also does.
+// Periods and deadlines are fixed once a task is added.
+static volatile LONG g_taskSetVersion = 0;
+
+// Kernel-private per-task runtime state, allocated alongside the descriptor chunks
+typedef struct
+{
+    volatile LONG sequence;        // Seqlock, odd while a writer is inside
+    volatile LONG pendingReleases; // Jobs released by the timer wheel but not yet run
+    volatile LONG releaseCount;    // Releases so far; indexes releaseTimes
+    LONG consumedCount;            // Releases consumed by the scheduler thread
+    uint64_t releaseTimes[JOB_RELEASE_QUEUE_DEPTH]; // Release times of the newest pending jobs
+    uint32_t taskId;
+    uint8_t shed;  // Held back by the mixed-criticality mode; dispatchable only if also active
+    uint8_t gated; // Dispatchable only while a release is pending
+    uint8_t held;  // A detached job of the task is still running
+    TimerWheelTimer releaseTimer;
+} TaskRuntime;
+
+static TaskRuntime *g_taskRuntimeChunks[TASK_TABLE_MAX_CHUNKS] = {NULL};
+static CRITICAL_SECTION g_taskTableLock; // Serializes table-shape changes; readers never take it
 static SystemState g_currentState = NORMAL_STATE;
 static HANDLE g_schedulerThread = NULL;
 static HANDLE g_faultMonitorThread = NULL;
-static HANDLE g_systemTimer = NULL;
+static HANDLE g_schedulerTickEvent = NULL;
+static TimerWheelTimer g_schedulerTimer;
+static HANDLE g_voterThread = NULL;
+static HANDLE g_votingEvent = NULL;
+static TimerWheelTimer g_votingTimer;
+static HANDLE g_checkpointThread = NULL;
+static HANDLE g_checkpointEvent = NULL;
+static TimerWheelTimer g_checkpointTimer;
+static HANDLE g_scrubberThread = NULL;
+static HANDLE g_scrubEvent = NULL;
+static TimerWheelTimer g_scrubTimer;
 static int g_running = 0;
-static uint64_t g_tickCount = 0;
+static uint64_t g_tickCount = 0;         // Scheduler decisions: one per period, or one per event when tickless
+static int g_tickless = SCHEDULER_TICKLESS; // Fixed once the kernel starts
+
+// Forward declarations
+Task *kernel_task_write_begin(uint32_t taskId);
+void kernel_task_write_end(uint32_t taskId);
+void kernel_wake_scheduler(void);
+
 
 // Helper functions for Windows simulation
 LARGE_INTEGER g_frequency;
@@ -32,26 +86,248 @@ static uint64_t get_time_ns(void)
     return (current.QuadPart - g_startTime.QuadPart) * 1000000000 / g_frequency.QuadPart;
 }
 
+// Allocate the descriptor chunk (and per-task fault state and job stats) backing a slot
+static int kernel_reserve_slot(int slot)
+{
+    int chunk = slot / TASK_TABLE_CHUNK_SIZE;
+    if (g_taskRuntimeChunks[chunk] == NULL)
+    {
+        TaskRuntime *runtime = (TaskRuntime *)calloc(TASK_TABLE_CHUNK_SIZE, sizeof(TaskRuntime));
+        if (!runtime)
+        {
+            return -1;
+        }
+        g_taskRuntimeChunks[chunk] = runtime;
+    }
+    if (g_taskChunks[chunk] == NULL)
+    {
+        Task *descriptors = (Task *)calloc(TASK_TABLE_CHUNK_SIZE, sizeof(Task));
+        if (!descriptors)
+        {
+            return -1;
+        }
+        g_taskChunks[chunk] = descriptors;
+    }
+
+    if (job_stats_reserve(slot + 1) != 0)
+    {
+        return -1;
+    }
+    return fault_tolerance_reserve(slot + 1);
+}
+
+static TaskRuntime *task_runtime(int slot)
+{
+    TaskRuntime *chunk = g_taskRuntimeChunks[slot / TASK_TABLE_CHUNK_SIZE];
+    return chunk ? &chunk[slot % TASK_TABLE_CHUNK_SIZE] : NULL;
+}
+
+// Per-task seqlock. The sequence is odd while a writer is inside; writers
+// serialize on the even-to-odd transition and readers retry if it moved,
+// so readers never block writers but may spin behind one.
+static volatile LONG *task_sequence(int slot)
+{
+    TaskRuntime *runtime = task_runtime(slot);
+    return runtime ? &runtime->sequence : NULL;
+}
+
+// The hot active flag the policies scan: the task is active, not shed, has
+// no detached job still running and, unless it opted out of release
+// gating, has a released job waiting
+static uint8_t task_dispatchable(const Task *descriptor, const TaskRuntime *runtime)
+{
+    return descriptor->active && !runtime->shed && !runtime->held &&
+           (!runtime->gated || runtime->pendingReleases > 0);
+}
+
+// Recompute the hot active flag after a gated task's pending count crossed
+// zero. Every crossing is followed by one, each reading the count under the
+// table lock, so the last one leaves the flag matching the count.
+static void kernel_refresh_dispatchable(uint32_t taskId)
+{
+    EnterCriticalSection(&g_taskTableLock);
+    Task *descriptor = kernel_task_write_begin(taskId);
+    if (descriptor)
+    {
+        int slot = (int)TASK_HANDLE_SLOT(taskId);
+        g_hotTasks->active[slot] = task_dispatchable(descriptor, task_runtime(slot));
+        kernel_task_write_end(taskId);
+    }
+    LeaveCriticalSection(&g_taskTableLock);
+}
+
+// Release timer callback: one more job of the task is ready to run
+static void task_release_callback(void *arg)
+{
+    TaskRuntime *runtime = (TaskRuntime *)arg;
+    uint64_t nowUs = timer_wheel_now_us();
+    ULONG index = (ULONG)InterlockedIncrement(&runtime->releaseCount) - 1;
+    runtime->releaseTimes[index % JOB_RELEASE_QUEUE_DEPTH] = nowUs;
+    // Published after its release time
+    if (InterlockedIncrement(&runtime->pendingReleases) == 1 && runtime->gated)
+    {
+        kernel_refresh_dispatchable(runtime->taskId);
+    }
+    scheduler_notify_release(runtime->taskId, nowUs);
+    sched_log_release(runtime->taskId);
+    kernel_wake_scheduler();
+}
+
+// Signals the event passed as arg; paces the scheduler and background threads
+static void scheduler_timer_callback(void *arg)
+{
+    SetEvent((HANDLE)arg);
+}
+
+static void task_write_lock(int slot)
+{
+    volatile LONG *sequence = task_sequence(slot);
+    for (;;)
+    {
+        LONG current = *sequence;
+        if (!(current & 1) && InterlockedCompareExchange(sequence, current + 1, current) == current)
+        {
+            return;
+        }
+        YieldProcessor();
+    }
+}
+
+static void task_write_unlock(int slot)
+{
+    InterlockedIncrement(task_sequence(slot));
+}
+
+// Double the hot table. Readers may still hold the old table, so it is
+// retired rather than freed; retired tables are released in kernel_stop.
+static int kernel_grow_task_table(void)
+{
+    TaskHotTable *current = g_hotTasks;
+    int capacity = current->capacity * 2;
+
+    if (capacity > TASK_TABLE_MAX_CAPACITY)
+    {
+        return -1;
+    }
+
+    TaskHotTable *bigger = task_table_create(capacity, g_taskChunks);
+    if (!bigger)
+    {
+        return -1;
+    }
+
+    task_table_copy(bigger, current);
+    bigger->retired = current;
+    InterlockedExchangePointer((PVOID volatile *)&g_hotTasks, bigger);
+
+    printf("Task table grown to %d slots\n", capacity);
+    return 0;
+}
+
+// Tickless mode: program the one-shot scheduler timer for the next instant
+// the scheduler asked for, or leave it idle until an event wakes it
+static void kernel_program_next_event(void)
+{
+    uint64_t nextUs = scheduler_next_event_us();
+    uint64_t nowUs = timer_wheel_now_us();
+
+    if (nextUs <= nowUs)
+    {
+        timer_wheel_cancel(&g_schedulerTimer);
+        SetEvent(g_schedulerTickEvent); // Decide again at once
+    }
+    else if (nextUs != UINT64_MAX)
+    {
+        timer_wheel_arm(&g_schedulerTimer, nextUs - nowUs, 0, scheduler_timer_callback, g_schedulerTickEvent);
+    }
+    else
+    {
+        timer_wheel_cancel(&g_schedulerTimer);
+    }
+}
+
 static DWORD WINAPI scheduler_thread_func(LPVOID lpParam)
 {
+    trace_thread_name("scheduler");
     while (g_running)
     {
+        // Periods come from the timer wheel, so tick cost does not add drift.
+        // Tickless, the only wakeups are the programmed instant and events.
+        WaitForSingleObject(g_schedulerTickEvent, g_tickless ? INFINITE : SCHEDULER_PERIOD_MS * 2);
+        if (!g_running)
+        {
+            break;
+        }
         scheduler_tick();
-        Sleep(SCHEDULER_PERIOD_MS);
+        if (g_tickless)
+        {
+            kernel_program_next_event();
+        }
+    }
+    return 0;
+}
+
+// Votes the TMR-replicated memory regions once per voting period
+static DWORD WINAPI voter_thread_func(LPVOID lpParam)
+{
+    trace_thread_name("tmr voter");
+    while (g_running)
+    {
+        WaitForSingleObject(g_votingEvent, VOTING_PERIOD_MS * 2);
+        if (!g_running)
+        {
+            break;
+        }
+        memory_matrix_tmr_vote_all();
+    }
+    return 0;
+}
+
+// Checkpoints the memory-matrix regions once per checkpoint period; task
+// state is checkpointed by the scheduler between jobs
+static DWORD WINAPI checkpoint_thread_func(LPVOID lpParam)
+{
+    trace_thread_name("checkpoint");
+    while (g_running)
+    {
+        WaitForSingleObject(g_checkpointEvent, CHECKPOINT_PERIOD_MS * 2);
+        if (!g_running)
+        {
+            break;
+        }
+        memory_matrix_checkpoint_all();
+    }
+    return 0;
+}
+
+// Verifies a budgeted number of scrub blocks per slot. The thread runs at
+// idle priority, so it only uses cycles the real-time threads leave over.
+static DWORD WINAPI scrubber_thread_func(LPVOID lpParam)
+{
+    trace_thread_name("scrubber");
+    while (g_running)
+    {
+        WaitForSingleObject(g_scrubEvent, SCRUB_SLOT_MS * 2);
+        if (!g_running)
+        {
+            break;
+        }
+        scrubber_run(SCRUB_BLOCKS_PER_SLOT);
     }
     return 0;
 }
 
 static DWORD WINAPI fault_monitor_thread_func(LPVOID lpParam)
 {
+    trace_thread_name("fault monitor");
     while (g_running)
     {
-        FaultDetectionResult result = fault_check_system();
-        if (result.faultDetected)
+        // Sleep until something reports a fault; watchdog deadlines live on the timer wheel.
+        // Collection only routes faults, the recovery pool runs the actions.
+        if (fault_wait(INFINITE))
         {
-            fault_recovery_action(&result);
+            fault_check_system();
         }
-        Sleep(VOTING_PERIOD_MS);
     }
     return 0;
 }
@@ -62,13 +338,28 @@ void kernel_init(void)
     QueryPerformanceFrequency(&g_frequency);
     QueryPerformanceCounter(&g_startTime);
 
-    // Initialize subsystems
+    // Initialize subsystems; the timer wheel first, as the time base for the rest
+    printf("Initializing timer wheel...\n");
+    timer_wheel_init();
+
+    printf("Initializing checkpoint store...\n");
+    checkpoint_init();
+
+    printf("Initializing memory scrubber...\n");
+    scrubber_init();
+
     printf("Initializing memory matrix...\n");
     memory_matrix_init();
 
     printf("Initializing scheduler...\n");
     scheduler_init();
 
+    printf("Initializing schedulability analysis...\n");
+    sched_analysis_init();
+
+    printf("Initializing mixed-criticality mode...\n");
+    mc_init();
+
     printf("Initializing ML engine...\n");
     ml_engine_init();
 
@@ -83,8 +374,17 @@ void kernel_init(void)
     g_systemState.activeTaskCount = 0;
     g_systemState.state = NORMAL_STATE;
 
+    // Initialize task table
+    InitializeCriticalSection(&g_taskTableLock);
+    g_hotTasks = task_table_create(TASK_TABLE_INITIAL_CAPACITY, g_taskChunks);
+    if (!g_hotTasks)
+    {
+        printf("Error: Failed to allocate task table\n");
+        exit(1);
+    }
+    g_freeSlotCount = 0;
+
     g_running = 0;
-    g_taskCount = 0;
     g_tickCount = 0;
 
     printf("RTOS kernel initialized successfully\n");
@@ -96,6 +396,20 @@ void kernel_start(void)
         return;
 
     g_running = 1;
+    timer_wheel_start();
+#if TMR_ENABLED
+    tmr_executor_start();
+#endif
+    job_executor_start();
+
+    g_schedulerTickEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (g_schedulerTickEvent == NULL)
+    {
+        printf("Error: Failed to create scheduler tick event\n");
+        exit(1);
+    }
+    timer_wheel_arm(&g_schedulerTimer, 0, g_tickless ? 0 : SCHEDULER_PERIOD_MS * 1000, scheduler_timer_callback,
+                    g_schedulerTickEvent);
 
     // Create scheduler thread
     g_schedulerThread = CreateThread(NULL, 0, scheduler_thread_func, NULL, 0, NULL);
@@ -105,6 +419,45 @@ void kernel_start(void)
         exit(1);
     }
 
+#if TMR_ENABLED
+    g_votingEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    g_voterThread = g_votingEvent ? CreateThread(NULL, 0, voter_thread_func, NULL, 0, NULL) : NULL;
+    if (g_voterThread == NULL)
+    {
+        printf("Error: Failed to create TMR voter thread\n");
+        exit(1);
+    }
+    timer_wheel_arm(&g_votingTimer, VOTING_PERIOD_MS * 1000, VOTING_PERIOD_MS * 1000, scheduler_timer_callback, g_votingEvent);
+#endif
+
+#if CHECKPOINT_ENABLED
+    g_checkpointEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    g_checkpointThread = g_checkpointEvent ? CreateThread(NULL, 0, checkpoint_thread_func, NULL, 0, NULL) : NULL;
+    if (g_checkpointThread == NULL)
+    {
+        printf("Error: Failed to create checkpoint thread\n");
+        exit(1);
+    }
+    SetThreadPriority(g_checkpointThread, THREAD_PRIORITY_BELOW_NORMAL);
+    timer_wheel_arm(&g_checkpointTimer, CHECKPOINT_PERIOD_MS * 1000, CHECKPOINT_PERIOD_MS * 1000,
+                    scheduler_timer_callback, g_checkpointEvent);
+#endif
+
+#if SCRUB_ENABLED
+    g_scrubEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    g_scrubberThread = g_scrubEvent ? CreateThread(NULL, 0, scrubber_thread_func, NULL, 0, NULL) : NULL;
+    if (g_scrubberThread == NULL)
+    {
+        printf("Error: Failed to create scrubber thread\n");
+        exit(1);
+    }
+    SetThreadPriority(g_scrubberThread, THREAD_PRIORITY_IDLE);
+    timer_wheel_arm(&g_scrubTimer, SCRUB_SLOT_MS * 1000, SCRUB_SLOT_MS * 1000, scheduler_timer_callback, g_scrubEvent);
+#endif
+
+    // Recovery workers must exist before the monitor hands them faults
+    fault_recovery_start();
+
     // Create fault monitor thread
     g_faultMonitorThread = CreateThread(NULL, 0, fault_monitor_thread_func, NULL, 0, NULL);
     if (g_faultMonitorThread == NULL)
@@ -122,13 +475,64 @@ void kernel_stop(void)
         return;
 
     g_running = 0;
+    SetEvent(g_schedulerTickEvent);
+    fault_wake_monitor();
+#if TMR_ENABLED
+    SetEvent(g_votingEvent);
+    WaitForSingleObject(g_voterThread, INFINITE);
+    timer_wheel_cancel(&g_votingTimer);
+    CloseHandle(g_voterThread);
+#endif
+#if CHECKPOINT_ENABLED
+    SetEvent(g_checkpointEvent);
+    WaitForSingleObject(g_checkpointThread, INFINITE);
+    timer_wheel_cancel(&g_checkpointTimer);
+    CloseHandle(g_checkpointThread);
+#endif
+#if SCRUB_ENABLED
+    SetEvent(g_scrubEvent);
+    WaitForSingleObject(g_scrubberThread, INFINITE);
+    timer_wheel_cancel(&g_scrubTimer);
+    CloseHandle(g_scrubberThread);
+#endif
 
     // Wait for threads to terminate
     WaitForSingleObject(g_schedulerThread, INFINITE);
     WaitForSingleObject(g_faultMonitorThread, INFINITE);
+#if TMR_ENABLED
+    tmr_executor_stop(); // After the scheduler, the only caller of tmr_execute
+#endif
+    job_executor_stop(); // Likewise for job_execute
+    fault_recovery_stop();
+
+    // Stopping the wheel waits out any callback still using the event
+    timer_wheel_cancel(&g_schedulerTimer);
+    timer_wheel_stop();
 
     CloseHandle(g_schedulerThread);
     CloseHandle(g_faultMonitorThread);
+    CloseHandle(g_schedulerTickEvent);
+#if TMR_ENABLED
+    CloseHandle(g_votingEvent);
+#endif
+#if CHECKPOINT_ENABLED
+    CloseHandle(g_checkpointEvent);
+#endif
+#if SCRUB_ENABLED
+    CloseHandle(g_scrubEvent);
+#endif
+
+    // No reader can still hold a retired table once the threads are gone
+    EnterCriticalSection(&g_taskTableLock);
+    TaskHotTable *retired = g_hotTasks->retired;
+    g_hotTasks->retired = NULL;
+    while (retired)
+    {
+        TaskHotTable *next = retired->retired;
+        task_table_destroy(retired);
+        retired = next;
+    }
+    LeaveCriticalSection(&g_taskTableLock);
 
     printf("RTOS kernel stopped\n");
 }
@@ -149,24 +553,515 @@ void kernel_update_load(float cpuLoad, float memoryUsage)
 
 int kernel_add_task(Task *task)
 {
-    if (g_taskCount >= MAX_TASKS)
+    EnterCriticalSection(&g_taskTableLock);
+
+    TaskHotTable *hot = g_hotTasks;
+    int slot;
+
+    if (g_freeSlotCount > 0)
+    {
+        slot = g_freeSlots[--g_freeSlotCount];
+    }
+    else
+    {
+        if (hot->count >= hot->capacity)
+        {
+            if (kernel_grow_task_table() != 0)
+            {
+                LeaveCriticalSection(&g_taskTableLock);
+                return -1; // Too many tasks
+            }
+            hot = g_hotTasks;
+        }
+        slot = hot->count;
+    }
+
+    if (kernel_reserve_slot(slot) != 0)
     {
-        return -1; // Too many tasks
+        if (slot < hot->count)
+        {
+            g_freeSlots[g_freeSlotCount++] = slot;
+        }
+        LeaveCriticalSection(&g_taskTableLock);
+        return -1; // Out of memory
     }
 
-    g_tasks[g_taskCount] = *task;
-    g_tasks[g_taskCount].id = g_taskCount;
-    g_tasks[g_taskCount].active = 1;
-    g_taskCount++;
-    g_systemState.activeTaskCount = g_taskCount;
+    TaskRuntime *runtime = task_runtime(slot);
+    runtime->pendingReleases = 0;
+    runtime->releaseCount = 0;
+    runtime->consumedCount = 0;
+    runtime->shed = 0;
+    runtime->gated = 1;
+    runtime->held = 0;
+
+    task_write_lock(slot);
+    Task *descriptor = task_table_cold(hot, slot);
+    *descriptor = *task;
+    descriptor->id = task_table_handle(hot, slot);
+    descriptor->active = 1;
+    task_table_store(hot, slot, descriptor);
+    hot->active[slot] = task_dispatchable(descriptor, runtime); // Not before its first release
+    hot->allocated[slot] = 1;
+    sched_log_task(descriptor);
+    task_write_unlock(slot);
+
+    // Periodic tasks get a release timer; the first job is released at once
+    runtime->taskId = descriptor->id;
+    if (descriptor->periodMs > 0)
+    {
+        timer_wheel_arm(&runtime->releaseTimer, 0, (uint64_t)descriptor->periodMs * 1000,
+                        task_release_callback, runtime);
+    }
+
+    // Publish the slot only once it is fully initialized
+    MemoryBarrier();
+    if (slot == hot->count)
+    {
+        hot->count = slot + 1;
+    }
+    g_systemState.activeTaskCount++;
+    InterlockedIncrement(&g_taskSetVersion);
 
-    return g_taskCount - 1; // Return task ID
+    LeaveCriticalSection(&g_taskTableLock);
+    return (int)descriptor->id; // Return task ID
 }
 
-Task *kernel_get_tasks(int *count)
+int kernel_remove_task(uint32_t taskId)
 {
-    *count = g_taskCount;
-    return g_tasks;
+    EnterCriticalSection(&g_taskTableLock);
+
+    // Grow the free list before touching the slot so removal cannot fail halfway
+    if (g_freeSlotCount == g_freeSlotCapacity)
+    {
+        int capacity = g_freeSlotCapacity ? g_freeSlotCapacity * 2 : TASK_TABLE_INITIAL_CAPACITY;
+        int *slots = (int *)realloc(g_freeSlots, (size_t)capacity * sizeof(int));
+        if (!slots)
+        {
+            LeaveCriticalSection(&g_taskTableLock);
+            return -1;
+        }
+        g_freeSlots = slots;
+        g_freeSlotCapacity = capacity;
+    }
+
+    Task *descriptor = kernel_task_write_begin(taskId);
+    if (!descriptor)
+    {
+        LeaveCriticalSection(&g_taskTableLock);
+        return -1; // Unknown or stale ID
+    }
+
+    TaskHotTable *hot = g_hotTasks;
+    int slot = (int)TASK_HANDLE_SLOT(taskId);
+    hot->active[slot] = 0;
+    hot->allocated[slot] = 0;
+    hot->generation[slot] = (uint16_t)((hot->generation[slot] + 1) & TASK_HANDLE_GENERATION_MASK);
+    descriptor->active = 0;
+    task_write_unlock(slot);
+
+    timer_wheel_cancel(&task_runtime(slot)->releaseTimer);
+    sched_log_remove(taskId);
+    fault_tolerance_release(slot);
+    job_stats_release(slot);
+    g_freeSlots[g_freeSlotCount++] = slot;
+    g_systemState.activeTaskCount--;
+    InterlockedIncrement(&g_taskSetVersion);
+
+    LeaveCriticalSection(&g_taskTableLock);
+    return 0;
+}
+
+// Begin an in-place update of a task. Returns the descriptor with the task's
+// seqlock held, or NULL for a stale ID. Hot fields must only be changed
+// through the kernel setters, which also hold the table lock.
+Task *kernel_task_write_begin(uint32_t taskId)
+{
+    TaskHotTable *hot = g_hotTasks;
+    int slot = (int)TASK_HANDLE_SLOT(taskId);
+
+    if (slot >= hot->count || !task_sequence(slot))
+    {
+        return NULL;
+    }
+
+    task_write_lock(slot);
+    hot = g_hotTasks;
+    if (!hot->allocated[slot] || hot->generation[slot] != TASK_HANDLE_GENERATION(taskId))
+    {
+        task_write_unlock(slot);
+        return NULL;
+    }
+
+    return task_table_cold(hot, slot);
+}
+
+void kernel_task_write_end(uint32_t taskId)
+{
+    task_write_unlock((int)TASK_HANDLE_SLOT(taskId));
+}
+
+// Copy a consistent snapshot of the task in a slot. Lock-free, not
+// wait-free: readers never block writers, but spin while a writer is
+// inside and retry if one published meanwhile.
+int kernel_read_task_slot(int slot, Task *snapshot)
+{
+    if (slot < 0 || slot >= g_hotTasks->count)
+    {
+        return -1;
+    }
+
+    volatile LONG *sequence = task_sequence(slot);
+    for (;;)
+    {
+        LONG before = *sequence;
+        if (before & 1)
+        {
+            YieldProcessor();
+            continue;
+        }
+        MemoryBarrier();
+
+        TaskHotTable *hot = g_hotTasks;
+        int live = hot->allocated[slot];
+        if (live)
+        {
+            *snapshot = *task_table_cold(hot, slot);
+        }
+
+        MemoryBarrier();
+        if (*sequence == before)
+        {
+            return live ? 0 : -1;
+        }
+    }
+}
+
+// Snapshot by ID; stale or unknown IDs fail
+int kernel_read_task(uint32_t taskId, Task *snapshot)
+{
+    if (kernel_read_task_slot((int)TASK_HANDLE_SLOT(taskId), snapshot) != 0 || snapshot->id != taskId)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+// Consume the oldest pending release of a task and report its release
+// time. Only the newest JOB_RELEASE_QUEUE_DEPTH releases keep their time;
+// older ones are dropped here and counted in skipped. Called only by the
+// scheduler thread. Returns 1 if a job was pending, 0 if none was, or -1
+// for a stale ID.
+int kernel_consume_release(uint32_t taskId, uint64_t *releaseUs, uint32_t *skipped)
+{
+    Task snapshot;
+    if (kernel_read_task(taskId, &snapshot) != 0)
+    {
+        return -1;
+    }
+
+    TaskRuntime *runtime = task_runtime((int)TASK_HANDLE_SLOT(taskId));
+    LONG dropped;
+    for (;;)
+    {
+        LONG pending = runtime->pendingReleases;
+        if (pending <= 0)
+        {
+            return 0;
+        }
+        dropped = pending > JOB_RELEASE_QUEUE_DEPTH ? pending - JOB_RELEASE_QUEUE_DEPTH : 0;
+        if (InterlockedCompareExchange(&runtime->pendingReleases, pending - dropped - 1, pending) == pending)
+        {
+            break;
+        }
+    }
+    if (runtime->pendingReleases == 0 && runtime->gated)
+    {
+        kernel_refresh_dispatchable(taskId);
+    }
+
+    runtime->consumedCount += dropped;
+    if (releaseUs)
+    {
+        *releaseUs = runtime->releaseTimes[(ULONG)runtime->consumedCount % JOB_RELEASE_QUEUE_DEPTH];
+    }
+    if (skipped)
+    {
+        *skipped = (uint32_t)dropped;
+    }
+    runtime->consumedCount++;
+    return 1;
+}
+
+// Drop every pending release of a task without running it. Called only by
+// the scheduler thread. Returns the number dropped, or -1 for a stale ID.
+int kernel_discard_releases(uint32_t taskId)
+{
+    Task snapshot;
+    if (kernel_read_task(taskId, &snapshot) != 0)
+    {
+        return -1;
+    }
+
+    TaskRuntime *runtime = task_runtime((int)TASK_HANDLE_SLOT(taskId));
+    LONG pending = InterlockedExchange(&runtime->pendingReleases, 0);
+    runtime->consumedCount += pending;
+    if (pending > 0 && runtime->gated)
+    {
+        kernel_refresh_dispatchable(taskId);
+    }
+    return (int)pending;
+}
+
+// Whether any dispatchable task has a released job waiting. A scan, meant
+// for the idle-instant check while the criticality mode is raised.
+int kernel_has_pending_jobs(void)
+{
+    TaskHotTable *hot = g_hotTasks;
+    int count = hot->count;
+
+    for (int i = 0; i < count; i++)
+    {
+        TaskRuntime *runtime = task_runtime(i);
+        if (hot->active[i] && runtime && runtime->pendingReleases > 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Pending releases of a task already past their deadline: jobs that will
+// miss when they finally run, or never run at all. Returns -1 for a stale ID.
+int kernel_get_overdue_releases(uint32_t taskId)
+{
+    Task snapshot;
+    if (kernel_read_task(taskId, &snapshot) != 0)
+    {
+        return -1;
+    }
+
+    TaskRuntime *runtime = task_runtime((int)TASK_HANDLE_SLOT(taskId));
+    LONG pending = runtime->pendingReleases;
+    uint64_t nowUs = timer_wheel_now_us();
+    int overdue = pending > JOB_RELEASE_QUEUE_DEPTH ? pending - JOB_RELEASE_QUEUE_DEPTH : 0;
+    for (LONG i = overdue; i < pending; i++)
+    {
+        ULONG index = (ULONG)(runtime->consumedCount + i) % JOB_RELEASE_QUEUE_DEPTH;
+        if (runtime->releaseTimes[index] + (uint64_t)snapshot.deadlineMs * 1000 < nowUs)
+        {
+            overdue++;
+        }
+    }
+    return overdue;
+}
+
+// Changes whenever a static schedule built from the task set goes stale
+LONG kernel_get_task_set_version(void)
+{
+    return g_taskSetVersion;
+}
+
+int kernel_get_task_slot_count(void)
+{
+    return g_hotTasks->count;
+}
+
+TaskHotTable *kernel_get_hot_tasks(void)
+{
+    return g_hotTasks;
+}
+
+// Hot-field setters write through to both the SoA table and the Task view.
+// Returns the previous active state, or -1 for a stale ID.
+int kernel_set_task_active(uint32_t taskId, uint8_t active)
+{
+    int previous = -1;
+
+    EnterCriticalSection(&g_taskTableLock);
+    Task *descriptor = kernel_task_write_begin(taskId);
+    if (descriptor)
+    {
+        previous = descriptor->active;
+        descriptor->active = active;
+        g_hotTasks->active[TASK_HANDLE_SLOT(taskId)] =
+            task_dispatchable(descriptor, task_runtime((int)TASK_HANDLE_SLOT(taskId)));
+        sched_log_task(descriptor);
+        kernel_task_write_end(taskId);
+    }
+    LeaveCriticalSection(&g_taskTableLock);
+
+    if (active && previous == 0)
+    {
+        kernel_wake_scheduler(); // A resumed task or a server with work may be dispatched now
+    }
+    return previous;
+}
+
+// Hold a task back from dispatch (or let it go again) without touching its
+// own active state, so a suspend or resume meanwhile is kept. Returns the
+// previous shed state, or -1 for a stale ID.
+int kernel_set_task_shed(uint32_t taskId, uint8_t shed)
+{
+    int previous = -1;
+
+    EnterCriticalSection(&g_taskTableLock);
+    Task *descriptor = kernel_task_write_begin(taskId);
+    if (descriptor)
+    {
+        TaskRuntime *runtime = task_runtime((int)TASK_HANDLE_SLOT(taskId));
+        previous = runtime->shed;
+        runtime->shed = shed;
+        g_hotTasks->active[TASK_HANDLE_SLOT(taskId)] = task_dispatchable(descriptor, runtime);
+        kernel_task_write_end(taskId);
+    }
+    LeaveCriticalSection(&g_taskTableLock);
+
+    return previous;
+}
+
+// Hold a task back from dispatch while a detached job of it still runs,
+// so its jobs never run concurrently. Returns the previous held state, or
+// -1 for a stale ID.
+int kernel_set_task_held(uint32_t taskId, uint8_t held)
+{
+    int previous = -1;
+
+    EnterCriticalSection(&g_taskTableLock);
+    Task *descriptor = kernel_task_write_begin(taskId);
+    if (descriptor)
+    {
+        TaskRuntime *runtime = task_runtime((int)TASK_HANDLE_SLOT(taskId));
+        previous = runtime->held;
+        runtime->held = held;
+        g_hotTasks->active[TASK_HANDLE_SLOT(taskId)] = task_dispatchable(descriptor, runtime);
+        kernel_task_write_end(taskId);
+    }
+    LeaveCriticalSection(&g_taskTableLock);
+
+    if (!held && previous == 1)
+    {
+        kernel_wake_scheduler(); // Its waiting releases may run now
+    }
+    return previous;
+}
+
+int kernel_set_task_priority(uint32_t taskId, uint32_t basePriority, uint32_t dynamicPriority)
+{
+    int result = -1;
+
+    EnterCriticalSection(&g_taskTableLock);
+    Task *descriptor = kernel_task_write_begin(taskId);
+    if (descriptor)
+    {
+        g_hotTasks->basePriority[TASK_HANDLE_SLOT(taskId)] = basePriority;
+        g_hotTasks->dynamicPriority[TASK_HANDLE_SLOT(taskId)] = dynamicPriority;
+        descriptor->basePriority = basePriority;
+        descriptor->dynamicPriority = dynamicPriority;
+        sched_log_task(descriptor);
+        kernel_task_write_end(taskId);
+        result = 0;
+    }
+    LeaveCriticalSection(&g_taskTableLock);
+
+    return result;
+}
+
+// Declared execution time; resets the history it seeds
+int kernel_set_task_execution_time(uint32_t taskId, uint32_t executionTimeMs)
+{
+    int result = -1;
+
+    EnterCriticalSection(&g_taskTableLock);
+    Task *descriptor = kernel_task_write_begin(taskId);
+    if (descriptor)
+    {
+        g_hotTasks->executionTimeMs[TASK_HANDLE_SLOT(taskId)] = executionTimeMs;
+        descriptor->executionTimeMs = executionTimeMs;
+        for (int i = 0; i < 10; i++)
+        {
+            descriptor->executionHistory[i] = (float)executionTimeMs;
+        }
+        sched_log_task(descriptor);
+        kernel_task_write_end(taskId);
+        InterlockedIncrement(&g_taskSetVersion);
+        result = 0;
+    }
+    LeaveCriticalSection(&g_taskTableLock);
+
+    return result;
+}
+
+// Stop the task's release timer; its jobs now come from kernel_release_task
+int kernel_set_task_sporadic(uint32_t taskId)
+{
+    int result = -1;
+
+    EnterCriticalSection(&g_taskTableLock);
+    Task *descriptor = kernel_task_write_begin(taskId);
+    if (descriptor)
+    {
+        descriptor->sporadic = 1;
+        sched_log_task(descriptor);
+        kernel_task_write_end(taskId);
+        timer_wheel_cancel(&task_runtime((int)TASK_HANDLE_SLOT(taskId))->releaseTimer);
+        InterlockedIncrement(&g_taskSetVersion);
+        result = 0;
+    }
+    LeaveCriticalSection(&g_taskTableLock);
+
+    return result;
+}
+
+// Let a task be dispatched without a pending release (or gate it again).
+// For tasks that gate themselves, like reservation servers, which are
+// active only while they have work. Returns 0, or -1 for a stale ID.
+int kernel_set_task_release_gated(uint32_t taskId, uint8_t gated)
+{
+    int result = -1;
+
+    EnterCriticalSection(&g_taskTableLock);
+    Task *descriptor = kernel_task_write_begin(taskId);
+    if (descriptor)
+    {
+        TaskRuntime *runtime = task_runtime((int)TASK_HANDLE_SLOT(taskId));
+        runtime->gated = gated != 0;
+        g_hotTasks->active[TASK_HANDLE_SLOT(taskId)] = task_dispatchable(descriptor, runtime);
+        kernel_task_write_end(taskId);
+        result = 0;
+    }
+    LeaveCriticalSection(&g_taskTableLock);
+
+    return result;
+}
+
+// Whether the policies have any task to pick from right now
+int kernel_has_dispatchable_task(void)
+{
+    TaskHotTable *hot = g_hotTasks;
+    int count = hot->count;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (hot->active[i])
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Release one job of a task now, as its release timer would
+int kernel_release_task(uint32_t taskId)
+{
+    Task snapshot;
+    if (kernel_read_task(taskId, &snapshot) != 0)
+    {
+        return -1;
+    }
+
+    task_release_callback(task_runtime((int)TASK_HANDLE_SLOT(taskId)));
+    return 0;
 }
 
 int kernel_get_running(void)
@@ -174,6 +1069,8 @@ int kernel_get_running(void)
     return g_running;
 }
 
+// Scheduler decisions so far. Tickless, idle time adds none, so this is no
+// longer a time base; use timer_wheel_now_us for time.
 uint64_t kernel_get_tick_count(void)
 {
     return g_tickCount;
@@ -183,3 +1080,42 @@ void kernel_increment_tick(void)
 {
     g_tickCount++;
 }
+
+// Choose between waking the scheduler every SCHEDULER_PERIOD_MS and waking
+// it only for the next instant it programs and for events: releases,
+// resumes and servers getting work. Admission control analyzes tasks for
+// the mode they were created in, so the mode is chosen before any task
+// exists. Returns 0, or -1 once a task exists or the kernel runs.
+int kernel_set_tickless(uint8_t enabled)
+{
+    if (g_running || g_hotTasks->count > 0)
+    {
+        printf("Error: Tickless mode must be chosen before tasks are created\n");
+        return -1;
+    }
+
+    g_tickless = enabled != 0;
+    if (g_tickless)
+    {
+        printf("Scheduler: Tickless, waking for the next event only\n");
+    }
+    else
+    {
+        printf("Scheduler: Ticked every %d ms\n", SCHEDULER_PERIOD_MS);
+    }
+    return 0;
+}
+
+int kernel_is_tickless(void)
+{
+    return g_tickless;
+}
+
+// Tickless mode: something the scheduler may act on happened
+void kernel_wake_scheduler(void)
+{
+    if (g_tickless && g_schedulerTickEvent)
+    {
+        SetEvent(g_schedulerTickEvent);
+    }
+}
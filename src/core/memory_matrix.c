@@ -1,16 +1,77 @@
 #include "../../include/memory_matrix.h"
 #include "../../include/system_config.h"
+#include "../../include/checkpoint.h"
+#include "../../include/scrubber.h"
+#include "../../include/task_manager.h"
+#include "../../include/trace.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <windows.h>
 
+// Region lock with priority-inversion control
+typedef struct
+{
+    CRITICAL_SECTION cs;    // The region lock itself
+    CRITICAL_SECTION guard; // Protects the owner bookkeeping below, held only briefly
+    MemoryLockProtocol protocol;
+    MemoryLockProtocol ownerProtocol; // Protocol the current owner acquired under
+    int ceilingPriority;
+    DWORD ownerThreadId;
+    int ownerBasePriority;
+    int ownerBoosted;
+    LONG depth;
+    MemoryLockStats stats;
+} RegionLock;
+
+#if MEMORY_PROFILER_ENABLED
+// Per-thread profile; only the owning thread writes it, readers tolerate torn counters
+#define MM_PROFILE_HOLDER_SLOTS 8
+
+typedef struct
+{
+    uint64_t acquisitions;
+    uint64_t contendedAcquisitions;
+    uint64_t totalWaitNs;
+    uint64_t totalHoldNs;
+    uint64_t waitHistogram[MM_HISTOGRAM_BUCKETS];
+    uint64_t holdHistogram[MM_HISTOGRAM_BUCKETS];
+    MemoryLockHolder holders[MM_PROFILE_HOLDER_SLOTS];
+    LARGE_INTEGER acquiredAt;
+} RegionThreadProfile;
+
+typedef struct
+{
+    DWORD threadId;
+    uint32_t taskId;
+    RegionThreadProfile regions[SHM_COUNT];
+} ThreadLockProfile;
+
+static ThreadLockProfile *volatile g_threadProfiles[MEMORY_PROFILER_MAX_THREADS] = {NULL};
+static volatile LONG g_threadProfileCount = 0;
+static DWORD g_profileTlsIndex = TLS_OUT_OF_INDEXES;
+static uint64_t g_lastProfileDumpMs = 0;
+#endif
+
 // Shared memory regions
 static void *g_sharedMemory[SHM_COUNT] = {NULL};
 static size_t g_regionSizes[SHM_COUNT] = {0};
-static CRITICAL_SECTION g_regionLocks[SHM_COUNT];
+static RegionLock g_regionLocks[SHM_COUNT];
 static int g_initialized = 0;
+static LARGE_INTEGER g_lockFrequency;
+
+// TMR shadow copies; the primary is g_sharedMemory. A region locked for
+// direct pointer access is resynced from the primary when it is unlocked.
+static void *g_regionReplicas[SHM_COUNT][2] = {{NULL}};
+static int g_regionPointerDirty[SHM_COUNT] = {0};
+static MemoryTmrStats g_tmrStats[SHM_COUNT];
+
+// Checkpoint area backing each region, CHECKPOINT_NO_AREA if it fell back to malloc
+static int g_regionCheckpoints[SHM_COUNT] = {CHECKPOINT_NO_AREA};
+
+// Scrubber area of each region; 0 if unprotected. Checksums change only under the region lock.
+static int g_regionScrubAreas[SHM_COUNT] = {0};
 
 // Define default sizes for memory regions
 static const size_t DEFAULT_SIZES[SHM_COUNT] = {
@@ -22,6 +83,397 @@ static const size_t DEFAULT_SIZES[SHM_COUNT] = {
     16384 // SHM_USER_DATA
 };
 
+// Define default lock protocols; regions shared with the scheduler and
+// fault paths inherit priority so a DAL_D holder cannot stall a DAL_A waiter
+static const MemoryLockProtocol DEFAULT_PROTOCOLS[SHM_COUNT] = {
+    MM_LOCK_PRIO_INHERIT, // SHM_SYSTEM_STATE
+    MM_LOCK_PRIO_INHERIT, // SHM_TASK_DESCRIPTORS
+    MM_LOCK_PRIO_INHERIT, // SHM_SCHEDULER_DECISIONS
+    MM_LOCK_PRIO_INHERIT, // SHM_FAULT_REPORTS
+    MM_LOCK_PLAIN,        // SHM_ML_DATA
+    MM_LOCK_PLAIN         // SHM_USER_DATA
+};
+
+// Regions replicated for TMR voting: the small, safety-relevant ones
+static const int DEFAULT_TMR[SHM_COUNT] = {
+    1, // SHM_SYSTEM_STATE
+    1, // SHM_TASK_DESCRIPTORS
+    1, // SHM_SCHEDULER_DECISIONS
+    1, // SHM_FAULT_REPORTS
+    0, // SHM_ML_DATA
+    0  // SHM_USER_DATA
+};
+
+static uint64_t lock_elapsed_ns(LARGE_INTEGER start, LARGE_INTEGER end)
+{
+    return (uint64_t)(end.QuadPart - start.QuadPart) * 1000000000ULL / (uint64_t)g_lockFrequency.QuadPart;
+}
+
+#if MEMORY_PROFILER_ENABLED
+static int histogram_bucket(uint64_t ns)
+{
+    int bucket = 0;
+    while (ns > 1 && bucket < MM_HISTOGRAM_BUCKETS - 1)
+    {
+        ns >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+// Look up (or lazily register) the calling thread's profile
+static ThreadLockProfile *profile_for_thread(void)
+{
+    ThreadLockProfile *profile = (ThreadLockProfile *)TlsGetValue(g_profileTlsIndex);
+    if (profile)
+    {
+        return profile;
+    }
+
+    LONG slot = InterlockedIncrement(&g_threadProfileCount) - 1;
+    if (slot >= MEMORY_PROFILER_MAX_THREADS)
+    {
+        // Out of slots: this thread goes unprofiled
+        InterlockedDecrement(&g_threadProfileCount);
+        return NULL;
+    }
+
+    profile = (ThreadLockProfile *)calloc(1, sizeof(ThreadLockProfile));
+    if (!profile)
+    {
+        return NULL;
+    }
+    profile->threadId = GetCurrentThreadId();
+    profile->taskId = MM_NO_TASK;
+    for (int r = 0; r < SHM_COUNT; r++)
+    {
+        for (int h = 0; h < MM_PROFILE_HOLDER_SLOTS; h++)
+        {
+            profile->regions[r].holders[h].taskId = MM_NO_TASK;
+        }
+    }
+
+    TlsSetValue(g_profileTlsIndex, profile);
+    g_threadProfiles[slot] = profile;
+    return profile;
+}
+
+// Charge a completed hold to the task the thread is running for
+static void profile_record_holder(RegionThreadProfile *regionProfile, uint32_t taskId, uint64_t holdNs)
+{
+    MemoryLockHolder *victim = &regionProfile->holders[0];
+
+    for (int h = 0; h < MM_PROFILE_HOLDER_SLOTS; h++)
+    {
+        MemoryLockHolder *holder = &regionProfile->holders[h];
+        if (holder->taskId == taskId)
+        {
+            holder->acquisitions++;
+            holder->holdNs += holdNs;
+            return;
+        }
+        if (holder->holdNs < victim->holdNs)
+        {
+            victim = holder;
+        }
+    }
+
+    // Evict the lightest holder; heavy holders stay resident
+    victim->taskId = taskId;
+    victim->acquisitions = 1;
+    victim->holdNs = holdNs;
+}
+
+static void profile_on_acquire(SharedMemoryRegion region, uint64_t waitNs, int contended)
+{
+    ThreadLockProfile *profile = profile_for_thread();
+    if (!profile)
+    {
+        return;
+    }
+
+    RegionThreadProfile *regionProfile = &profile->regions[region];
+    regionProfile->acquisitions++;
+    if (contended)
+    {
+        regionProfile->contendedAcquisitions++;
+        regionProfile->totalWaitNs += waitNs;
+        regionProfile->waitHistogram[histogram_bucket(waitNs)]++;
+    }
+    QueryPerformanceCounter(&regionProfile->acquiredAt);
+}
+
+static void profile_on_release(SharedMemoryRegion region)
+{
+    ThreadLockProfile *profile = (ThreadLockProfile *)TlsGetValue(g_profileTlsIndex);
+    if (!profile)
+    {
+        return;
+    }
+
+    RegionThreadProfile *regionProfile = &profile->regions[region];
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    uint64_t holdNs = lock_elapsed_ns(regionProfile->acquiredAt, now);
+
+    regionProfile->totalHoldNs += holdNs;
+    regionProfile->holdHistogram[histogram_bucket(holdNs)]++;
+    profile_record_holder(regionProfile, profile->taskId, holdNs);
+}
+
+static void profile_accumulate(MemoryLockProfile *out, const RegionThreadProfile *in,
+                               MemoryLockHolder *holders, int *holderCount)
+{
+    out->acquisitions += in->acquisitions;
+    out->contendedAcquisitions += in->contendedAcquisitions;
+    out->totalWaitNs += in->totalWaitNs;
+    out->totalHoldNs += in->totalHoldNs;
+    for (int b = 0; b < MM_HISTOGRAM_BUCKETS; b++)
+    {
+        out->waitHistogram[b] += in->waitHistogram[b];
+        out->holdHistogram[b] += in->holdHistogram[b];
+    }
+
+    // Merge holder tables by task ID
+    for (int h = 0; h < MM_PROFILE_HOLDER_SLOTS; h++)
+    {
+        const MemoryLockHolder *holder = &in->holders[h];
+        if (holder->acquisitions == 0)
+        {
+            continue;
+        }
+
+        int merged = 0;
+        for (int j = 0; j < *holderCount; j++)
+        {
+            if (holders[j].taskId == holder->taskId)
+            {
+                holders[j].acquisitions += holder->acquisitions;
+                holders[j].holdNs += holder->holdNs;
+                merged = 1;
+                break;
+            }
+        }
+        if (!merged)
+        {
+            holders[(*holderCount)++] = *holder;
+        }
+    }
+}
+
+static void profile_select_top_holders(MemoryLockProfile *out, MemoryLockHolder *holders, int holderCount)
+{
+    for (int t = 0; t < MM_TOP_HOLDERS; t++)
+    {
+        int best = -1;
+        for (int j = 0; j < holderCount; j++)
+        {
+            if (holders[j].acquisitions > 0 && (best < 0 || holders[j].holdNs > holders[best].holdNs))
+            {
+                best = j;
+            }
+        }
+
+        if (best < 0)
+        {
+            out->topHolders[t].taskId = MM_NO_TASK;
+            out->topHolders[t].acquisitions = 0;
+            out->topHolders[t].holdNs = 0;
+            continue;
+        }
+        out->topHolders[t] = holders[best];
+        holders[best].acquisitions = 0;
+    }
+}
+#endif
+
+// Boost the current owner to the waiter's priority (priority inheritance)
+static void region_inherit_priority(RegionLock *lock)
+{
+    int waiterPriority = GetThreadPriority(GetCurrentThread());
+
+    EnterCriticalSection(&lock->guard);
+    if (lock->ownerThreadId != 0 && lock->ownerThreadId != GetCurrentThreadId())
+    {
+        HANDLE owner = OpenThread(THREAD_SET_INFORMATION | THREAD_QUERY_INFORMATION, FALSE, lock->ownerThreadId);
+        if (owner != NULL)
+        {
+            int ownerPriority = GetThreadPriority(owner);
+            if (ownerPriority != THREAD_PRIORITY_ERROR_RETURN && waiterPriority > ownerPriority)
+            {
+                if (!lock->ownerBoosted)
+                {
+                    lock->ownerBasePriority = ownerPriority;
+                    lock->ownerBoosted = 1;
+                }
+                SetThreadPriority(owner, waiterPriority);
+                lock->stats.priorityBoosts++;
+            }
+            CloseHandle(owner);
+        }
+    }
+    LeaveCriticalSection(&lock->guard);
+}
+
+static void region_acquire(SharedMemoryRegion region)
+{
+    RegionLock *lock = &g_regionLocks[region];
+    MemoryLockProtocol protocol = lock->protocol;
+    int previousPriority = 0;
+
+    // Immediate ceiling protocol: raise before contending for the lock
+    if (protocol == MM_LOCK_PRIO_CEILING)
+    {
+        previousPriority = GetThreadPriority(GetCurrentThread());
+        if (lock->ceilingPriority > previousPriority)
+        {
+            SetThreadPriority(GetCurrentThread(), lock->ceilingPriority);
+        }
+    }
+
+    uint64_t blockedNs = 0;
+    int contended = 0;
+    if (!TryEnterCriticalSection(&lock->cs))
+    {
+        contended = 1;
+        LARGE_INTEGER start, end;
+        QueryPerformanceCounter(&start);
+
+        if (protocol == MM_LOCK_PRIO_INHERIT)
+        {
+            region_inherit_priority(lock);
+        }
+        EnterCriticalSection(&lock->cs);
+
+        QueryPerformanceCounter(&end);
+        blockedNs = lock_elapsed_ns(start, end);
+    }
+
+    // Owner bookkeeping is only recorded for the outermost acquisition
+    if (lock->depth++ == 0)
+    {
+        lock->ownerProtocol = protocol;
+        if (protocol == MM_LOCK_PRIO_INHERIT)
+        {
+            EnterCriticalSection(&lock->guard);
+            lock->ownerThreadId = GetCurrentThreadId();
+            lock->ownerBoosted = 0;
+            LeaveCriticalSection(&lock->guard);
+        }
+        else
+        {
+            lock->ownerThreadId = GetCurrentThreadId();
+            lock->ownerBasePriority = previousPriority;
+        }
+    }
+
+
+    // Stats are only touched by the owner, so no extra locking is needed
+    lock->stats.acquisitions++;
+    if (blockedNs > 0)
+    {
+        lock->stats.blockedAcquisitions++;
+        lock->stats.totalBlockingNs += blockedNs;
+        if (blockedNs > lock->stats.maxBlockingNs)
+        {
+            lock->stats.maxBlockingNs = blockedNs;
+        }
+    }
+
+#if MEMORY_PROFILER_ENABLED
+    if (lock->depth == 1)
+    {
+        profile_on_acquire(region, blockedNs, contended);
+    }
+#else
+    (void)contended;
+#endif
+}
+
+static void region_release(SharedMemoryRegion region)
+{
+    RegionLock *lock = &g_regionLocks[region];
+
+    if (--lock->depth > 0)
+    {
+        LeaveCriticalSection(&lock->cs);
+        return;
+    }
+
+#if MEMORY_PROFILER_ENABLED
+    profile_on_release(region);
+#endif
+
+    if (lock->ownerProtocol == MM_LOCK_PRIO_INHERIT)
+    {
+        // Drop any inherited priority before handing the lock on
+        EnterCriticalSection(&lock->guard);
+        if (lock->ownerBoosted)
+        {
+            SetThreadPriority(GetCurrentThread(), lock->ownerBasePriority);
+            lock->ownerBoosted = 0;
+        }
+        lock->ownerThreadId = 0;
+        LeaveCriticalSection(&lock->guard);
+        LeaveCriticalSection(&lock->cs);
+    }
+    else if (lock->ownerProtocol == MM_LOCK_PRIO_CEILING)
+    {
+        // Restore only after leaving so the holder is never preempted at base priority
+        int basePriority = lock->ownerBasePriority;
+        lock->ownerThreadId = 0;
+        LeaveCriticalSection(&lock->cs);
+        SetThreadPriority(GetCurrentThread(), basePriority);
+    }
+    else
+    {
+        lock->ownerThreadId = 0;
+        LeaveCriticalSection(&lock->cs);
+    }
+}
+
+// Scrubber callbacks: checksums are read and refreshed under the region lock
+static void scrub_lock_region(void *arg)
+{
+    region_acquire((SharedMemoryRegion)(intptr_t)arg);
+}
+
+static void scrub_unlock_region(void *arg)
+{
+    region_release((SharedMemoryRegion)(intptr_t)arg);
+}
+
+// Checkpoint callbacks, called with the region lock held. A written page
+// is only checkpointed if its scrub checksums still hold; otherwise the
+// checkpoint would preserve the corruption the rollback has to undo.
+static int checkpoint_verify_page(void *arg, size_t offset, size_t size)
+{
+    SharedMemoryRegion region = (SharedMemoryRegion)(intptr_t)arg;
+    return scrubber_verify_range(g_regionScrubAreas[region], offset, size) > 0 ? -1 : 0;
+}
+
+// A restored page: replicas and checksums follow it, and only it
+static int checkpoint_page_restored(void *arg, size_t offset, size_t size)
+{
+    SharedMemoryRegion region = (SharedMemoryRegion)(intptr_t)arg;
+    if (offset >= g_regionSizes[region])
+    {
+        return 0; // Page rounding past the region's end
+    }
+    if (size > g_regionSizes[region] - offset)
+    {
+        size = g_regionSizes[region] - offset;
+    }
+
+    if (g_regionReplicas[region][0])
+    {
+        memcpy((uint8_t *)g_regionReplicas[region][0] + offset, (uint8_t *)g_sharedMemory[region] + offset, size);
+        memcpy((uint8_t *)g_regionReplicas[region][1] + offset, (uint8_t *)g_sharedMemory[region] + offset, size);
+    }
+    scrubber_update(g_regionScrubAreas[region], offset, size);
+    return 0;
+}
+
 void memory_matrix_init(void)
 {
     if (g_initialized)
@@ -30,15 +482,45 @@ void memory_matrix_init(void)
     }
 
     printf("Initializing memory matrix...\n");
+    QueryPerformanceFrequency(&g_lockFrequency);
+
+#if MEMORY_PROFILER_ENABLED
+    g_profileTlsIndex = TlsAlloc();
+    if (g_profileTlsIndex == TLS_OUT_OF_INDEXES)
+    {
+        printf("Error: Failed to allocate lock profiler TLS slot\n");
+        exit(1);
+    }
+    g_lastProfileDumpMs = GetTickCount64();
+#endif
 
     // Initialize critical sections for each region
     for (int i = 0; i < SHM_COUNT; i++)
     {
-        InitializeCriticalSection(&g_regionLocks[i]);
+        InitializeCriticalSection(&g_regionLocks[i].cs);
+        InitializeCriticalSection(&g_regionLocks[i].guard);
+        g_regionLocks[i].protocol = DEFAULT_PROTOCOLS[i];
+        g_regionLocks[i].ownerProtocol = DEFAULT_PROTOCOLS[i];
+        g_regionLocks[i].ceilingPriority = THREAD_PRIORITY_TIME_CRITICAL;
+        g_regionLocks[i].ownerThreadId = 0;
+        g_regionLocks[i].ownerBoosted = 0;
+        g_regionLocks[i].depth = 0;
+        memset(&g_regionLocks[i].stats, 0, sizeof(MemoryLockStats));
 
-        // Allocate memory for each region
+        // Allocate memory for each region, write-tracked for incremental checkpoints
         g_regionSizes[i] = DEFAULT_SIZES[i];
+#if CHECKPOINT_ENABLED
+        char areaName[16];
+        snprintf(areaName, sizeof(areaName), "region%d", i);
+        g_regionCheckpoints[i] = checkpoint_create(g_regionSizes[i], areaName, &g_sharedMemory[i]);
+        if (g_regionCheckpoints[i] < 0)
+        {
+            g_regionCheckpoints[i] = CHECKPOINT_NO_AREA;
+            g_sharedMemory[i] = malloc(g_regionSizes[i]);
+        }
+#else
         g_sharedMemory[i] = malloc(g_regionSizes[i]);
+#endif
 
         if (!g_sharedMemory[i])
         {
@@ -52,6 +534,29 @@ void memory_matrix_init(void)
     }
 
     g_initialized = 1;
+
+#if TMR_ENABLED
+    for (int i = 0; i < SHM_COUNT; i++)
+    {
+        if (DEFAULT_TMR[i])
+        {
+            memory_matrix_enable_tmr((SharedMemoryRegion)i, 1);
+        }
+    }
+#endif
+
+#if SCRUB_ENABLED
+    // Region faults belong to no task; the address names region and offset
+    for (int i = 0; i < SHM_COUNT; i++)
+    {
+        char areaName[16];
+        snprintf(areaName, sizeof(areaName), "region%d", i);
+        g_regionScrubAreas[i] = scrubber_protect(areaName, g_sharedMemory[i], g_regionSizes[i], TASK_INVALID_ID,
+                                                 MM_FAULT_ADDRESS(i, 0), scrub_lock_region, scrub_unlock_region,
+                                                 (void *)(intptr_t)i);
+    }
+#endif
+
     printf("Memory matrix initialized\n");
 }
 
@@ -78,9 +583,15 @@ int memory_matrix_write(SharedMemoryRegion region, void *data, size_t size)
         return -2;
     }
 
-    EnterCriticalSection(&g_regionLocks[region]);
+    region_acquire(region);
     memcpy(g_sharedMemory[region], data, size);
-    LeaveCriticalSection(&g_regionLocks[region]);
+    if (g_regionReplicas[region][0])
+    {
+        memcpy(g_regionReplicas[region][0], data, size);
+        memcpy(g_regionReplicas[region][1], data, size);
+    }
+    scrubber_update(g_regionScrubAreas[region], 0, size);
+    region_release(region);
 
     return 0; // Success
 }
@@ -98,9 +609,9 @@ int memory_matrix_read(SharedMemoryRegion region, void *buffer, size_t size)
         return -2;
     }
 
-    EnterCriticalSection(&g_regionLocks[region]);
+    region_acquire(region);
     memcpy(buffer, g_sharedMemory[region], size);
-    LeaveCriticalSection(&g_regionLocks[region]);
+    region_release(region);
 
     return 0; // Success
 }
@@ -112,7 +623,8 @@ int memory_matrix_lock(SharedMemoryRegion region)
         return -1;
     }
 
-    EnterCriticalSection(&g_regionLocks[region]);
+    region_acquire(region);
+    g_regionPointerDirty[region] = 1; // The holder may write through the region pointer
     return 0; // Success
 }
 
@@ -123,7 +635,19 @@ int memory_matrix_unlock(SharedMemoryRegion region)
         return -1;
     }
 
-    LeaveCriticalSection(&g_regionLocks[region]);
+    // Outermost unlock: bring the replicas in line with direct writes
+    if (g_regionLocks[region].depth == 1 && g_regionPointerDirty[region])
+    {
+        if (g_regionReplicas[region][0])
+        {
+            memcpy(g_regionReplicas[region][0], g_sharedMemory[region], g_regionSizes[region]);
+            memcpy(g_regionReplicas[region][1], g_sharedMemory[region], g_regionSizes[region]);
+        }
+        scrubber_update(g_regionScrubAreas[region], 0, g_regionSizes[region]);
+        g_regionPointerDirty[region] = 0;
+    }
+
+    region_release(region);
     return 0; // Success
 }
 
@@ -133,16 +657,366 @@ void memory_matrix_barrier(void)
     // Lock all regions, then unlock them
     for (int i = 0; i < SHM_COUNT; i++)
     {
-        EnterCriticalSection(&g_regionLocks[i]);
+        region_acquire((SharedMemoryRegion)i);
     }
 
     // Memory barrier (in a real system this would ensure coherence)
     MemoryBarrier();
 
-    for (int i = 0; i < SHM_COUNT; i++)
+    for (int i = SHM_COUNT - 1; i >= 0; i--)
     {
-        LeaveCriticalSection(&g_regionLocks[i]);
+        region_release((SharedMemoryRegion)i);
     }
 
     printf("Memory matrix barrier completed\n");
 }
+
+int memory_matrix_set_lock_protocol(SharedMemoryRegion region, MemoryLockProtocol protocol, int ceilingPriority)
+{
+    if (region >= SHM_COUNT || !g_initialized)
+    {
+        return -1;
+    }
+
+    // Switching protocol under a nested hold would unbalance the priority restore
+    region_acquire(region);
+    if (g_regionLocks[region].depth > 1)
+    {
+        region_release(region);
+        return -2;
+    }
+    g_regionLocks[region].ceilingPriority = ceilingPriority;
+    g_regionLocks[region].protocol = protocol;
+    region_release(region);
+
+    printf("Memory region %d lock protocol set to %d\n", region, protocol);
+    return 0; // Success
+}
+
+int memory_matrix_get_lock_stats(SharedMemoryRegion region, MemoryLockStats *stats)
+{
+    if (region >= SHM_COUNT || !g_initialized || !stats)
+    {
+        return -1;
+    }
+
+    region_acquire(region);
+    *stats = g_regionLocks[region].stats;
+    region_release(region);
+
+    // Exclude the acquisition made by this query
+    stats->acquisitions--;
+    return 0; // Success
+}
+
+void memory_matrix_reset_lock_stats(void)
+{
+    for (int i = 0; i < SHM_COUNT; i++)
+    {
+        region_acquire((SharedMemoryRegion)i);
+        memset(&g_regionLocks[i].stats, 0, sizeof(MemoryLockStats));
+        region_release((SharedMemoryRegion)i);
+    }
+}
+
+void memory_matrix_set_holder_task(uint32_t taskId)
+{
+#if MEMORY_PROFILER_ENABLED
+    ThreadLockProfile *profile = g_initialized ? profile_for_thread() : NULL;
+    if (profile)
+    {
+        profile->taskId = taskId;
+    }
+#else
+    (void)taskId;
+#endif
+}
+
+int memory_matrix_get_profile(SharedMemoryRegion region, MemoryLockProfile *profile)
+{
+    if (region >= SHM_COUNT || !g_initialized || !profile)
+    {
+        return -1;
+    }
+
+    memset(profile, 0, sizeof(MemoryLockProfile));
+
+#if MEMORY_PROFILER_ENABLED
+    MemoryLockHolder holders[MEMORY_PROFILER_MAX_THREADS * MM_PROFILE_HOLDER_SLOTS];
+    int holderCount = 0;
+    LONG threadCount = g_threadProfileCount;
+
+    for (LONG t = 0; t < threadCount && t < MEMORY_PROFILER_MAX_THREADS; t++)
+    {
+        ThreadLockProfile *threadProfile = g_threadProfiles[t];
+        if (threadProfile)
+        {
+            profile_accumulate(profile, &threadProfile->regions[region], holders, &holderCount);
+        }
+    }
+    profile_select_top_holders(profile, holders, holderCount);
+    return 0; // Success
+#else
+    return -2; // Profiling compiled out
+#endif
+}
+
+int memory_matrix_get_thread_profile(uint32_t threadSlot, SharedMemoryRegion region,
+                                     MemoryLockProfile *profile, uint32_t *threadId)
+{
+    if (region >= SHM_COUNT || !g_initialized || !profile)
+    {
+        return -1;
+    }
+
+#if MEMORY_PROFILER_ENABLED
+    if (threadSlot >= MEMORY_PROFILER_MAX_THREADS || !g_threadProfiles[threadSlot])
+    {
+        return -1;
+    }
+
+    MemoryLockHolder holders[MM_PROFILE_HOLDER_SLOTS];
+    int holderCount = 0;
+    ThreadLockProfile *threadProfile = g_threadProfiles[threadSlot];
+
+    memset(profile, 0, sizeof(MemoryLockProfile));
+    profile_accumulate(profile, &threadProfile->regions[region], holders, &holderCount);
+    profile_select_top_holders(profile, holders, holderCount);
+    if (threadId)
+    {
+        *threadId = threadProfile->threadId;
+    }
+    return 0; // Success
+#else
+    (void)threadSlot;
+    (void)threadId;
+    return -2; // Profiling compiled out
+#endif
+}
+
+void memory_matrix_profile_dump(void)
+{
+    printf("\nMemory Matrix Lock Profile:\n");
+
+    for (int i = 0; i < SHM_COUNT; i++)
+    {
+        MemoryLockProfile profile;
+        if (memory_matrix_get_profile((SharedMemoryRegion)i, &profile) != 0 || profile.acquisitions == 0)
+        {
+            continue;
+        }
+
+        printf("  Region %d: %llu acquisitions, %llu contended (%.1f%%), avg wait %llu ns, avg hold %llu ns\n",
+               i,
+               (unsigned long long)profile.acquisitions,
+               (unsigned long long)profile.contendedAcquisitions,
+               100.0 * (double)profile.contendedAcquisitions / (double)profile.acquisitions,
+               (unsigned long long)(profile.contendedAcquisitions ? profile.totalWaitNs / profile.contendedAcquisitions : 0),
+               (unsigned long long)(profile.totalHoldNs / profile.acquisitions));
+
+        // Upper bound of the highest occupied bucket is a cheap worst-case estimate
+        int worstWait = -1, worstHold = -1;
+        for (int b = 0; b < MM_HISTOGRAM_BUCKETS; b++)
+        {
+            if (profile.waitHistogram[b])
+                worstWait = b;
+            if (profile.holdHistogram[b])
+                worstHold = b;
+        }
+        printf("    Worst wait < %llu ns, worst hold < %llu ns\n",
+               worstWait < 0 ? 0ULL : 1ULL << (worstWait + 1),
+               worstHold < 0 ? 0ULL : 1ULL << (worstHold + 1));
+
+        for (int t = 0; t < MM_TOP_HOLDERS && profile.topHolders[t].acquisitions > 0; t++)
+        {
+            if (profile.topHolders[t].taskId == MM_NO_TASK)
+            {
+                printf("    Holder <system>: %llu holds, %llu ns\n",
+                       (unsigned long long)profile.topHolders[t].acquisitions,
+                       (unsigned long long)profile.topHolders[t].holdNs);
+            }
+            else
+            {
+                printf("    Holder task %u: %llu holds, %llu ns\n",
+                       profile.topHolders[t].taskId,
+                       (unsigned long long)profile.topHolders[t].acquisitions,
+                       (unsigned long long)profile.topHolders[t].holdNs);
+            }
+        }
+    }
+}
+
+void memory_matrix_profile_tick(void)
+{
+#if MEMORY_PROFILER_ENABLED
+    uint64_t now = GetTickCount64();
+    if (g_initialized && now - g_lastProfileDumpMs >= MEMORY_PROFILER_DUMP_PERIOD_MS)
+    {
+        g_lastProfileDumpMs = now;
+        memory_matrix_profile_dump();
+    }
+#endif
+}
+
+// Add or drop the two shadow copies of a region
+int memory_matrix_enable_tmr(SharedMemoryRegion region, int enabled)
+{
+    if (region >= SHM_COUNT || !g_initialized)
+    {
+        return -1;
+    }
+
+    region_acquire(region);
+    if (enabled && !g_regionReplicas[region][0])
+    {
+        void *first = malloc(g_regionSizes[region]);
+        void *second = malloc(g_regionSizes[region]);
+        if (!first || !second)
+        {
+            free(first);
+            free(second);
+            region_release(region);
+            return -1;
+        }
+        memcpy(first, g_sharedMemory[region], g_regionSizes[region]);
+        memcpy(second, g_sharedMemory[region], g_regionSizes[region]);
+        g_regionReplicas[region][0] = first;
+        g_regionReplicas[region][1] = second;
+        memset(&g_tmrStats[region], 0, sizeof(MemoryTmrStats));
+    }
+    else if (!enabled && g_regionReplicas[region][0])
+    {
+        free(g_regionReplicas[region][0]);
+        free(g_regionReplicas[region][1]);
+        g_regionReplicas[region][0] = NULL;
+        g_regionReplicas[region][1] = NULL;
+    }
+    region_release(region);
+
+    return 0; // Success
+}
+
+// Vote a replicated region and repair the minority copy in place.
+// Returns the number of disagreeing words, or -1 if the region has no replicas.
+int memory_matrix_tmr_vote(SharedMemoryRegion region, TmrVoteReport *report)
+{
+    TmrVoteReport local;
+    if (!report)
+    {
+        report = &local;
+    }
+    if (region >= SHM_COUNT || !g_initialized)
+    {
+        return -1;
+    }
+
+    region_acquire(region);
+    if (!g_regionReplicas[region][0])
+    {
+        region_release(region);
+        return -1;
+    }
+
+    size_t mismatched = tmr_vote_buffers(g_sharedMemory[region], g_regionReplicas[region][0],
+                                         g_regionReplicas[region][1], g_regionSizes[region],
+                                         NULL, TMR_VOTE_CORRECT, report);
+
+    MemoryTmrStats *stats = &g_tmrStats[region];
+    stats->votes++;
+    stats->mismatchedWords += mismatched;
+    stats->correctedBits += report->minorityBits[0] + report->minorityBits[1] + report->minorityBits[2];
+    region_release(region);
+
+    return (int)mismatched;
+}
+
+// Vote every replicated region; called once per voting period
+size_t memory_matrix_tmr_vote_all(void)
+{
+    size_t total = 0;
+
+    for (int i = 0; i < SHM_COUNT; i++)
+    {
+        TmrVoteReport report;
+        int mismatched = memory_matrix_tmr_vote((SharedMemoryRegion)i, &report);
+        if (mismatched > 0)
+        {
+            TRACE(TRACE_MM_TMR_CORRECTED, i, mismatched, report.locations[0].offset, report.locations[0].minorityMask);
+            total += (size_t)mismatched;
+        }
+    }
+
+    return total;
+}
+
+int memory_matrix_get_tmr_stats(SharedMemoryRegion region, MemoryTmrStats *stats)
+{
+    if (region >= SHM_COUNT || !g_initialized || !stats)
+    {
+        return -1;
+    }
+
+    region_acquire(region);
+    *stats = g_tmrStats[region];
+    region_release(region);
+
+    return 0; // Success
+}
+
+// Checkpoint every region under its lock, so each image is a consistent
+// snapshot of that region. A region with a page failing its scrub check is
+// skipped and keeps its last good image. Returns the number of pages copied.
+int memory_matrix_checkpoint_all(void)
+{
+    int pages = 0;
+
+    if (!g_initialized)
+    {
+        return 0;
+    }
+
+    for (int i = 0; i < SHM_COUNT; i++)
+    {
+        if (g_regionCheckpoints[i] == CHECKPOINT_NO_AREA)
+        {
+            continue;
+        }
+        region_acquire((SharedMemoryRegion)i);
+        int copied = checkpoint_take(g_regionCheckpoints[i], checkpoint_verify_page, (void *)(intptr_t)i);
+        region_release((SharedMemoryRegion)i);
+        pages += copied > 0 ? copied : 0;
+    }
+
+    return pages;
+}
+
+// Restore a region to its last checkpoint; TMR replicas follow the restored
+// primary. Returns the number of pages restored, or -1 without a checkpoint.
+int memory_matrix_rollback(SharedMemoryRegion region)
+{
+    if (region >= SHM_COUNT || !g_initialized || g_regionCheckpoints[region] == CHECKPOINT_NO_AREA)
+    {
+        return -1;
+    }
+
+    region_acquire(region);
+    int pages = checkpoint_rollback(g_regionCheckpoints[region], checkpoint_page_restored, (void *)(intptr_t)region);
+    region_release(region);
+
+    return pages;
+}
+
+// Decode an MM_FAULT_ADDRESS
+int memory_matrix_region_from_address(uint32_t address, SharedMemoryRegion *region)
+{
+    uint32_t index = (address >> 24) & 0x7F;
+
+    if (!(address & MM_FAULT_ADDRESS_FLAG) || index >= SHM_COUNT ||
+        (address & 0xFFFFFFu) >= g_regionSizes[index] || !region)
+    {
+        return -1;
+    }
+
+    *region = (SharedMemoryRegion)index;
+    return 0;
+}
@@ -0,0 +1,288 @@
+#include "../../include/mixed_criticality.h"
+#include "../../include/task_table.h"
+#include "../../include/job_stats.h"
+#include "../../include/trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+// External functions
+extern TaskHotTable *kernel_get_hot_tasks(void);
+extern int kernel_set_task_shed(uint32_t taskId, uint8_t shed);
+extern int kernel_discard_releases(uint32_t taskId);
+extern int kernel_has_pending_jobs(void);
+
+// Shed state of the task in one slot; rebuilt when the slot changes hands
+typedef struct
+{
+    uint32_t taskId;
+    uint8_t shed;
+    uint64_t heldUntilUs; // Throttled: earliest time of the next job
+} McTaskState;
+
+// Mode changes and shedding happen on the scheduler thread only, between
+// decisions, so a decision always sees one mode. Other threads only read.
+static volatile LONG g_mode = DAL_D;
+static volatile LONG g_shedAction = AMC_DEFAULT_SHED;
+static McTaskState *g_taskStates = NULL;
+static int g_taskStateCount = 0;
+static uint64_t g_raisedAtUs = 0;
+static McStats g_stats;
+
+static McTaskState *mc_task_state(int slot, uint32_t taskId)
+{
+    if (slot >= g_taskStateCount)
+    {
+        int count = g_taskStateCount ? g_taskStateCount : TASK_TABLE_INITIAL_CAPACITY;
+        while (count <= slot)
+        {
+            count *= 2;
+        }
+        McTaskState *states = (McTaskState *)realloc(g_taskStates, (size_t)count * sizeof(McTaskState));
+        if (!states)
+        {
+            return NULL;
+        }
+        memset(states + g_taskStateCount, 0, (size_t)(count - g_taskStateCount) * sizeof(McTaskState));
+        g_taskStates = states;
+        g_taskStateCount = count;
+    }
+
+    // A recycled slot starts out dispatchable (see kernel_add_task)
+    McTaskState *state = &g_taskStates[slot];
+    if (state->taskId != taskId)
+    {
+        memset(state, 0, sizeof(McTaskState));
+        state->taskId = taskId;
+    }
+    return state;
+}
+
+static void mc_set_shed(McTaskState *state, uint8_t shed)
+{
+    if (state->shed != shed && kernel_set_task_shed(state->taskId, shed) >= 0)
+    {
+        state->shed = shed;
+        if (shed)
+        {
+            g_stats.shedTasks++;
+        }
+        else
+        {
+            g_stats.shedTasks--;
+        }
+    }
+}
+
+// Releases a shed task piled up while held back never run
+static void mc_drop_backlog(uint32_t taskId)
+{
+    int dropped = kernel_discard_releases(taskId);
+    if (dropped > 0)
+    {
+        job_stats_skip(taskId, (uint32_t)dropped);
+        g_stats.droppedJobs += (uint64_t)dropped;
+    }
+}
+
+// Hold back every task less critical than the mode. A throttled task is
+// first held for AMC_THROTTLE_FACTOR periods and let go for one job each
+// time its hold expires. Tasks created since the last pass are caught here.
+static void mc_apply_mode(uint64_t nowUs)
+{
+    const TaskHotTable *hot = kernel_get_hot_tasks();
+    int count = hot->count;
+    CriticalityLevel mode = (CriticalityLevel)g_mode;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!hot->allocated[i] || hot->criticality[i] <= mode)
+        {
+            continue;
+        }
+
+        McTaskState *state = mc_task_state(i, task_table_handle(hot, i));
+        if (state && !state->shed && state->heldUntilUs == 0)
+        {
+            state->heldUntilUs = nowUs + (uint64_t)hot->periodMs[i] * AMC_THROTTLE_FACTOR * 1000;
+        }
+        if (state)
+        {
+            mc_set_shed(state, g_shedAction == MC_SHED_DROP || nowUs < state->heldUntilUs);
+        }
+    }
+}
+
+// Back to DAL_D mode: every shed task runs again, minus the jobs it missed
+static void mc_restore(uint64_t nowUs)
+{
+    for (int i = 0; i < g_taskStateCount; i++)
+    {
+        McTaskState *state = &g_taskStates[i];
+        if (state->shed)
+        {
+            mc_drop_backlog(state->taskId);
+            mc_set_shed(state, 0);
+            state->shed = 0; // Also forget shed state of tasks deleted meanwhile
+        }
+        state->heldUntilUs = 0;
+    }
+    g_stats.shedTasks = 0;
+
+    InterlockedExchange(&g_mode, DAL_D);
+    g_stats.restores++;
+    g_stats.raisedUs += nowUs - g_raisedAtUs;
+    TRACE(TRACE_MC_MODE, TASK_INVALID_ID, DAL_D, 0, 0);
+    printf("AMC: Idle instant after %llu us, back to DAL_D mode\n", (unsigned long long)(nowUs - g_raisedAtUs));
+}
+
+static void mc_raise(CriticalityLevel mode, const Task *task, uint32_t usedUs, uint32_t budgetUs, uint64_t nowUs)
+{
+    if (g_mode == DAL_D)
+    {
+        g_raisedAtUs = nowUs;
+    }
+
+    InterlockedExchange(&g_mode, mode);
+    g_stats.modeSwitches++;
+    g_stats.lastTriggerTaskId = task->id;
+    TRACE(TRACE_MC_MODE, task->id, mode, usedUs, budgetUs);
+    printf("AMC: Task '%s' ran %u us over a %u us budget, raising to DAL_%c mode\n", task->name, usedUs, budgetUs,
+           'A' + mode);
+
+    mc_apply_mode(nowUs);
+}
+
+void mc_init(void)
+{
+    free(g_taskStates);
+    g_taskStates = NULL;
+    g_taskStateCount = 0;
+    g_mode = DAL_D;
+    g_raisedAtUs = 0;
+    memset(&g_stats, 0, sizeof(McStats));
+    g_stats.lastTriggerTaskId = TASK_INVALID_ID;
+}
+
+// Takes effect for tasks shed from the next mode raise on
+void mc_set_shed_action(McShedAction action)
+{
+    InterlockedExchange(&g_shedAction, action);
+}
+
+// Budget of the task's jobs in a mode, or 0 if it has none there. Modes more
+// critical than the task use its own level's budget.
+uint32_t mc_budget_us(const Task *task, CriticalityLevel mode)
+{
+    CriticalityLevel level = mode < task->criticality ? task->criticality : mode;
+    return task->criticalityBudgetMs[level] * 1000;
+}
+
+// The executor's budget must leave a critical job the time its own level
+// grants it, or enforcement would cut it short before the mode could rise
+uint32_t mc_job_budget_us(const Task *task, uint32_t budgetUs)
+{
+    uint32_t ownUs = AMC_ENABLED ? mc_budget_us(task, task->criticality) : 0;
+    return budgetUs > 0 && ownUs > budgetUs ? ownUs : budgetUs;
+}
+
+// Once per scheduler tick, before the decision. Cheap while in DAL_D mode.
+void mc_tick(uint64_t nowUs)
+{
+    if (!AMC_ENABLED || g_mode == DAL_D)
+    {
+        return;
+    }
+
+    // Shed tasks do not count: nothing left to dispatch means an idle instant
+    if (!kernel_has_pending_jobs())
+    {
+        mc_restore(nowUs);
+        return;
+    }
+
+    mc_apply_mode(nowUs);
+}
+
+// Earliest time mc_tick has something to do without being prompted by a
+// release: the idle instant that restores DAL_D mode, or the end of a
+// throttled task's hold. UINT64_MAX if nothing is due.
+uint64_t mc_next_event_us(uint64_t nowUs)
+{
+    if (!AMC_ENABLED || g_mode == DAL_D)
+    {
+        return UINT64_MAX;
+    }
+    if (!kernel_has_pending_jobs())
+    {
+        return nowUs;
+    }
+
+    uint64_t nextUs = UINT64_MAX;
+    for (int i = 0; g_shedAction == MC_SHED_THROTTLE && i < g_taskStateCount; i++)
+    {
+        const McTaskState *state = &g_taskStates[i];
+        if (state->shed && state->heldUntilUs < nextUs)
+        {
+            nextUs = state->heldUntilUs;
+        }
+    }
+    return nextUs;
+}
+
+// Account a finished job's execution time against the current mode. A task
+// more critical than the mode that runs past its budget for the mode raises
+// the mode to the least critical level whose budget covers the job.
+void mc_job_complete(const Task *task, uint32_t usedUs, uint64_t nowUs)
+{
+    if (!AMC_ENABLED)
+    {
+        return;
+    }
+
+    CriticalityLevel mode = (CriticalityLevel)g_mode;
+    if (task->criticality > mode)
+    {
+        // A throttled task had its one job; hold it back for the next few periods
+        McTaskState *state = mc_task_state((int)TASK_HANDLE_SLOT(task->id), task->id);
+        if (state && g_shedAction == MC_SHED_THROTTLE)
+        {
+            state->heldUntilUs = nowUs + (uint64_t)task->periodMs * AMC_THROTTLE_FACTOR * 1000;
+            mc_set_shed(state, 1);
+            mc_drop_backlog(task->id);
+            g_stats.throttledJobs++;
+        }
+        return;
+    }
+
+    uint32_t budgetUs = mc_budget_us(task, mode);
+    if (task->criticality == mode || budgetUs == 0 || usedUs <= budgetUs)
+    {
+        return;
+    }
+
+    CriticalityLevel next = task->criticality;
+    for (int level = (int)mode - 1; level > (int)task->criticality; level--)
+    {
+        uint32_t levelUs = mc_budget_us(task, (CriticalityLevel)level);
+        if (levelUs > 0 && usedUs <= levelUs)
+        {
+            next = (CriticalityLevel)level;
+            break;
+        }
+    }
+    mc_raise(next, task, usedUs, budgetUs, nowUs);
+}
+
+CriticalityLevel mc_get_mode(void)
+{
+    return (CriticalityLevel)g_mode;
+}
+
+void mc_get_stats(McStats *stats)
+{
+    *stats = g_stats;
+    stats->mode = (CriticalityLevel)g_mode;
+}
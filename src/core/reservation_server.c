@@ -0,0 +1,378 @@
+#include "../../include/reservation_server.h"
+#include "../../include/timer_wheel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+// External functions
+extern int kernel_set_task_active(uint32_t taskId, uint8_t active);
+extern Task *kernel_task_write_begin(uint32_t taskId);
+extern void kernel_task_write_end(uint32_t taskId);
+extern int kernel_set_task_release_gated(uint32_t taskId, uint8_t gated);
+
+typedef struct
+{
+    void (*handler)(void *);
+    void *args;
+    uint64_t submitUs;
+    uint32_t maxUs; // Declared longest run; the job starts only if this much budget is left
+} ServerJob;
+
+// Budget a sporadic server gets back at a given time
+typedef struct
+{
+    uint64_t atUs;
+    int64_t amountUs;
+} ServerReplenishment;
+
+// A server is dispatched as an ordinary task with the server's budget as its
+// execution time and its period as period and deadline, so admission control
+// bounds its interference like any periodic task's. A job starts only while
+// its declared maximum fits the budget left, so a dispatch stays within the
+// budget. The task is active only while the next job fits.
+typedef struct
+{
+    CRITICAL_SECTION lock;
+    ServerStats stats;
+    uint64_t deadlineUs; // CBS: current server deadline
+    ServerJob queue[SERVER_QUEUE_DEPTH];
+    int head;
+    int count;
+    ServerReplenishment replenishments[SERVER_MAX_REPLENISHMENTS]; // Oldest first
+    int replenishmentCount;
+    uint8_t running;
+    uint8_t eligible;
+    TimerWheelTimer replenishTimer;
+} ReservationServer;
+
+// Servers are created by startup code and live as long as the kernel;
+// a new server is published by the count
+static ReservationServer g_servers[SERVER_MAX];
+static volatile LONG g_serverCount = 0;
+
+// Local functions
+static void server_run(void *arg);
+static void server_replenish_callback(void *arg);
+
+// The next queued job fits the budget left. Caller holds the lock.
+static int server_head_fits(const ReservationServer *server)
+{
+    return server->count > 0 && (int64_t)server->queue[server->head].maxUs <= server->stats.remainingUs;
+}
+
+// Out of budget for what is queued, or in debt. Caller holds the lock.
+static int server_exhausted(const ReservationServer *server)
+{
+    return server->stats.remainingUs <= 0 || (server->count > 0 && !server_head_fits(server));
+}
+
+// Dispatchable only while the next job fits. Caller holds the lock.
+static void server_update_eligibility(ReservationServer *server)
+{
+    uint8_t eligible = server_head_fits(server);
+    if (eligible != server->eligible)
+    {
+        server->eligible = eligible;
+        kernel_set_task_active(server->stats.taskId, eligible);
+    }
+}
+
+// Apply every replenishment that is due. Caller holds the lock.
+static void server_replenish(ReservationServer *server, uint64_t nowUs)
+{
+    int64_t budgetUs = (int64_t)server->stats.budgetUs;
+
+    if (server->stats.kind == SERVER_CBS)
+    {
+        // Hard CBS: an exhausted server waits for its deadline, then gets a
+        // full budget, less any debt, and the next deadline
+        if (server_exhausted(server) && nowUs >= server->deadlineUs)
+        {
+            server->stats.remainingUs = budgetUs + (server->stats.remainingUs < 0 ? server->stats.remainingUs : 0);
+            server->deadlineUs = (server->deadlineUs > nowUs ? server->deadlineUs : nowUs) + server->stats.periodUs;
+        }
+        return;
+    }
+
+    int applied = 0;
+    while (applied < server->replenishmentCount && server->replenishments[applied].atUs <= nowUs)
+    {
+        server->stats.remainingUs += server->replenishments[applied].amountUs;
+        applied++;
+    }
+    if (server->stats.remainingUs > budgetUs)
+    {
+        server->stats.remainingUs = budgetUs;
+    }
+    server->replenishmentCount -= applied;
+    memmove(server->replenishments, server->replenishments + applied,
+            (size_t)server->replenishmentCount * sizeof(ServerReplenishment));
+}
+
+// Arm the timer for the next replenishment, if one is owed. Caller holds the lock.
+static void server_arm_replenishment(ReservationServer *server, uint64_t nowUs)
+{
+    uint64_t atUs;
+
+    if (server->stats.kind == SERVER_CBS)
+    {
+        if (!server_exhausted(server))
+        {
+            return;
+        }
+        atUs = server->deadlineUs;
+    }
+    else
+    {
+        if (server->replenishmentCount == 0)
+        {
+            return;
+        }
+        atUs = server->replenishments[0].atUs;
+    }
+
+    timer_wheel_arm(&server->replenishTimer, atUs > nowUs ? atUs - nowUs : 0, 0,
+                    server_replenish_callback, server);
+}
+
+static void server_replenish_callback(void *arg)
+{
+    ReservationServer *server = (ReservationServer *)arg;
+    uint64_t nowUs = timer_wheel_now_us();
+
+    EnterCriticalSection(&server->lock);
+    server_replenish(server, nowUs);
+    server_arm_replenishment(server, nowUs);
+    server_update_eligibility(server);
+    LeaveCriticalSection(&server->lock);
+}
+
+// Create a server and the task the scheduler dispatches for it. The budget
+// and period go through admission control like a periodic task's; a
+// degraded admission stretches the server's period. Returns the server ID,
+// or -1.
+int server_create(const char *name, ServerKind kind, uint32_t budgetMs, uint32_t periodMs,
+                  CriticalityLevel criticality)
+{
+    if (budgetMs == 0 || budgetMs > periodMs)
+    {
+        printf("Error: Server '%s' needs a budget between 1 ms and its period\n", name);
+        return -1;
+    }
+    if (g_serverCount == SERVER_MAX)
+    {
+        printf("Error: Too many reservation servers\n");
+        return -1;
+    }
+
+    int serverId = g_serverCount;
+    ReservationServer *server = &g_servers[serverId];
+    memset(server, 0, sizeof(ReservationServer));
+    InitializeCriticalSection(&server->lock);
+    strncpy(server->stats.name, name, sizeof(server->stats.name) - 1);
+    server->stats.kind = kind;
+    server->stats.budgetUs = budgetMs * 1000;
+    server->stats.remainingUs = (int64_t)budgetMs * 1000;
+    server->stats.taskId = TASK_INVALID_ID; // Until the task exists, eligibility changes go nowhere
+
+    Task task;
+    if (task_create_ex(&task, server->stats.name, server_run, server, periodMs, periodMs, budgetMs, criticality) < 0)
+    {
+        DeleteCriticalSection(&server->lock);
+        return -1;
+    }
+
+    // Jobs come from the queue, never from a release timer, so the task is
+    // dispatchable on its eligibility alone. A server job is never
+    // replicated or cut short by the job executor.
+    task_set_sporadic(task.id);
+    kernel_set_task_release_gated(task.id, 0);
+    task_set_tmr_mode(task.id, TMR_MODE_OFF);
+    task_set_overrun_action(task.id, BUDGET_ACTION_NOTIFY);
+
+    EnterCriticalSection(&server->lock);
+    server->stats.taskId = task.id;
+    server->stats.periodUs = task.periodMs * 1000;
+    server->eligible = 1; // Tasks are created active
+    server_update_eligibility(server);
+    LeaveCriticalSection(&server->lock);
+
+    MemoryBarrier();
+    InterlockedIncrement(&g_serverCount);
+    printf("Server '%s' created: %s, %u ms every %u ms\n", name, kind == SERVER_CBS ? "CBS" : "sporadic", budgetMs,
+           task.periodMs);
+    return serverId;
+}
+
+// Queue an aperiodic job (an event handler) on a server. Any thread may
+// submit. maxMs is the handler's longest run: the job waits until that
+// much budget is left, so it must be between 1 ms and the server's budget.
+// Returns 0, or -1 for an unknown server, a bad maximum or a full queue.
+int server_submit(int serverId, void (*handler)(void *), void *args, uint32_t maxMs)
+{
+    if (serverId < 0 || serverId >= g_serverCount || !handler)
+    {
+        return -1;
+    }
+
+    ReservationServer *server = &g_servers[serverId];
+    uint64_t nowUs = timer_wheel_now_us();
+    if (maxMs == 0 || maxMs * 1000 > server->stats.budgetUs)
+    {
+        printf("Error: Job of %u ms cannot run in server '%s'\n", maxMs, server->stats.name);
+        return -1;
+    }
+
+    EnterCriticalSection(&server->lock);
+    if (server->count == SERVER_QUEUE_DEPTH)
+    {
+        server->stats.rejected++;
+        LeaveCriticalSection(&server->lock);
+        return -1;
+    }
+
+    // CBS arrival at an idle server: keep the current budget and deadline
+    // only if they do not exceed the server's bandwidth from now on
+    if (server->stats.kind == SERVER_CBS && !server->running && server->count == 0 &&
+        server->stats.remainingUs > 0)
+    {
+        double bandwidth = (double)server->stats.budgetUs / (double)server->stats.periodUs;
+        if (nowUs >= server->deadlineUs ||
+            (double)server->stats.remainingUs > (double)(server->deadlineUs - nowUs) * bandwidth)
+        {
+            server->stats.remainingUs = server->stats.budgetUs;
+            server->deadlineUs = nowUs + server->stats.periodUs;
+        }
+    }
+
+    ServerJob *job = &server->queue[(server->head + server->count) % SERVER_QUEUE_DEPTH];
+    job->handler = handler;
+    job->args = args;
+    job->submitUs = nowUs;
+    job->maxUs = maxMs * 1000;
+    server->count++;
+    server_arm_replenishment(server, nowUs); // A CBS budget too small for the new job
+    server_update_eligibility(server);
+    LeaveCriticalSection(&server->lock);
+    return 0;
+}
+
+// Run a task's jobs in a server: the task stops being dispatched on its own
+// and each task_release queues its entry point on the server instead
+int server_attach_task(int serverId, uint32_t taskId)
+{
+    if (serverId < 0 || serverId >= g_serverCount)
+    {
+        printf("Error: Unknown reservation server %d\n", serverId);
+        return -1;
+    }
+
+    Task *task = kernel_task_write_begin(taskId);
+    if (!task)
+    {
+        return -1;
+    }
+    if (task->executionTimeMs == 0 || task->executionTimeMs * 1000 > g_servers[serverId].stats.budgetUs)
+    {
+        kernel_task_write_end(taskId);
+        printf("Error: Task %u needs more than the budget of server '%s'\n", taskId,
+               g_servers[serverId].stats.name);
+        return -1;
+    }
+    task->server = (uint8_t)(serverId + 1);
+    kernel_task_write_end(taskId);
+
+    task_set_sporadic(taskId);
+    kernel_set_task_active(taskId, 0);
+    printf("Task %u attached to server '%s'\n", taskId, g_servers[serverId].stats.name);
+    return 0;
+}
+
+int server_count(void)
+{
+    return g_serverCount;
+}
+
+// Returns 0, or -1 for an unknown server
+int server_get_stats(int serverId, ServerStats *stats)
+{
+    if (serverId < 0 || serverId >= g_serverCount)
+    {
+        return -1;
+    }
+
+    ReservationServer *server = &g_servers[serverId];
+    EnterCriticalSection(&server->lock);
+    *stats = server->stats;
+    stats->queued = (uint32_t)server->count;
+    LeaveCriticalSection(&server->lock);
+    return 0;
+}
+
+// Entry point of a server's task, run by the job executor: serve queued
+// jobs while the next one's declared maximum fits the budget left. A job is
+// never split, so one that runs past its maximum leaves a debt the next
+// replenishment pays first.
+static void server_run(void *arg)
+{
+    ReservationServer *server = (ReservationServer *)arg;
+    uint64_t runStartUs = timer_wheel_now_us();
+    int64_t consumedUs = 0;
+
+    EnterCriticalSection(&server->lock);
+    server->running = 1;
+    while (server_head_fits(server))
+    {
+        ServerJob job = server->queue[server->head];
+        server->head = (server->head + 1) % SERVER_QUEUE_DEPTH;
+        server->count--;
+        LeaveCriticalSection(&server->lock);
+
+        // Charged by elapsed time: the dispatcher is held for all of it
+        uint64_t startUs = timer_wheel_now_us();
+        job.handler(job.args);
+        uint64_t finishUs = timer_wheel_now_us();
+
+        EnterCriticalSection(&server->lock);
+        server->stats.remainingUs -= (int64_t)(finishUs - startUs);
+        consumedUs += (int64_t)(finishUs - startUs);
+        server->stats.jobs++;
+        server->stats.responseSumUs += finishUs - job.submitUs;
+        if (finishUs - job.submitUs > server->stats.responseMaxUs)
+        {
+            server->stats.responseMaxUs = finishUs - job.submitUs;
+        }
+    }
+    server->running = 0;
+    server->stats.consumedUs += (uint64_t)consumedUs;
+
+    // Sporadic server: what this run consumed returns one period after it started
+    if (server->stats.kind == SERVER_SPORADIC && consumedUs > 0)
+    {
+        if (server->replenishmentCount == SERVER_MAX_REPLENISHMENTS)
+        {
+            // Merge into the latest, which only delays budget
+            ServerReplenishment *last = &server->replenishments[SERVER_MAX_REPLENISHMENTS - 1];
+            last->amountUs += consumedUs;
+            last->atUs = runStartUs + server->stats.periodUs;
+        }
+        else
+        {
+            ServerReplenishment *next = &server->replenishments[server->replenishmentCount++];
+            next->atUs = runStartUs + server->stats.periodUs;
+            next->amountUs = consumedUs;
+        }
+    }
+    if (server->count > 0)
+    {
+        server->stats.exhaustions++;
+    }
+
+    uint64_t nowUs = timer_wheel_now_us();
+    server_replenish(server, nowUs);
+    server_arm_replenishment(server, nowUs);
+    server_update_eligibility(server);
+    LeaveCriticalSection(&server->lock);
+}
@@ -0,0 +1,261 @@
+#include "../../include/sched_log.h"
+#include "../../include/task_manager.h"
+#include "../../include/timer_wheel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+// External functions
+extern int kernel_get_task_slot_count(void);
+extern int kernel_read_task_slot(int slot, Task *snapshot);
+extern SystemStateVector *kernel_get_system_state(void);
+
+// Producers append to the current buffer under the lock; the flush thread
+// swaps it for the spare and writes it out, so no record is ever dropped
+typedef struct
+{
+    SchedLogRecord *records;
+    uint32_t count;
+    uint32_t capacity;
+} SchedLogBuffer;
+
+static CRITICAL_SECTION g_logLock;
+static int g_logLockReady = 0;
+static volatile int g_logRecording = 0;
+static SchedLogBuffer g_logBuffers[2];
+static SchedLogBuffer *g_logCurrent = NULL;
+static FILE *g_logFile = NULL;
+static HANDLE g_logFlushThread = NULL;
+static HANDLE g_logStopEvent = NULL;
+static uint64_t g_logRecords = 0;
+static uint64_t g_logLost = 0; // Records that did not fit after a failed grow
+
+static void sched_log_append(SchedLogRecord *record)
+{
+    if (!g_logRecording)
+    {
+        return;
+    }
+
+    EnterCriticalSection(&g_logLock);
+    SchedLogBuffer *buffer = g_logCurrent;
+    if (g_logRecording) // Not stopped while this producer waited for the lock
+    {
+        if (buffer->count == buffer->capacity)
+        {
+            uint32_t capacity = buffer->capacity * 2;
+            SchedLogRecord *records = (SchedLogRecord *)realloc(buffer->records, capacity * sizeof(SchedLogRecord));
+            if (records)
+            {
+                buffer->records = records;
+                buffer->capacity = capacity;
+            }
+        }
+
+        if (buffer->count < buffer->capacity)
+        {
+            // Stamped under the lock, so the file is in time order
+            record->timeUs = timer_wheel_now_us();
+            buffer->records[buffer->count++] = *record;
+        }
+        else
+        {
+            g_logLost++;
+        }
+    }
+    LeaveCriticalSection(&g_logLock);
+}
+
+static void sched_log_flush(void)
+{
+    EnterCriticalSection(&g_logLock);
+    SchedLogBuffer *full = g_logCurrent;
+    g_logCurrent = full == &g_logBuffers[0] ? &g_logBuffers[1] : &g_logBuffers[0];
+    LeaveCriticalSection(&g_logLock);
+
+    if (full->count > 0)
+    {
+        fwrite(full->records, sizeof(SchedLogRecord), full->count, g_logFile);
+        g_logRecords += full->count;
+        full->count = 0;
+    }
+}
+
+static DWORD WINAPI sched_log_flush_thread_func(LPVOID lpParam)
+{
+    while (WaitForSingleObject(g_logStopEvent, SCHED_LOG_FLUSH_MS) == WAIT_TIMEOUT)
+    {
+        sched_log_flush();
+    }
+    return 0;
+}
+
+// Start logging scheduler inputs. The tasks and system state at the start
+// are logged first, so the log replays on its own. Returns 0 or -1.
+int sched_log_start(const char *path)
+{
+    if (g_logRecording)
+    {
+        return -1;
+    }
+
+    if (!g_logLockReady)
+    {
+        InitializeCriticalSection(&g_logLock);
+        g_logLockReady = 1;
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+        g_logBuffers[i].count = 0;
+        if (!g_logBuffers[i].records)
+        {
+            g_logBuffers[i].records = (SchedLogRecord *)malloc(SCHED_LOG_BUFFER_RECORDS * sizeof(SchedLogRecord));
+            g_logBuffers[i].capacity = g_logBuffers[i].records ? SCHED_LOG_BUFFER_RECORDS : 0;
+        }
+        if (!g_logBuffers[i].records)
+        {
+            printf("Error: Failed to allocate scheduler log buffers\n");
+            return -1;
+        }
+    }
+    g_logCurrent = &g_logBuffers[0];
+
+    g_logFile = fopen(path, "wb");
+    if (!g_logFile)
+    {
+        printf("Error: Cannot open scheduler log %s\n", path);
+        return -1;
+    }
+
+    SchedLogHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SCHED_LOG_MAGIC, sizeof(header.magic));
+    header.version = SCHED_LOG_VERSION;
+    header.recordSize = sizeof(SchedLogRecord);
+    fwrite(&header, sizeof(header), 1, g_logFile);
+
+    g_logStopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    g_logFlushThread = g_logStopEvent ? CreateThread(NULL, 0, sched_log_flush_thread_func, NULL, 0, NULL) : NULL;
+    if (!g_logFlushThread)
+    {
+        printf("Error: Failed to create scheduler log thread\n");
+        if (g_logStopEvent)
+        {
+            CloseHandle(g_logStopEvent);
+            g_logStopEvent = NULL;
+        }
+        fclose(g_logFile);
+        g_logFile = NULL;
+        return -1;
+    }
+    SetThreadPriority(g_logFlushThread, THREAD_PRIORITY_BELOW_NORMAL);
+
+    g_logRecords = 0;
+    g_logLost = 0;
+    g_logRecording = 1;
+
+    sched_log_state(kernel_get_system_state());
+    int count = kernel_get_task_slot_count();
+    for (int i = 0; i < count; i++)
+    {
+        Task snapshot;
+        if (kernel_read_task_slot(i, &snapshot) == 0)
+        {
+            sched_log_task(&snapshot);
+        }
+    }
+
+    printf("Logging scheduler inputs to %s\n", path);
+    return 0;
+}
+
+void sched_log_stop(void)
+{
+    if (!g_logRecording)
+    {
+        return;
+    }
+
+    // Producers check the flag under the lock, so none append after this
+    EnterCriticalSection(&g_logLock);
+    g_logRecording = 0;
+    LeaveCriticalSection(&g_logLock);
+
+    SetEvent(g_logStopEvent);
+    WaitForSingleObject(g_logFlushThread, INFINITE);
+    CloseHandle(g_logFlushThread);
+    CloseHandle(g_logStopEvent);
+    g_logFlushThread = NULL;
+    g_logStopEvent = NULL;
+
+    sched_log_flush();
+    fclose(g_logFile);
+    g_logFile = NULL;
+
+    printf("Scheduler log stopped: %llu records written, %llu lost\n",
+           (unsigned long long)g_logRecords, (unsigned long long)g_logLost);
+}
+
+void sched_log_task(const Task *task)
+{
+    SchedLogRecord record = {0};
+    record.type = SCHED_LOG_TASK;
+    record.criticality = (uint8_t)task->criticality;
+    record.flags = (task->active ? SCHED_LOG_FLAG_ACTIVE : 0) | (task->sporadic ? SCHED_LOG_FLAG_SPORADIC : 0);
+    record.taskId = task->id;
+    record.args[0] = task->periodMs;
+    record.args[1] = task->deadlineMs;
+    record.args[2] = task->executionTimeMs;
+    record.args[3] = task->basePriority;
+    sched_log_append(&record);
+}
+
+void sched_log_remove(uint32_t taskId)
+{
+    SchedLogRecord record = {0};
+    record.type = SCHED_LOG_REMOVE;
+    record.taskId = taskId;
+    sched_log_append(&record);
+}
+
+void sched_log_state(const SystemStateVector *state)
+{
+    SchedLogRecord record = {0};
+    record.type = SCHED_LOG_STATE;
+    record.flags = (uint8_t)state->state;
+    record.taskId = state->activeTaskCount;
+    record.values[0] = state->cpuLoad;
+    record.values[1] = state->memoryUsage;
+    record.values[2] = state->temperature;
+    record.values[3] = state->powerConsumption;
+    sched_log_append(&record);
+}
+
+void sched_log_release(uint32_t taskId)
+{
+    SchedLogRecord record = {0};
+    record.type = SCHED_LOG_RELEASE;
+    record.taskId = taskId;
+    sched_log_append(&record);
+}
+
+void sched_log_job(uint32_t taskId, uint32_t cpuUs)
+{
+    SchedLogRecord record = {0};
+    record.type = SCHED_LOG_JOB;
+    record.taskId = taskId;
+    record.args[0] = cpuUs;
+    sched_log_append(&record);
+}
+
+void sched_log_fault(uint32_t taskId, uint32_t faultType)
+{
+    SchedLogRecord record = {0};
+    record.type = SCHED_LOG_FAULT;
+    record.taskId = taskId;
+    record.args[0] = faultType;
+    sched_log_append(&record);
+}
@@ -0,0 +1,251 @@
+#include "../../include/sched_policy.h"
+#include "../../include/task_table.h"
+#include "../../include/ml_engine.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+// Built-in policies
+static ScheduleDecision rate_monotonic_schedule(void *state, const TaskHotTable *hot, SystemStateVector *system,
+                                                const SchedulerTaskView *view);
+static ScheduleDecision earliest_deadline_schedule(void *state, const TaskHotTable *hot, SystemStateVector *system,
+                                                   const SchedulerTaskView *view);
+static ScheduleDecision ml_schedule(void *state, const TaskHotTable *hot, SystemStateVector *system,
+                                    const SchedulerTaskView *view);
+
+static const SchedPolicy g_rmsPolicy = {"RMS", SCHED_ORDER_PERIOD, NULL, NULL, NULL, NULL, rate_monotonic_schedule};
+static const SchedPolicy g_edfPolicy = {"EDF", SCHED_ORDER_DEADLINE, NULL, NULL, NULL, NULL,
+                                        earliest_deadline_schedule};
+static const SchedPolicy g_mlHybridPolicy = {"ML_HYBRID", SCHED_ORDER_NONE, NULL, NULL, NULL, NULL, ml_schedule};
+
+// Entries are only appended, and a new entry is published by the count, so
+// lookups never lock. Registration itself is meant for startup code.
+static const SchedPolicy *g_policies[SCHED_POLICY_MAX] = {&g_rmsPolicy, &g_edfPolicy, &g_mlHybridPolicy};
+static volatile LONG g_policyCount = 3;
+static volatile LONGLONG g_policyDecisions[SCHED_POLICY_MAX];
+static volatile LONGLONG g_policyDecideNs[SCHED_POLICY_MAX];
+static volatile LONGLONG g_policyMaxDecideNs[SCHED_POLICY_MAX];
+static double g_nsPerCount = 0.0;
+
+static int policy_index(const SchedPolicy *policy)
+{
+    for (int i = 0; i < g_policyCount; i++)
+    {
+        if (g_policies[i] == policy)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Add a policy to the registry. The descriptor must outlive every instance.
+// Returns 0, or -1 if it is incomplete, its name is taken or the registry is full.
+int sched_policy_register(const SchedPolicy *policy)
+{
+    if (!policy || !policy->name || !policy->pickNext)
+    {
+        printf("Error: Scheduling policy needs a name and a pickNext hook\n");
+        return -1;
+    }
+    if (sched_policy_find(policy->name))
+    {
+        printf("Error: Scheduling policy %s is already registered\n", policy->name);
+        return -1;
+    }
+    if (g_policyCount == SCHED_POLICY_MAX)
+    {
+        printf("Error: Scheduling policy registry full\n");
+        return -1;
+    }
+
+    g_policies[g_policyCount] = policy;
+    MemoryBarrier();
+    InterlockedIncrement(&g_policyCount);
+    printf("Scheduling policy %s registered\n", policy->name);
+    return 0;
+}
+
+const SchedPolicy *sched_policy_find(const char *name)
+{
+    int count = g_policyCount;
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(g_policies[i]->name, name) == 0)
+        {
+            return g_policies[i];
+        }
+    }
+    return NULL;
+}
+
+int sched_policy_count(void)
+{
+    return g_policyCount;
+}
+
+const SchedPolicy *sched_policy_at(int index)
+{
+    return index >= 0 && index < g_policyCount ? g_policies[index] : NULL;
+}
+
+int sched_policy_instance_init(SchedPolicyInstance *instance, const SchedPolicy *policy)
+{
+    instance->policy = policy;
+    instance->state = NULL;
+    if (policy->init)
+    {
+        instance->state = policy->init();
+        if (!instance->state)
+        {
+            printf("Error: Scheduling policy %s failed to initialize\n", policy->name);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void sched_policy_instance_destroy(SchedPolicyInstance *instance)
+{
+    if (instance->policy && instance->policy->destroy)
+    {
+        instance->policy->destroy(instance->state);
+    }
+    instance->state = NULL;
+}
+
+// Decide with the instance's policy and charge the decision cost to it
+ScheduleDecision sched_policy_pick(SchedPolicyInstance *instance, const TaskHotTable *hot, SystemStateVector *system,
+                                   const SchedulerTaskView *view)
+{
+    LARGE_INTEGER start, end;
+
+    if (g_nsPerCount == 0.0)
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        g_nsPerCount = 1e9 / (double)frequency.QuadPart;
+    }
+
+    QueryPerformanceCounter(&start);
+    ScheduleDecision decision = instance->policy->pickNext(instance->state, hot, system, view);
+    QueryPerformanceCounter(&end);
+
+    int index = policy_index(instance->policy);
+    if (index >= 0)
+    {
+        LONGLONG elapsedNs = (LONGLONG)((double)(end.QuadPart - start.QuadPart) * g_nsPerCount);
+        InterlockedIncrement64(&g_policyDecisions[index]);
+        InterlockedExchangeAdd64(&g_policyDecideNs[index], elapsedNs);
+        for (;;)
+        {
+            LONGLONG maxNs = g_policyMaxDecideNs[index];
+            if (elapsedNs <= maxNs ||
+                InterlockedCompareExchange64(&g_policyMaxDecideNs[index], elapsedNs, maxNs) == maxNs)
+            {
+                break;
+            }
+        }
+    }
+
+    return decision;
+}
+
+void sched_policy_release(SchedPolicyInstance *instance, uint32_t taskId, uint64_t releaseUs)
+{
+    if (instance->policy->onRelease)
+    {
+        instance->policy->onRelease(instance->state, taskId, releaseUs);
+    }
+}
+
+void sched_policy_complete(SchedPolicyInstance *instance, uint32_t taskId, uint64_t finishUs, int missed)
+{
+    if (instance->policy->onComplete)
+    {
+        instance->policy->onComplete(instance->state, taskId, finishUs, missed);
+    }
+}
+
+// Returns 0, or -1 for an unknown policy
+int sched_policy_get_stats(const char *name, SchedPolicyStats *stats)
+{
+    int index = policy_index(sched_policy_find(name));
+    if (index < 0)
+    {
+        return -1;
+    }
+
+    stats->decisions = (uint64_t)g_policyDecisions[index];
+    stats->decideNs = (uint64_t)g_policyDecideNs[index];
+    stats->maxDecideNs = (uint64_t)g_policyMaxDecideNs[index];
+    return 0;
+}
+
+static ScheduleDecision decision_for_slot(const TaskHotTable *hot, int slot)
+{
+    ScheduleDecision decision = {0};
+    decision.taskId = TASK_INVALID_ID;
+
+    if (slot >= 0)
+    {
+        decision.taskId = task_table_handle(hot, slot);
+        decision.targetCore = hot->coreAffinity[slot];
+        decision.timeSliceMs = hot->executionTimeMs[slot];
+    }
+
+    return decision;
+}
+
+// Implementation of traditional scheduling algorithms
+static ScheduleDecision rate_monotonic_schedule(void *state, const TaskHotTable *hot, SystemStateVector *system,
+                                                const SchedulerTaskView *view)
+{
+    (void)state;
+    (void)system;
+    (void)view;
+
+    // Shortest period has the highest rate-monotonic priority
+    return decision_for_slot(hot, task_table_argmin(hot, hot->periodMs));
+}
+
+static ScheduleDecision earliest_deadline_schedule(void *state, const TaskHotTable *hot, SystemStateVector *system,
+                                                   const SchedulerTaskView *view)
+{
+    (void)state;
+    (void)system;
+    (void)view;
+
+    return decision_for_slot(hot, task_table_argmin(hot, hot->deadlineMs));
+}
+
+static ScheduleDecision ml_schedule(void *state, const TaskHotTable *hot, SystemStateVector *system,
+                                    const SchedulerTaskView *view)
+{
+    (void)state;
+
+    int best = -1;
+    int count = hot->count;
+    float highest_score = -1.0f;
+
+    // Only active candidates pull their cold descriptor into cache
+    for (int i = 0; i < count; i++)
+    {
+        Task snapshot;
+        if (hot->active[i] && view->readTask(view->context, i, &snapshot) == 0)
+        {
+            // Use ML engine to compute dynamic priority
+            float score = ml_dynamic_priority(&snapshot, system, view->faultFactor(view->context, snapshot.id));
+
+            if (score > highest_score)
+            {
+                highest_score = score;
+                best = i;
+            }
+        }
+    }
+
+    return decision_for_slot(hot, best);
+}
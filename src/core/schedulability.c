@@ -0,0 +1,755 @@
+#include "../../include/schedulability.h"
+#include "../../include/task_manager.h"
+#include "../../include/sched_policy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+// External functions
+extern int kernel_is_tickless(void);
+extern int kernel_read_task(uint32_t taskId, Task *snapshot);
+
+// Analysis model of the dispatcher: the scheduler thread starts at most one
+// job per tick and runs it to completion, so jobs are non-preemptive, hold
+// the processor to the next tick boundary, and a release waits up to a tick
+// to be seen (release jitter). Tickless, a job holds the processor for its
+// own execution time and a release is seen within a timer-wheel tick.
+//
+// Policies declare their dispatch order. RMS dispatches in period order and
+// EDF (argmin of the relative deadline) in deadline order; both are
+// fixed-priority and get exact non-preemptive response-time analysis.
+// ML_HYBRID and policies without a fixed order admit only sets that pass
+// the non-preemptive EDF processor-demand test: if EDF cannot meet them, no
+// work-conserving non-preemptive policy can.
+
+typedef enum
+{
+    ANALYSIS_FP_PERIOD,   // Rate monotonic
+    ANALYSIS_FP_DEADLINE, // Deadline monotonic
+    ANALYSIS_DEMAND       // Non-preemptive EDF processor demand
+} AnalysisKind;
+
+typedef struct
+{
+    uint32_t taskId;      // TASK_INVALID_ID while only reserved
+    uint32_t reservation;
+    uint64_t costUs;      // Execution time rounded up to whole dispatch quanta
+    uint64_t periodUs;
+    uint64_t deadlineUs;
+    uint64_t key;         // Fixed-priority order; lower runs first
+    uint64_t blockingUs;  // From the last response-time analysis
+    uint64_t responseUs;
+} AnalysisTask;
+
+#define RESPONSE_UNSCHEDULABLE UINT64_MAX
+
+static CRITICAL_SECTION g_analysisLock;
+static AnalysisTask *g_tasks = NULL; // Sorted by key, ties in admission order
+static int g_taskCount = 0;
+static int g_taskCapacity = 0;
+static AnalysisKind g_kind = ANALYSIS_DEMAND;
+static int g_stale = 0; // Response times need a full pass
+static AdmissionMode g_mode = (AdmissionMode)ADMISSION_DEFAULT_MODE;
+static uint32_t g_nextReservation = 1;
+static uint32_t g_rejected = 0;
+static uint32_t g_degraded = 0;
+static int g_modeBudgets = 0; // Some task has criticality budgets, so raised modes are checked too
+static uint64_t *g_demandPoints = NULL;
+static int g_demandCapacity = 0;
+
+// Local functions
+static int analysis_modes_schedulable(uint32_t taskId, CriticalityLevel criticality, const uint32_t *budgetMs);
+
+// Granularity job costs are rounded up to; 0 when tickless
+static uint64_t analysis_quantum_us(void)
+{
+    return kernel_is_tickless() ? 0 : (uint64_t)SCHEDULER_PERIOD_MS * 1000;
+}
+
+// Worst delay between a release and the scheduler seeing it. Tickless, a
+// release wakes the scheduler, and while any released job waits it decides
+// again as soon as the running job ends, so only the wheel's rounding is
+// left; the running job itself is the blocking term.
+static uint64_t analysis_jitter_us(void)
+{
+    return kernel_is_tickless() ? TIMER_WHEEL_TICK_US : (uint64_t)SCHEDULER_PERIOD_MS * 1000;
+}
+
+static AnalysisKind analysis_kind(void)
+{
+    const SchedPolicy *policy = sched_policy_find(scheduler_get_policy());
+    if (policy && policy->order == SCHED_ORDER_PERIOD)
+    {
+        return ANALYSIS_FP_PERIOD;
+    }
+    if (policy && policy->order == SCHED_ORDER_DEADLINE)
+    {
+        return ANALYSIS_FP_DEADLINE;
+    }
+    return ANALYSIS_DEMAND;
+}
+
+static uint64_t div_ceil(uint64_t a, uint64_t b)
+{
+    return (a + b - 1) / b;
+}
+
+static int compare_keys(const void *a, const void *b)
+{
+    const AnalysisTask *left = (const AnalysisTask *)a;
+    const AnalysisTask *right = (const AnalysisTask *)b;
+    if (left->key != right->key)
+    {
+        return left->key < right->key ? -1 : 1;
+    }
+    return (left->reservation > right->reservation) - (left->reservation < right->reservation);
+}
+
+// Follow a policy change: re-key and re-sort, then recompute everything
+static void analysis_sync_kind(void)
+{
+    AnalysisKind kind = analysis_kind();
+    if (kind == g_kind)
+    {
+        return;
+    }
+
+    g_kind = kind;
+    for (int i = 0; i < g_taskCount; i++)
+    {
+        g_tasks[i].key = kind == ANALYSIS_FP_DEADLINE ? g_tasks[i].deadlineUs : g_tasks[i].periodUs;
+    }
+    if (g_taskCount > 1)
+    {
+        qsort(g_tasks, g_taskCount, sizeof(AnalysisTask), compare_keys);
+    }
+    g_stale = 1;
+}
+
+// Worst-case response time of task i under non-preemptive fixed priorities
+// with release jitter (Davis, Burns, Bril and Lukkien, 2007): every job in
+// the level-i busy period is checked, since the first is not always the
+// worst. Tasks with an equal key are counted as higher priority.
+static uint64_t fp_response_us(int i)
+{
+    const AnalysisTask *task = &g_tasks[i];
+    uint64_t jitterUs = analysis_jitter_us();
+    uint64_t blockingUs = 0;
+    double utilization = 0.0;
+
+    for (int j = 0; j < g_taskCount; j++)
+    {
+        if (g_tasks[j].key > task->key)
+        {
+            blockingUs = g_tasks[j].costUs > blockingUs ? g_tasks[j].costUs : blockingUs;
+        }
+        else
+        {
+            utilization += (double)g_tasks[j].costUs / (double)g_tasks[j].periodUs;
+        }
+    }
+    blockingUs += ADMISSION_SYSTEM_BLOCKING_US;
+    g_tasks[i].blockingUs = blockingUs;
+
+    if (utilization >= 1.0)
+    {
+        return RESPONSE_UNSCHEDULABLE;
+    }
+
+    // Level-i busy period
+    uint64_t busyUs = blockingUs + task->costUs;
+    for (;;)
+    {
+        uint64_t next = blockingUs;
+        for (int j = 0; j < g_taskCount; j++)
+        {
+            if (g_tasks[j].key <= task->key)
+            {
+                next += div_ceil(busyUs + jitterUs, g_tasks[j].periodUs) * g_tasks[j].costUs;
+            }
+        }
+        if (next == busyUs)
+        {
+            break;
+        }
+        busyUs = next;
+    }
+
+    uint64_t jobs = div_ceil(busyUs + jitterUs, task->periodUs);
+    uint64_t worstUs = 0;
+    uint64_t startUs = blockingUs;
+    for (uint64_t q = 0; q < jobs; q++)
+    {
+        // Latest start of job q: higher-priority work released up to and at the start
+        startUs = startUs > blockingUs + q * task->costUs ? startUs : blockingUs + q * task->costUs;
+        for (;;)
+        {
+            uint64_t next = blockingUs + q * task->costUs;
+            for (int j = 0; j < g_taskCount; j++)
+            {
+                if (j != i && g_tasks[j].key <= task->key)
+                {
+                    next += ((startUs + jitterUs) / g_tasks[j].periodUs + 1) * g_tasks[j].costUs;
+                }
+            }
+            if (next == startUs)
+            {
+                break;
+            }
+            startUs = next;
+            if (startUs + jitterUs + task->costUs > task->deadlineUs + q * task->periodUs)
+            {
+                return RESPONSE_UNSCHEDULABLE;
+            }
+        }
+
+        uint64_t responseUs = jitterUs + startUs + task->costUs - q * task->periodUs;
+        if (responseUs > task->deadlineUs)
+        {
+            return RESPONSE_UNSCHEDULABLE;
+        }
+        worstUs = responseUs > worstUs ? responseUs : worstUs;
+    }
+
+    return worstUs;
+}
+
+static int compare_points(const void *a, const void *b)
+{
+    uint64_t left = *(const uint64_t *)a;
+    uint64_t right = *(const uint64_t *)b;
+    return (left > right) - (left < right);
+}
+
+// Non-preemptive EDF with release jitter: utilization below 1 and, at
+// every absolute deadline L in the first busy period, the demand of jobs
+// with deadlines up to L plus one longer-deadline job already started fits
+static int demand_schedulable(void)
+{
+    uint64_t jitterUs = analysis_jitter_us();
+    uint64_t maxCostUs = 0;
+    double utilization = 0.0;
+
+    for (int i = 0; i < g_taskCount; i++)
+    {
+        utilization += (double)g_tasks[i].costUs / (double)g_tasks[i].periodUs;
+        maxCostUs = g_tasks[i].costUs > maxCostUs ? g_tasks[i].costUs : maxCostUs;
+    }
+    if (g_taskCount == 0)
+    {
+        return 1;
+    }
+    if (utilization >= 1.0)
+    {
+        return 0;
+    }
+
+    // Synchronous busy period, with the longest job blocking at its start
+    uint64_t busyUs = maxCostUs + ADMISSION_SYSTEM_BLOCKING_US;
+    for (;;)
+    {
+        uint64_t next = maxCostUs + ADMISSION_SYSTEM_BLOCKING_US;
+        for (int i = 0; i < g_taskCount; i++)
+        {
+            next += div_ceil(busyUs + jitterUs, g_tasks[i].periodUs) * g_tasks[i].costUs;
+        }
+        if (next == busyUs)
+        {
+            break;
+        }
+        busyUs = next;
+    }
+
+    // Deadline points inside it
+    int points = 0;
+    for (int i = 0; i < g_taskCount; i++)
+    {
+        const AnalysisTask *task = &g_tasks[i];
+        uint64_t firstUs = task->deadlineUs > jitterUs ? task->deadlineUs - jitterUs : 0;
+        for (uint64_t pointUs = firstUs; pointUs <= busyUs; pointUs += task->periodUs)
+        {
+            if (points == ADMISSION_MAX_DEMAND_POINTS)
+            {
+                return 0;
+            }
+            if (points == g_demandCapacity)
+            {
+                int capacity = g_demandCapacity ? g_demandCapacity * 2 : 1024;
+                uint64_t *grown = (uint64_t *)realloc(g_demandPoints, capacity * sizeof(uint64_t));
+                if (!grown)
+                {
+                    return 0;
+                }
+                g_demandPoints = grown;
+                g_demandCapacity = capacity;
+            }
+            g_demandPoints[points++] = pointUs;
+        }
+    }
+    qsort(g_demandPoints, points, sizeof(uint64_t), compare_points);
+
+    for (int p = 0; p < points; p++)
+    {
+        uint64_t pointUs = g_demandPoints[p];
+        if (p > 0 && pointUs == g_demandPoints[p - 1])
+        {
+            continue;
+        }
+
+        uint64_t demandUs = ADMISSION_SYSTEM_BLOCKING_US;
+        uint64_t blockingUs = 0;
+        for (int i = 0; i < g_taskCount; i++)
+        {
+            const AnalysisTask *task = &g_tasks[i];
+            if (pointUs + jitterUs >= task->deadlineUs)
+            {
+                demandUs += ((pointUs + jitterUs - task->deadlineUs) / task->periodUs + 1) * task->costUs;
+            }
+            if (task->deadlineUs > pointUs + jitterUs && task->costUs > blockingUs)
+            {
+                blockingUs = task->costUs;
+            }
+        }
+        if (demandUs + blockingUs > pointUs)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Re-run the analysis after a task with this key and cost entered or left.
+// Fixed priorities recompute only the levels it can affect: its own and
+// lower ones, and higher ones whose blocking it sets. Returns 1 if every
+// admitted task still meets its deadline.
+static int analysis_refresh(uint64_t key, uint64_t costUs, int entered)
+{
+    if (g_kind == ANALYSIS_DEMAND)
+    {
+        g_stale = 0;
+        return demand_schedulable();
+    }
+
+    int schedulable = 1;
+    uint64_t blockingUs = costUs + ADMISSION_SYSTEM_BLOCKING_US;
+    for (int i = 0; i < g_taskCount; i++)
+    {
+        AnalysisTask *task = &g_tasks[i];
+        int affected = g_stale || task->key >= key ||
+                       (entered ? blockingUs > task->blockingUs : blockingUs == task->blockingUs);
+        if (affected)
+        {
+            task->responseUs = fp_response_us(i);
+            schedulable = schedulable && task->responseUs != RESPONSE_UNSCHEDULABLE;
+        }
+    }
+
+    g_stale = 0;
+    return schedulable;
+}
+
+static int analysis_insert(const AnalysisTask *task)
+{
+    if (g_taskCount == g_taskCapacity)
+    {
+        int capacity = g_taskCapacity ? g_taskCapacity * 2 : TASK_TABLE_INITIAL_CAPACITY;
+        AnalysisTask *grown = (AnalysisTask *)realloc(g_tasks, capacity * sizeof(AnalysisTask));
+        if (!grown)
+        {
+            return -1;
+        }
+        g_tasks = grown;
+        g_taskCapacity = capacity;
+    }
+
+    int index = g_taskCount;
+    while (index > 0 && compare_keys(&g_tasks[index - 1], task) > 0)
+    {
+        g_tasks[index] = g_tasks[index - 1];
+        index--;
+    }
+    g_tasks[index] = *task;
+    g_taskCount++;
+    return index;
+}
+
+static void analysis_erase(int index)
+{
+    AnalysisTask removed = g_tasks[index];
+
+    memmove(&g_tasks[index], &g_tasks[index + 1], (size_t)(g_taskCount - index - 1) * sizeof(AnalysisTask));
+    g_taskCount--;
+    analysis_refresh(removed.key, removed.costUs, 0);
+}
+
+static int analysis_find(uint32_t taskId, uint32_t reservation)
+{
+    for (int i = 0; i < g_taskCount; i++)
+    {
+        if ((taskId != TASK_INVALID_ID && g_tasks[i].taskId == taskId) ||
+            (reservation != 0 && g_tasks[i].reservation == reservation))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void analysis_fill(AnalysisTask *task, uint32_t periodMs, uint32_t deadlineMs, uint32_t executionTimeMs)
+{
+    uint64_t quantumUs = analysis_quantum_us();
+    uint64_t costUs = (uint64_t)executionTimeMs * 1000;
+
+    task->costUs = quantumUs ? div_ceil(costUs ? costUs : 1, quantumUs) * quantumUs : costUs;
+    task->periodUs = (uint64_t)periodMs * 1000;
+    task->deadlineUs = (uint64_t)deadlineMs * 1000;
+    task->key = g_kind == ANALYSIS_FP_DEADLINE ? task->deadlineUs : task->periodUs;
+    task->blockingUs = 0;
+    task->responseUs = 0;
+}
+
+// Insert the task and keep it only if the set stays schedulable
+static int analysis_try(AnalysisTask *task)
+{
+    int index = analysis_insert(task);
+    if (index < 0)
+    {
+        return 0;
+    }
+    if (g_mode == ADMISSION_OFF)
+    {
+        g_stale = 1;
+        return 1;
+    }
+    if (analysis_refresh(task->key, task->costUs, 1))
+    {
+        return 1;
+    }
+
+    analysis_erase(index);
+    return 0;
+}
+
+void sched_analysis_init(void)
+{
+    InitializeCriticalSection(&g_analysisLock);
+    g_taskCount = 0;
+    g_kind = analysis_kind();
+    g_stale = 0;
+    g_rejected = 0;
+    g_degraded = 0;
+}
+
+void sched_analysis_set_mode(AdmissionMode mode)
+{
+    EnterCriticalSection(&g_analysisLock);
+    g_mode = mode;
+    LeaveCriticalSection(&g_analysisLock);
+}
+
+// Decide whether a new periodic or sporadic task fits the admitted set
+// under the active policy. An admitted task holds a reservation until the
+// kernel assigns its ID (sched_analysis_commit) or creation fails
+// (sched_analysis_cancel). Degrading stretches the period and deadline.
+AdmissionVerdict sched_analysis_admit(uint32_t *periodMs, uint32_t *deadlineMs, uint32_t executionTimeMs,
+                                      uint32_t *reservation)
+{
+    AdmissionVerdict verdict = ADMISSION_ADMITTED;
+    AnalysisTask task;
+
+    *reservation = 0;
+    if (*periodMs == 0 || *deadlineMs == 0)
+    {
+        return ADMISSION_ADMITTED; // Aperiodic: nothing to analyze
+    }
+
+    EnterCriticalSection(&g_analysisLock);
+    analysis_sync_kind();
+    if (g_stale && g_mode != ADMISSION_OFF && !analysis_refresh(0, 0, 1))
+    {
+        printf("Warning: Admitted task set is no longer schedulable under %s\n", scheduler_get_policy());
+    }
+
+    memset(&task, 0, sizeof(task));
+    task.taskId = TASK_INVALID_ID;
+    task.reservation = g_nextReservation++;
+    analysis_fill(&task, *periodMs, *deadlineMs, executionTimeMs);
+
+    if (!analysis_try(&task))
+    {
+        verdict = ADMISSION_REJECTED;
+
+        // Shortest stretched period that fits, by bisection; fewer jobs
+        // never make the set harder to schedule
+        uint64_t stretchedMs = (uint64_t)*periodMs * ADMISSION_MAX_STRETCH;
+        uint32_t low = *periodMs, high = stretchedMs > UINT32_MAX ? UINT32_MAX : (uint32_t)stretchedMs;
+        analysis_fill(&task, high, (uint32_t)((uint64_t)*deadlineMs * high / *periodMs), executionTimeMs);
+        if (g_mode == ADMISSION_DEGRADE && analysis_try(&task))
+        {
+            analysis_erase(analysis_find(TASK_INVALID_ID, task.reservation));
+            while (high - low > 1)
+            {
+                uint32_t middle = low + (high - low) / 2;
+                analysis_fill(&task, middle, (uint32_t)((uint64_t)*deadlineMs * middle / *periodMs), executionTimeMs);
+                if (analysis_try(&task))
+                {
+                    analysis_erase(analysis_find(TASK_INVALID_ID, task.reservation));
+                    high = middle;
+                }
+                else
+                {
+                    low = middle;
+                }
+            }
+
+            uint32_t stretchedDeadlineMs = (uint32_t)((uint64_t)*deadlineMs * high / *periodMs);
+            analysis_fill(&task, high, stretchedDeadlineMs, executionTimeMs);
+            if (analysis_try(&task))
+            {
+                *periodMs = high;
+                *deadlineMs = stretchedDeadlineMs;
+                verdict = ADMISSION_DEGRADED;
+                g_degraded++;
+            }
+        }
+        if (verdict == ADMISSION_REJECTED)
+        {
+            g_rejected++;
+        }
+    }
+
+    // Once tasks have criticality budgets the raised modes must hold too,
+    // with the new task assumed never shed
+    if (verdict != ADMISSION_REJECTED && g_modeBudgets && g_mode != ADMISSION_OFF &&
+        !analysis_modes_schedulable(TASK_INVALID_ID, DAL_A, NULL))
+    {
+        analysis_erase(analysis_find(TASK_INVALID_ID, task.reservation));
+        g_degraded -= verdict == ADMISSION_DEGRADED;
+        verdict = ADMISSION_REJECTED;
+        g_rejected++;
+    }
+
+    if (verdict != ADMISSION_REJECTED)
+    {
+        *reservation = task.reservation;
+    }
+    LeaveCriticalSection(&g_analysisLock);
+    return verdict;
+}
+
+void sched_analysis_commit(uint32_t reservation, uint32_t taskId)
+{
+    EnterCriticalSection(&g_analysisLock);
+    int index = reservation ? analysis_find(TASK_INVALID_ID, reservation) : -1;
+    if (index >= 0)
+    {
+        g_tasks[index].taskId = taskId;
+    }
+    LeaveCriticalSection(&g_analysisLock);
+}
+
+void sched_analysis_cancel(uint32_t reservation)
+{
+    EnterCriticalSection(&g_analysisLock);
+    int index = reservation ? analysis_find(TASK_INVALID_ID, reservation) : -1;
+    if (index >= 0)
+    {
+        analysis_erase(index);
+    }
+    LeaveCriticalSection(&g_analysisLock);
+}
+
+// Re-admit a task with a new execution time. Returns 0 if the set stays
+// schedulable (or admission is off), -1 if the change was refused.
+int sched_analysis_update(uint32_t taskId, uint32_t executionTimeMs)
+{
+    int result = 0;
+
+    EnterCriticalSection(&g_analysisLock);
+    analysis_sync_kind();
+    int index = analysis_find(taskId, 0);
+    if (index >= 0)
+    {
+        AnalysisTask previous = g_tasks[index];
+        AnalysisTask task = previous;
+        uint32_t periodMs = (uint32_t)(previous.periodUs / 1000);
+        uint32_t deadlineMs = (uint32_t)(previous.deadlineUs / 1000);
+
+        analysis_erase(index);
+        analysis_fill(&task, periodMs, deadlineMs, executionTimeMs);
+        if (!analysis_try(&task))
+        {
+            // The old figure fitted before, so restore it unchecked
+            analysis_insert(&previous);
+            g_stale = 1;
+            result = -1;
+        }
+    }
+    LeaveCriticalSection(&g_analysisLock);
+
+    return result;
+}
+
+// Check every raised criticality mode, with taskId given the budgets in
+// budgetMs if not NULL. In a raised mode the executor lets each task at
+// least as critical as the mode run up to its own level's budget, so those
+// tasks are analyzed with that cost. Shed tasks are counted as throttled to
+// one job per AMC_THROTTLE_FACTOR periods, which also covers dropping them,
+// and still block as any non-preemptive job does. Caller holds the lock.
+static int analysis_modes_schedulable(uint32_t taskId, CriticalityLevel criticality, const uint32_t *budgetMs)
+{
+    int count = g_taskCount;
+    AnalysisTask *raised = (AnalysisTask *)malloc((size_t)(count ? count : 1) * sizeof(AnalysisTask));
+    uint64_t *ownCostUs = (uint64_t *)malloc((size_t)(count ? count : 1) * sizeof(uint64_t));
+    uint8_t *levels = (uint8_t *)malloc((size_t)(count ? count : 1));
+    int schedulable = raised && ownCostUs && levels;
+
+    for (int i = 0; schedulable && i < count; i++)
+    {
+        Task snapshot;
+        uint32_t ownMs = 0;
+
+        levels[i] = DAL_A; // Only reserved so far: assume it is never shed
+        if (budgetMs && g_tasks[i].taskId == taskId)
+        {
+            levels[i] = (uint8_t)criticality;
+            ownMs = budgetMs[criticality];
+        }
+        else if (g_tasks[i].taskId != TASK_INVALID_ID && kernel_read_task(g_tasks[i].taskId, &snapshot) == 0)
+        {
+            levels[i] = (uint8_t)snapshot.criticality;
+            ownMs = snapshot.criticalityBudgetMs[snapshot.criticality];
+        }
+
+        AnalysisTask own = g_tasks[i];
+        analysis_fill(&own, (uint32_t)(own.periodUs / 1000), (uint32_t)(own.deadlineUs / 1000), ownMs);
+        ownCostUs[i] = ownMs > 0 && own.costUs > g_tasks[i].costUs ? own.costUs : g_tasks[i].costUs;
+    }
+
+    AnalysisTask *admitted = g_tasks;
+    int stale = g_stale;
+    for (int mode = DAL_A; mode < DAL_D && schedulable; mode++)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            raised[i] = admitted[i];
+            if (levels[i] <= mode)
+            {
+                raised[i].costUs = ownCostUs[i];
+            }
+            else
+            {
+                raised[i].periodUs *= AMC_THROTTLE_FACTOR;
+                raised[i].deadlineUs = raised[i].periodUs;
+                raised[i].key = raised[i].periodUs;
+            }
+        }
+        qsort(raised, count, sizeof(AnalysisTask), compare_keys);
+
+        g_tasks = raised;
+        g_stale = 1;
+        schedulable = analysis_refresh(0, 0, 1);
+        g_tasks = admitted;
+    }
+    g_stale = stale;
+
+    free(raised);
+    free(ownCostUs);
+    free(levels);
+    return schedulable;
+}
+
+// Whether taskId can take these criticality budgets: every raised mode
+// stays schedulable with them. Once any task has budgets, admission checks
+// the raised modes too. Returns 1 if so (or admission is off), 0 if not.
+int sched_analysis_check_modes(uint32_t taskId, CriticalityLevel criticality, const uint32_t budgetMs[4])
+{
+    int schedulable = 1;
+
+    EnterCriticalSection(&g_analysisLock);
+    analysis_sync_kind();
+    if (g_mode != ADMISSION_OFF)
+    {
+        schedulable = analysis_modes_schedulable(taskId, criticality, budgetMs);
+    }
+    if (schedulable)
+    {
+        g_modeBudgets = 1;
+    }
+    LeaveCriticalSection(&g_analysisLock);
+
+    return schedulable;
+}
+
+void sched_analysis_remove(uint32_t taskId)
+{
+    EnterCriticalSection(&g_analysisLock);
+    int index = analysis_find(taskId, 0);
+    if (index >= 0)
+    {
+        analysis_erase(index);
+    }
+    LeaveCriticalSection(&g_analysisLock);
+}
+
+// Worst-case response time from the fixed-priority analysis. Returns -1 if
+// the task is not tracked or the active policy has no fixed-priority order.
+int sched_analysis_response_us(uint32_t taskId, uint64_t *responseUs)
+{
+    int result = -1;
+
+    EnterCriticalSection(&g_analysisLock);
+    analysis_sync_kind();
+    if (g_kind != ANALYSIS_DEMAND)
+    {
+        if (g_stale)
+        {
+            analysis_refresh(0, 0, 1);
+        }
+        int index = analysis_find(taskId, 0);
+        if (index >= 0 && g_tasks[index].responseUs != RESPONSE_UNSCHEDULABLE)
+        {
+            *responseUs = g_tasks[index].responseUs;
+            result = 0;
+        }
+    }
+    LeaveCriticalSection(&g_analysisLock);
+
+    return result;
+}
+
+void sched_analysis_get_stats(SchedAnalysisStats *stats)
+{
+    memset(stats, 0, sizeof(SchedAnalysisStats));
+
+    EnterCriticalSection(&g_analysisLock);
+    analysis_sync_kind();
+    if (g_stale && g_kind != ANALYSIS_DEMAND)
+    {
+        analysis_refresh(0, 0, 1);
+    }
+
+    uint64_t worstSlackUs = UINT32_MAX;
+    double utilization = 0.0;
+    for (int i = 0; i < g_taskCount; i++)
+    {
+        const AnalysisTask *task = &g_tasks[i];
+        utilization += (double)task->costUs / (double)task->periodUs;
+        if (g_kind != ANALYSIS_DEMAND)
+        {
+            uint64_t slackUs = task->responseUs <= task->deadlineUs ? task->deadlineUs - task->responseUs : 0;
+            worstSlackUs = slackUs < worstSlackUs ? slackUs : worstSlackUs;
+        }
+    }
+
+    stats->admitted = (uint32_t)g_taskCount;
+    stats->rejected = g_rejected;
+    stats->degraded = g_degraded;
+    stats->utilization = (float)utilization;
+    stats->fixedPriority = g_kind != ANALYSIS_DEMAND;
+    stats->worstSlackUs = stats->fixedPriority && g_taskCount > 0 ? (uint32_t)worstSlackUs : 0;
+    LeaveCriticalSection(&g_analysisLock);
+}
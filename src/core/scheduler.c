@@ -1,7 +1,18 @@
 #include "../../include/scheduler.h"
-#include "../../include/ml_engine.h"
+#include "../../include/sched_policy.h"
+#include "../../include/task_table.h"
 #include "../../include/system_config.h"
 #include "../../include/memory_matrix.h"
+#include "../../include/tmr_executor.h"
+#include "../../include/checkpoint.h"
+#include "../../include/job_executor.h"
+#include "../../include/trace.h"
+#include "../../include/sched_log.h"
+#include "../../include/fault_tolerance.h"
+#include "../../include/job_stats.h"
+#include "../../include/timer_wheel.h"
+#include "../../include/mixed_criticality.h"
+#include "../../include/cyclic_schedule.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -9,30 +20,75 @@
 #include <Windows.h>
 
 // External functions
-extern Task *kernel_get_tasks(int *count);
+extern TaskHotTable *kernel_get_hot_tasks(void);
+extern int kernel_read_task(uint32_t taskId, Task *snapshot);
+extern int kernel_read_task_slot(int slot, Task *snapshot);
+extern Task *kernel_task_write_begin(uint32_t taskId);
+extern void kernel_task_write_end(uint32_t taskId);
+extern int kernel_consume_release(uint32_t taskId, uint64_t *releaseUs, uint32_t *skipped);
 extern void kernel_increment_tick(void);
 extern uint64_t kernel_get_tick_count(void);
+extern int kernel_has_dispatchable_task(void);
 
 // Scheduler variables
-static char g_currentPolicy[32] = "ML_HYBRID"; // Default policy
+static SchedPolicyInstance *g_activePolicy = NULL;           // Touched only by the deciding thread
+static SchedPolicyInstance *volatile g_pendingPolicy = NULL; // Adopted at the next decision
+static const SchedPolicy *volatile g_requestedPolicy = NULL; // Latest scheduler_set_policy
+static volatile LONG g_releaseHooked = 0;                    // The requested policy has an onRelease hook
 static uint32_t g_lastJitterNs = 0;
 static uint32_t g_worstCaseJitterNs = 0;
 static uint32_t g_schedulerRuns = 0;
 static SystemStateVector g_currentSystemState = {0};
 static ScheduleDecision g_lastDecision = {0};
+static uint8_t g_cyclicDecided = 0; // The last decision came from a cyclic-executive table
+
+// Releases on their way to the active policy's onRelease hook. Any thread
+// may push; the deciding thread drains it, so hooks never run concurrently.
+// Releases still queued when a new policy is adopted are discarded, so every
+// instance sees only releases that happened while it was active.
+typedef struct
+{
+    volatile LONG sequence;
+    uint32_t taskId;
+    uint64_t releaseUs;
+} ReleaseQueueCell;
+
+static ReleaseQueueCell g_releaseQueue[SCHED_RELEASE_QUEUE_SIZE];
+static volatile LONG g_releaseHead = 0;
+static volatile LONG g_releaseTail = 0;
+static volatile LONG g_releaseOverflows = 0;
 
 // Local functions
-static ScheduleDecision rate_monotonic_schedule(Task *tasks, int count);
-static ScheduleDecision earliest_deadline_schedule(Task *tasks, int count);
-static ScheduleDecision ml_schedule(Task *tasks, int count, SystemStateVector *state);
-static void update_task_metrics(Task *task);
+static void scheduler_adopt_policy(void);
+static void scheduler_drain_releases(SchedPolicyInstance *target);
+static void update_task_metrics(uint32_t taskId);
+static void record_execution_time(uint32_t taskId, uint32_t cpuUs);
+static void record_deadline_misses(uint32_t taskId, uint32_t misses);
+static int kernel_view_read(void *context, int slot, Task *snapshot);
+static float kernel_view_fault_factor(void *context, uint32_t taskId);
+
+static const SchedulerTaskView g_kernelView = {kernel_view_read, kernel_view_fault_factor, NULL};
 
 void scheduler_init(void)
 {
-    printf("Initializing scheduler with %s policy\n", g_currentPolicy);
+    for (int i = 0; i < SCHED_RELEASE_QUEUE_SIZE; i++)
+    {
+        g_releaseQueue[i].sequence = i;
+    }
+    g_releaseHead = 0;
+    g_releaseTail = 0;
+
+    if (!g_requestedPolicy && scheduler_set_policy(SCHEDULER_DEFAULT_POLICY) != 0)
+    {
+        printf("Error: Default scheduling policy %s is not available\n", SCHEDULER_DEFAULT_POLICY);
+        exit(1);
+    }
+    scheduler_adopt_policy();
+    printf("Initializing scheduler with %s policy\n", g_activePolicy->policy->name);
     g_lastJitterNs = 0;
     g_worstCaseJitterNs = 0;
     g_schedulerRuns = 0;
+    g_cyclicDecided = 0;
     memset(&g_lastDecision, 0, sizeof(ScheduleDecision));
 }
 
@@ -47,35 +103,118 @@ void scheduler_tick(void)
     QueryPerformanceFrequency(&frequency);
     QueryPerformanceCounter(&startTime);
 
+    // Shed or restore tasks for the criticality mode before deciding
+    mc_tick(timer_wheel_now_us());
+
     // Get current tasks
-    int taskCount;
-    Task *tasks = kernel_get_tasks(&taskCount);
+    const TaskHotTable *hot = kernel_get_hot_tasks();
 
-    // Simulate FPGA-accelerated scheduling decision
-    ScheduleDecision decision = fpga_scheduler_decide(tasks, taskCount, &g_currentSystemState);
+    // A cyclic-executive table, when one is active, replaces the decision
+    ScheduleDecision decision;
+    g_cyclicDecided = (uint8_t)cyclic_dispatch(hot, timer_wheel_now_us(), &decision);
+    if (!g_cyclicDecided)
+    {
+        // Simulate FPGA-accelerated scheduling decision
+        decision = fpga_scheduler_decide(hot, &g_currentSystemState);
+    }
     g_lastDecision = decision;
+    memory_matrix_write(SHM_SCHEDULER_DECISIONS, &decision, sizeof(ScheduleDecision));
 
     // Simulate executing the selected task
-    if (decision.taskId < taskCount && tasks[decision.taskId].active)
+    // The task's state stays allocated until its job is over, even if the
+    // task is deleted meanwhile; a task deleted since the read is skipped
+    Task snapshot;
+    if (decision.taskId != TASK_INVALID_ID && kernel_read_task(decision.taskId, &snapshot) == 0 && snapshot.active &&
+        checkpoint_pin(snapshot.stateArea) == 0)
     {
-        Task *selectedTask = &tasks[decision.taskId];
-        update_task_metrics(selectedTask);
+        Task *selectedTask = &snapshot;
+        update_task_metrics(selectedTask->id);
+        memory_matrix_set_holder_task(selectedTask->id);
 
-        // For simulation, just print what would be executed
-        printf("Executing task %s (ID: %u) on core %u for %u ms\n",
-               selectedTask->name,
-               selectedTask->id,
-               decision.targetCore,
-               decision.timeSliceMs);
+        // Job boundaries are the safe points for task state: a pending rollback
+        // lands before the job starts and checkpoints are taken after it ends
+        if (selectedTask->stateArea != CHECKPOINT_NO_AREA && checkpoint_apply_pending(selectedTask->stateArea) > 0)
+        {
+            TRACE(TRACE_TASK_ROLLBACK, selectedTask->id, 0, 0, 0);
+        }
 
-        // Simulate task execution - in a real system, the task would run here
-        Sleep(1); // Just a tiny sleep to simulate some work
+        // The job serves the task's oldest pending release, if it has one
+        uint64_t releaseUs = 0;
+        uint32_t skipped = 0;
+        int released = kernel_consume_release(selectedTask->id, &releaseUs, &skipped) == 1;
+        uint64_t startUs = timer_wheel_now_us();
+
+        TRACE(TRACE_SCHED_DECISION, selectedTask->id, decision.targetCore, decision.timeSliceMs, 0);
+        TRACE(TRACE_JOB_BEGIN, selectedTask->id, 0, 0, 0);
+
+        // Replicated tasks run as three voted replicas, the rest on the job
+        // worker under a CPU-time budget
+        int executed;
+        int completed;
+        int outcome;
+        uint32_t cpuUs = 0;
+        if (selectedTask->tmrMode != TMR_MODE_OFF)
+        {
+            outcome = tmr_execute(selectedTask, (uint64_t)selectedTask->deadlineMs * 1000);
+            executed = outcome != -1;
+            completed = outcome == 0;
+        }
+        else
+        {
+            uint32_t budgetUs = BUDGET_ENABLED ? mc_job_budget_us(selectedTask, job_budget_us(selectedTask)) : 0;
+            outcome = job_execute(selectedTask, budgetUs, &cpuUs);
+            executed = outcome != JOB_NOT_RUN;
+            completed = outcome == JOB_COMPLETED || outcome == JOB_OVERRAN;
+            if (executed)
+            {
+                record_execution_time(selectedTask->id, cpuUs);
+            }
+        }
+        uint32_t missed = 0;
+        if (released)
+        {
+            missed = skipped;
+            if (skipped > 0)
+            {
+                job_stats_skip(selectedTask->id, skipped);
+            }
+            missed += (uint32_t)job_stats_record(selectedTask->id, releaseUs, startUs, timer_wheel_now_us(),
+                                                 selectedTask->deadlineMs, completed);
+            if (missed > 0)
+            {
+                record_deadline_misses(selectedTask->id, missed);
+            }
+        }
+        if (executed)
+        {
+            // Replicas run in parallel, so a replicated job is charged its elapsed time
+            uint64_t finishUs = timer_wheel_now_us();
+            mc_job_complete(selectedTask, selectedTask->tmrMode != TMR_MODE_OFF ? (uint32_t)(finishUs - startUs) : cpuUs,
+                            finishUs);
+            sched_policy_complete(g_activePolicy, selectedTask->id, finishUs, missed > 0);
+        }
+        TRACE(TRACE_JOB_END, selectedTask->id, cpuUs, outcome, 0);
+        if (executed)
+        {
+            sched_log_job(selectedTask->id, cpuUs);
+        }
+        if (!executed)
+        {
+            Sleep(1); // Just a tiny sleep to simulate some work
+        }
+        memory_matrix_set_holder_task(MM_NO_TASK);
+        if (selectedTask->stateArea != CHECKPOINT_NO_AREA)
+        {
+            checkpoint_take_if_due(selectedTask->stateArea, CHECKPOINT_PERIOD_MS);
+        }
+        checkpoint_unpin(selectedTask->stateArea);
     }
 
     // Calculate jitter
     QueryPerformanceCounter(&endTime);
     uint64_t elapsed_ns = (endTime.QuadPart - startTime.QuadPart) * 1000000000 / frequency.QuadPart;
     g_lastJitterNs = (uint32_t)elapsed_ns;
+    TRACE(TRACE_SCHED_TICK_NS, elapsed_ns, 0, 0, 0);
 
     if (elapsed_ns > g_worstCaseJitterNs)
     {
@@ -86,6 +225,29 @@ void scheduler_tick(void)
     kernel_increment_tick();
 }
 
+// Tickless mode: the earliest instant the scheduler must decide again, or
+// UINT64_MAX to sleep until an event. Releases, resumes and servers getting
+// work wake it directly, and budgets and time slices end inside the job it
+// just ran, so what is left is work still waiting, the next cyclic-table
+// frame with a job and the criticality mode's next change.
+uint64_t scheduler_next_event_us(void)
+{
+    uint64_t nowUs = timer_wheel_now_us();
+
+    // Back to back while any task is dispatchable. Tasks are dispatchable
+    // only with a release pending (servers only with work and budget), so
+    // this never spins on idle tasks. A cyclic table keeps to its frames,
+    // and a policy that picked nothing waits for the next event.
+    if (!g_cyclicDecided && g_lastDecision.taskId != TASK_INVALID_ID && kernel_has_dispatchable_task())
+    {
+        return nowUs;
+    }
+
+    uint64_t nextUs = cyclic_next_event_us(nowUs);
+    uint64_t modeUs = mc_next_event_us(nowUs);
+    return modeUs < nextUs ? modeUs : nextUs;
+}
+
 ScheduleDecision scheduler_next_task(void)
 {
     return g_lastDecision;
@@ -94,6 +256,7 @@ ScheduleDecision scheduler_next_task(void)
 void scheduler_update_system_state(SystemStateVector *state)
 {
     memcpy(&g_currentSystemState, state, sizeof(SystemStateVector));
+    sched_log_state(state);
 }
 
 uint32_t scheduler_get_jitter_ns(void)
@@ -101,112 +264,192 @@ uint32_t scheduler_get_jitter_ns(void)
     return g_worstCaseJitterNs;
 }
 
-void scheduler_set_policy(const char *policy)
+// Select a registered policy. The scheduler thread swaps it in at its next
+// decision, so a decision is always made by one policy from start to end.
+// Returns 0, or -1 if no policy has that name.
+int scheduler_set_policy(const char *policy)
 {
-    strncpy(g_currentPolicy, policy, sizeof(g_currentPolicy) - 1);
-    g_currentPolicy[sizeof(g_currentPolicy) - 1] = '\0';
-    printf("Scheduler policy changed to %s\n", g_currentPolicy);
-}
-
-// Simulated FPGA scheduler implementation
-ScheduleDecision fpga_scheduler_decide(Task *tasks, int taskCount, SystemStateVector *state)
-{
-    ScheduleDecision decision = {0};
-
-    // Choose scheduling algorithm based on policy
-    if (strcmp(g_currentPolicy, "RMS") == 0)
+    const SchedPolicy *selected = sched_policy_find(policy);
+    if (!selected)
     {
-        // Rate Monotonic Scheduling
-        decision = rate_monotonic_schedule(tasks, taskCount);
+        printf("Error: Unknown scheduling policy %s\n", policy);
+        return -1;
     }
-    else if (strcmp(g_currentPolicy, "EDF") == 0)
+
+    SchedPolicyInstance *instance = (SchedPolicyInstance *)malloc(sizeof(SchedPolicyInstance));
+    if (!instance || sched_policy_instance_init(instance, selected) != 0)
     {
-        // Earliest Deadline First
-        decision = earliest_deadline_schedule(tasks, taskCount);
+        free(instance);
+        return -1;
     }
-    else
+
+    g_requestedPolicy = selected;
+    InterlockedExchange(&g_releaseHooked, selected->onRelease != NULL);
+    SchedPolicyInstance *superseded = (SchedPolicyInstance *)InterlockedExchangePointer(
+        (PVOID volatile *)&g_pendingPolicy, instance);
+    if (superseded)
     {
-        // ML-based hybrid scheduling (default)
-        decision = ml_schedule(tasks, taskCount, state);
+        // Never adopted, so no decision can be using it
+        sched_policy_instance_destroy(superseded);
+        free(superseded);
     }
 
-    return decision;
+    printf("Scheduler policy changed to %s\n", selected->name);
+    return 0;
+}
+
+const char *scheduler_get_policy(void)
+{
+    const SchedPolicy *policy = g_requestedPolicy;
+    return policy ? policy->name : SCHEDULER_DEFAULT_POLICY;
 }
 
-// Implementation of traditional scheduling algorithms
-static ScheduleDecision rate_monotonic_schedule(Task *tasks, int count)
+// Hand a job release to the active policy's onRelease hook at the next decision
+void scheduler_notify_release(uint32_t taskId, uint64_t releaseUs)
 {
-    ScheduleDecision decision = {0};
-    int highest_priority = -1;
+    if (!g_releaseHooked)
+    {
+        return;
+    }
 
-    for (int i = 0; i < count; i++)
+    for (;;)
     {
-        if (tasks[i].active && tasks[i].periodMs > 0)
+        LONG position = g_releaseHead;
+        ReleaseQueueCell *cell = &g_releaseQueue[position & (SCHED_RELEASE_QUEUE_SIZE - 1)];
+        LONG difference = cell->sequence - position;
+
+        if (difference == 0)
         {
-            int priority = 1000000 / tasks[i].periodMs; // Higher priority for shorter period
-            if (priority > highest_priority)
+            if (InterlockedCompareExchange(&g_releaseHead, position + 1, position) == position)
             {
-                highest_priority = priority;
-                decision.taskId = tasks[i].id;
-                decision.targetCore = tasks[i].coreAffinity;
-                decision.timeSliceMs = tasks[i].executionTimeMs;
+                cell->taskId = taskId;
+                cell->releaseUs = releaseUs;
+                MemoryBarrier();
+                cell->sequence = position + 1; // Publish to the deciding thread
+                return;
             }
         }
+        else if (difference < 0)
+        {
+            InterlockedIncrement(&g_releaseOverflows); // Full; the policy never sees this release
+            return;
+        }
+        else
+        {
+            YieldProcessor(); // Another producer claimed this position
+        }
     }
-
-    return decision;
 }
 
-static ScheduleDecision earliest_deadline_schedule(Task *tasks, int count)
+// Single consumer, so the tail needs no compare-exchange. A NULL target
+// drops the queued releases.
+static void scheduler_drain_releases(SchedPolicyInstance *target)
 {
-    ScheduleDecision decision = {0};
-    uint32_t earliest_deadline = UINT32_MAX;
-
-    for (int i = 0; i < count; i++)
+    for (;;)
     {
-        if (tasks[i].active && tasks[i].deadlineMs < earliest_deadline)
+        LONG position = g_releaseTail;
+        ReleaseQueueCell *cell = &g_releaseQueue[position & (SCHED_RELEASE_QUEUE_SIZE - 1)];
+        if (cell->sequence != position + 1)
         {
-            earliest_deadline = tasks[i].deadlineMs;
-            decision.taskId = tasks[i].id;
-            decision.targetCore = tasks[i].coreAffinity;
-            decision.timeSliceMs = tasks[i].executionTimeMs;
+            return; // Empty
         }
-    }
 
-    return decision;
+        uint32_t taskId = cell->taskId;
+        uint64_t releaseUs = cell->releaseUs;
+        MemoryBarrier();
+        cell->sequence = position + SCHED_RELEASE_QUEUE_SIZE; // Hand back to producers
+        g_releaseTail = position + 1;
+        if (target)
+        {
+            sched_policy_release(target, taskId, releaseUs);
+        }
+    }
 }
 
-static ScheduleDecision ml_schedule(Task *tasks, int count, SystemStateVector *state)
+// Tick boundary: swap in the policy selected since the last decision
+static void scheduler_adopt_policy(void)
 {
-    ScheduleDecision decision = {0};
-    float highest_score = -1.0f;
+    if (!g_pendingPolicy)
+    {
+        return;
+    }
 
-    for (int i = 0; i < count; i++)
+    SchedPolicyInstance *next = (SchedPolicyInstance *)InterlockedExchangePointer(
+        (PVOID volatile *)&g_pendingPolicy, NULL);
+    if (next)
     {
-        if (tasks[i].active)
+        SchedPolicyInstance *previous = g_activePolicy;
+        scheduler_drain_releases(NULL); // Queued for the old instance's view of time
+        g_activePolicy = next;
+        if (previous)
         {
-            // Use ML engine to compute dynamic priority
-            float score = compute_dynamic_priority(&tasks[i], state);
-
-            if (score > highest_score)
-            {
-                highest_score = score;
-                decision.taskId = tasks[i].id;
-                decision.targetCore = tasks[i].coreAffinity;
-                decision.timeSliceMs = tasks[i].executionTimeMs;
-            }
+            sched_policy_instance_destroy(previous);
+            free(previous);
         }
     }
+}
 
-    return decision;
+// Simulated FPGA scheduler implementation
+ScheduleDecision fpga_scheduler_decide(const TaskHotTable *hot, SystemStateVector *state)
+{
+    scheduler_adopt_policy();
+    scheduler_drain_releases(g_activePolicy);
+    return sched_policy_pick(g_activePolicy, hot, state, &g_kernelView);
+}
+
+static int kernel_view_read(void *context, int slot, Task *snapshot)
+{
+    (void)context;
+    return kernel_read_task_slot(slot, snapshot);
+}
+
+static float kernel_view_fault_factor(void *context, uint32_t taskId)
+{
+    (void)context;
+    return get_fault_recovery_factor(taskId);
 }
 
-static void update_task_metrics(Task *task)
+static void update_task_metrics(uint32_t taskId)
 {
+    // Readers see either the old or the new history, never a half-shifted one
+    Task *task = kernel_task_write_begin(taskId);
+    if (!task)
+    {
+        return;
+    }
+
     // Shift execution history and add new data point
     for (int i = 9; i > 0; i--)
     {
         task->executionHistory[i] = task->executionHistory[i - 1];
     }
     task->executionHistory[0] = (float)task->lastExecutionTime;
+
+    kernel_task_write_end(taskId);
+}
+
+// CPU time of the job just run; enters the history on the task's next run
+static void record_execution_time(uint32_t taskId, uint32_t cpuUs)
+{
+    Task *task = kernel_task_write_begin(taskId);
+    if (!task)
+    {
+        return;
+    }
+
+    task->lastExecutionTime = cpuUs / 1000;
+    kernel_task_write_end(taskId);
+}
+
+// Deadline misses feed the ML model's missed-deadline feature
+static void record_deadline_misses(uint32_t taskId, uint32_t misses)
+{
+    Task *task = kernel_task_write_begin(taskId);
+    if (!task)
+    {
+        return;
+    }
+
+    task->missedDeadlines += misses;
+    kernel_task_write_end(taskId);
 }
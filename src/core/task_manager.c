@@ -1,6 +1,11 @@
 #include "../../include/task_manager.h"
 #include "../../include/system_config.h"
 #include "../../include/fault_tolerance.h"
+#include "../../include/timer_wheel.h"
+#include "../../include/checkpoint.h"
+#include "../../include/trace.h"
+#include "../../include/schedulability.h"
+#include "../../include/reservation_server.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -9,9 +14,17 @@
 
 // External function declarations
 extern int kernel_add_task(Task *task);
-extern Task *kernel_get_tasks(int *count);
+extern int kernel_remove_task(uint32_t taskId);
+extern int kernel_read_task(uint32_t taskId, Task *snapshot);
 extern int kernel_get_running(void);
+extern int kernel_set_task_active(uint32_t taskId, uint8_t active);
+extern int kernel_set_task_priority(uint32_t taskId, uint32_t basePriority, uint32_t dynamicPriority);
 extern uint64_t kernel_get_tick_count(void);
+extern int kernel_set_task_execution_time(uint32_t taskId, uint32_t executionTimeMs);
+extern int kernel_set_task_sporadic(uint32_t taskId);
+extern int kernel_release_task(uint32_t taskId);
+extern Task *kernel_task_write_begin(uint32_t taskId);
+extern void kernel_task_write_end(uint32_t taskId);
 
 // Current task being executed
 static Task *g_currentTask = NULL;
@@ -20,12 +33,49 @@ static uint32_t g_nextTaskId = 0;
 int task_create(Task *task, char *name, void (*entryPoint)(void *),
                 void *args, uint32_t periodMs, uint32_t deadlineMs,
                 CriticalityLevel criticality)
+{
+    return task_create_ex(task, name, entryPoint, args, periodMs, deadlineMs, 0, criticality);
+}
+
+// Create a task with a known worst-case execution time (0 estimates it as
+// 10% of the period). Periodic tasks pass admission control first: a task
+// that would make the admitted set miss deadlines under the current policy
+// is refused, or admitted at a longer period in ADMISSION_DEGRADE mode.
+int task_create_ex(Task *task, char *name, void (*entryPoint)(void *),
+                   void *args, uint32_t periodMs, uint32_t deadlineMs,
+                   uint32_t executionTimeMs, CriticalityLevel criticality)
 {
     if (!task || !name || !entryPoint)
     {
         return -1; // Invalid parameters
     }
 
+    // The RMS and EDF keys; the dispatch scans skip zero keys
+    if (periodMs == 0 || deadlineMs == 0)
+    {
+        printf("Error: Task '%s' needs a non-zero period and deadline\n", name);
+        return -1;
+    }
+
+    if (executionTimeMs == 0)
+    {
+        executionTimeMs = periodMs / 10; // Estimate execution time as 10% of period
+    }
+
+    uint32_t requestedPeriodMs = periodMs;
+    uint32_t reservation = 0;
+    AdmissionVerdict verdict = sched_analysis_admit(&periodMs, &deadlineMs, executionTimeMs, &reservation);
+    if (verdict == ADMISSION_REJECTED)
+    {
+        printf("Admission: Task '%s' rejected, %u ms every %u ms is not schedulable\n", name, executionTimeMs,
+               periodMs);
+        return -1;
+    }
+    if (verdict == ADMISSION_DEGRADED)
+    {
+        printf("Admission: Task '%s' degraded from %u ms to %u ms period\n", name, requestedPeriodMs, periodMs);
+    }
+
     // Initialize task structure
     memset(task, 0, sizeof(Task));
     strncpy(task->name, name, sizeof(task->name) - 1);
@@ -33,12 +83,18 @@ int task_create(Task *task, char *name, void (*entryPoint)(void *),
     task->args = args;
     task->periodMs = periodMs;
     task->deadlineMs = deadlineMs;
-    task->executionTimeMs = periodMs / 10; // Estimate execution time as 10% of period
+    task->executionTimeMs = executionTimeMs;
     task->basePriority = 8;                // Mid priority by default
     task->dynamicPriority = 8;
     task->criticality = criticality;
     task->coreAffinity = 0; // Default to first core
     task->active = 1;
+    task->tmrMode = (TMR_ENABLED && criticality <= TMR_MIN_CRITICALITY) ? TMR_MODE_EARLY : TMR_MODE_OFF;
+
+    // Critical jobs are never cut short; the least critical are aborted on overrun
+    task->overrunAction = criticality <= DAL_B ? BUDGET_ACTION_NOTIFY
+                          : criticality == DAL_C ? BUDGET_ACTION_DEMOTE
+                                                 : BUDGET_ACTION_ABORT;
 
     // Initialize execution history with estimated execution time
     for (int i = 0; i < 10; i++)
@@ -51,7 +107,10 @@ int task_create(Task *task, char *name, void (*entryPoint)(void *),
     if (taskId >= 0)
     {
         task->id = taskId;
+        sched_analysis_commit(reservation, taskId);
         printf("Task '%s' created with ID %d\n", name, taskId);
+        trace_task_name(taskId, name);
+        TRACE(TRACE_TASK_CREATE, taskId, periodMs, deadlineMs, criticality);
 
         // Set watchdog for critical tasks
         if (criticality == DAL_A || criticality == DAL_B)
@@ -62,18 +121,22 @@ int task_create(Task *task, char *name, void (*entryPoint)(void *),
         return taskId;
     }
 
+    sched_analysis_cancel(reservation);
     return -1; // Failed to add task
 }
 
 void task_delete(uint32_t taskId)
 {
-    int count;
-    Task *tasks = kernel_get_tasks(&count);
+    Task snapshot;
 
-    if (taskId < count)
+    // The slot is recycled, so the ID stops resolving from here on. The
+    // task's state is freed once a job still running for it is over.
+    if (kernel_read_task(taskId, &snapshot) == 0 && kernel_remove_task(taskId) == 0)
     {
-        tasks[taskId].active = 0;
-        printf("Task '%s' (ID: %u) deleted\n", tasks[taskId].name, taskId);
+        checkpoint_destroy(snapshot.stateArea);
+        sched_analysis_remove(taskId);
+        printf("Task '%s' (ID: %u) deleted\n", snapshot.name, taskId);
+        TRACE(TRACE_TASK_DELETE, taskId, 0, 0, 0);
     }
 }
 
@@ -85,38 +148,36 @@ Task *task_get_current(void)
 void task_yield(void)
 {
     // In a real RTOS this would yield execution to the next task
-    // For our simulation, we just print a message
-    printf("Task '%s' yielded execution\n", g_currentTask ? g_currentTask->name : "Unknown");
+    // For our simulation, we just record it
+    TRACE(TRACE_TASK_YIELD, g_currentTask ? g_currentTask->id : TASK_INVALID_ID, 0, 0, 0);
     Sleep(1); // Small sleep to simulate yielding
 }
 
 void task_delay(uint32_t milliseconds)
 {
     // Simulate task delay
-    printf("Task '%s' delayed for %u ms\n", g_currentTask ? g_currentTask->name : "Unknown", milliseconds);
-    Sleep(milliseconds); // Use Windows Sleep for simulation
+    TRACE(TRACE_TASK_DELAY, g_currentTask ? g_currentTask->id : TASK_INVALID_ID, milliseconds, 0, 0);
+    timer_wheel_sleep_us((uint64_t)milliseconds * 1000); // Wakes on the timer wheel, not the 1 ms system tick
 }
 
 void task_set_priority(uint32_t taskId, uint32_t priority)
 {
-    int count;
-    Task *tasks = kernel_get_tasks(&count);
+    Task snapshot;
 
-    if (taskId < count && priority < MAX_PRIORITY_LEVELS)
+    if (priority < MAX_PRIORITY_LEVELS && kernel_read_task(taskId, &snapshot) == 0 &&
+        kernel_set_task_priority(taskId, priority, snapshot.dynamicPriority) == 0)
     {
-        tasks[taskId].basePriority = priority;
-        printf("Task '%s' priority set to %u\n", tasks[taskId].name, priority);
+        TRACE(TRACE_TASK_PRIORITY, taskId, priority, 0, 0);
     }
 }
 
 int task_ready(uint32_t taskId)
 {
-    int count;
-    Task *tasks = kernel_get_tasks(&count);
+    Task snapshot;
 
-    if (taskId < count)
+    if (kernel_read_task(taskId, &snapshot) == 0)
     {
-        return tasks[taskId].active;
+        return snapshot.active;
     }
 
     return 0; // Task not found or not ready
@@ -124,17 +185,13 @@ int task_ready(uint32_t taskId)
 
 int task_suspend(uint32_t taskId)
 {
-    int count;
-    Task *tasks = kernel_get_tasks(&count);
+    Task snapshot;
 
-    if (taskId < count)
+    // The setter reports the previous state, so racing suspends succeed once
+    if (kernel_read_task(taskId, &snapshot) == 0 && kernel_set_task_active(taskId, 0) == 1)
     {
-        if (tasks[taskId].active)
-        {
-            tasks[taskId].active = 0;
-            printf("Task '%s' suspended\n", tasks[taskId].name);
-            return 0; // Success
-        }
+        TRACE(TRACE_TASK_SUSPEND, taskId, 0, 0, 0);
+        return 0; // Success
     }
 
     return -1; // Failed
@@ -142,18 +199,165 @@ int task_suspend(uint32_t taskId)
 
 int task_resume(uint32_t taskId)
 {
-    int count;
-    Task *tasks = kernel_get_tasks(&count);
+    Task snapshot;
+
+    // A task attached to a server only runs inside it
+    if (kernel_read_task(taskId, &snapshot) == 0 && !snapshot.server && kernel_set_task_active(taskId, 1) == 0)
+    {
+        TRACE(TRACE_TASK_RESUME, taskId, 0, 0, 0);
+        return 0; // Success
+    }
+
+    return -1; // Failed
+}
+
+int task_set_tmr_mode(uint32_t taskId, TmrMode mode)
+{
+    Task *task = kernel_task_write_begin(taskId);
+    if (!task)
+    {
+        return -1;
+    }
+
+    task->tmrMode = (uint8_t)mode;
+    kernel_task_write_end(taskId);
+    return 0;
+}
+
+int task_set_overrun_action(uint32_t taskId, BudgetAction action)
+{
+    Task *task = kernel_task_write_begin(taskId);
+    if (!task)
+    {
+        return -1;
+    }
+
+    task->overrunAction = (uint8_t)action;
+    kernel_task_write_end(taskId);
+    return 0;
+}
+
+// Replace the estimated execution time (10% of the period) with a known one
+// Fails if the new execution time would break the admitted set
+int task_set_execution_time(uint32_t taskId, uint32_t executionTimeMs)
+{
+    if (sched_analysis_update(taskId, executionTimeMs) != 0)
+    {
+        printf("Admission: Execution time of task %u cannot grow to %u ms\n", taskId, executionTimeMs);
+        return -1;
+    }
+    return kernel_set_task_execution_time(taskId, executionTimeMs);
+}
+
+// Per-mode CPU budgets for mixed-criticality scheduling, indexed by
+// CriticalityLevel. A job running past the budget of the current mode
+// raises the mode; entries more critical than the task itself are ignored.
+// Refused if a raised mode would not be schedulable with them, since the
+// executor then lets the task run for its own level's budget.
+int task_set_criticality_budgets(uint32_t taskId, const uint32_t budgetMs[4])
+{
+    Task snapshot;
+    if (kernel_read_task(taskId, &snapshot) != 0)
+    {
+        return -1;
+    }
 
-    if (taskId < count)
+    // A more critical mode never has less time than a less critical one
+    uint32_t floorMs = 0;
+    for (int level = DAL_D; level >= (int)snapshot.criticality; level--)
     {
-        if (!tasks[taskId].active)
+        if (budgetMs[level] > 0 && budgetMs[level] < floorMs)
         {
-            tasks[taskId].active = 1;
-            printf("Task '%s' resumed\n", tasks[taskId].name);
-            return 0; // Success
+            printf("Error: Criticality budgets of task %u shrink at DAL_%c\n", taskId, 'A' + level);
+            return -1;
         }
+        floorMs = budgetMs[level] > floorMs ? budgetMs[level] : floorMs;
     }
 
-    return -1; // Failed
+    if (AMC_ENABLED && !sched_analysis_check_modes(taskId, snapshot.criticality, budgetMs))
+    {
+        printf("Error: Criticality budgets of task %u leave a raised mode unschedulable\n", taskId);
+        return -1;
+    }
+
+    Task *task = kernel_task_write_begin(taskId);
+    if (!task)
+    {
+        return -1;
+    }
+    for (int level = DAL_A; level <= DAL_D; level++)
+    {
+        task->criticalityBudgetMs[level] = level >= (int)task->criticality ? budgetMs[level] : 0;
+    }
+    kernel_task_write_end(taskId);
+    return 0;
+}
+
+// Make a task sporadic: jobs are released by task_release instead of every period
+int task_set_sporadic(uint32_t taskId)
+{
+    return kernel_set_task_sporadic(taskId);
+}
+
+// Release one job of a task, e.g. on an external event
+int task_release(uint32_t taskId)
+{
+    Task snapshot;
+
+    // Jobs of a task attached to a server queue on the server
+    if (kernel_read_task(taskId, &snapshot) == 0 && snapshot.server)
+    {
+        return server_submit(snapshot.server - 1, snapshot.entryPoint, snapshot.args, snapshot.executionTimeMs);
+    }
+    return kernel_release_task(taskId);
+}
+
+// Register the buffer a task's results are committed to. Under TMR each
+// replica writes its own copy (see tmr_replica_output) and only the voted
+// result reaches this buffer.
+int task_set_output(uint32_t taskId, void *output, uint32_t outputSize)
+{
+    Task *task = kernel_task_write_begin(taskId);
+    if (!task)
+    {
+        return -1;
+    }
+
+    task->output = output;
+    task->outputSize = output ? outputSize : 0;
+    kernel_task_write_end(taskId);
+    return 0;
+}
+
+// Allocate checkpointed state for a task and make it the task's output.
+// Writes are tracked per page, so periodic checkpoints copy only what the
+// task changed, and a MEMORY_FAULT rolls the state back before the next job.
+void *task_alloc_state(uint32_t taskId, uint32_t size)
+{
+    Task snapshot;
+    void *state = NULL;
+
+    if (kernel_read_task(taskId, &snapshot) != 0 || snapshot.stateArea != CHECKPOINT_NO_AREA)
+    {
+        return NULL;
+    }
+
+    int areaId = checkpoint_create(size, snapshot.name, &state);
+    if (areaId < 0)
+    {
+        return NULL;
+    }
+
+    Task *task = kernel_task_write_begin(taskId);
+    if (!task)
+    {
+        checkpoint_destroy(areaId);
+        return NULL;
+    }
+
+    task->output = state;
+    task->outputSize = size;
+    task->stateArea = areaId;
+    kernel_task_write_end(taskId);
+    return state;
 }
@@ -0,0 +1,165 @@
+#include "../../include/task_table.h"
+#include "../../include/system_config.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+static size_t align_up(size_t size)
+{
+    return (size + TASK_TABLE_ALIGNMENT - 1) & ~(size_t)(TASK_TABLE_ALIGNMENT - 1);
+}
+
+static void *aligned_block_alloc(size_t size)
+{
+#ifdef _WIN32
+    return _aligned_malloc(size, TASK_TABLE_ALIGNMENT);
+#else
+    return aligned_alloc(TASK_TABLE_ALIGNMENT, size);
+#endif
+}
+
+static void aligned_block_free(void *block)
+{
+#ifdef _WIN32
+    _aligned_free(block);
+#else
+    free(block);
+#endif
+}
+
+TaskHotTable *task_table_create(int capacity, Task *const *coldChunks)
+{
+    TaskHotTable *hot = (TaskHotTable *)calloc(1, sizeof(TaskHotTable));
+    if (!hot)
+    {
+        return NULL;
+    }
+
+    // Carve every field array out of one block, each starting on a cache line
+    size_t bytes8 = align_up((size_t)capacity * sizeof(uint8_t));
+    size_t bytes16 = align_up((size_t)capacity * sizeof(uint16_t));
+    size_t bytes32 = align_up((size_t)capacity * sizeof(uint32_t));
+    size_t total = 4 * bytes8 + bytes16 + 5 * bytes32;
+
+    uint8_t *block = (uint8_t *)aligned_block_alloc(total);
+    if (!block)
+    {
+        free(hot);
+        return NULL;
+    }
+    memset(block, 0, total);
+
+    hot->block = block;
+    hot->active = block;
+    hot->allocated = block + bytes8;
+    hot->criticality = block + 2 * bytes8;
+    hot->coreAffinity = block + 3 * bytes8;
+    hot->generation = (uint16_t *)(block + 4 * bytes8);
+    hot->periodMs = (uint32_t *)(block + 4 * bytes8 + bytes16);
+    hot->deadlineMs = hot->periodMs + bytes32 / sizeof(uint32_t);
+    hot->executionTimeMs = hot->deadlineMs + bytes32 / sizeof(uint32_t);
+    hot->basePriority = hot->executionTimeMs + bytes32 / sizeof(uint32_t);
+    hot->dynamicPriority = hot->basePriority + bytes32 / sizeof(uint32_t);
+    hot->count = 0;
+    hot->capacity = capacity;
+    hot->coldChunks = coldChunks;
+    hot->retired = NULL;
+
+    return hot;
+}
+
+void task_table_destroy(TaskHotTable *hot)
+{
+    if (hot)
+    {
+        aligned_block_free(hot->block);
+        free(hot);
+    }
+}
+
+void task_table_copy(TaskHotTable *dst, const TaskHotTable *src)
+{
+    size_t n = (size_t)src->count;
+
+    memcpy(dst->active, src->active, n);
+    memcpy(dst->allocated, src->allocated, n);
+    memcpy(dst->criticality, src->criticality, n);
+    memcpy(dst->coreAffinity, src->coreAffinity, n);
+    memcpy(dst->generation, src->generation, n * sizeof(uint16_t));
+    memcpy(dst->periodMs, src->periodMs, n * sizeof(uint32_t));
+    memcpy(dst->deadlineMs, src->deadlineMs, n * sizeof(uint32_t));
+    memcpy(dst->executionTimeMs, src->executionTimeMs, n * sizeof(uint32_t));
+    memcpy(dst->basePriority, src->basePriority, n * sizeof(uint32_t));
+    memcpy(dst->dynamicPriority, src->dynamicPriority, n * sizeof(uint32_t));
+    dst->count = src->count;
+}
+
+void task_table_store(TaskHotTable *hot, int slot, const Task *task)
+{
+    hot->active[slot] = task->active;
+    hot->criticality[slot] = (uint8_t)task->criticality;
+    hot->coreAffinity[slot] = task->coreAffinity;
+    hot->periodMs[slot] = task->periodMs;
+    hot->deadlineMs[slot] = task->deadlineMs;
+    hot->executionTimeMs[slot] = task->executionTimeMs;
+    hot->basePriority[slot] = task->basePriority;
+    hot->dynamicPriority[slot] = task->dynamicPriority;
+}
+
+void task_table_load(const TaskHotTable *hot, int slot, Task *task)
+{
+    task->active = hot->active[slot];
+    task->criticality = (CriticalityLevel)hot->criticality[slot];
+    task->coreAffinity = hot->coreAffinity[slot];
+    task->periodMs = hot->periodMs[slot];
+    task->deadlineMs = hot->deadlineMs[slot];
+    task->executionTimeMs = hot->executionTimeMs[slot];
+    task->basePriority = hot->basePriority[slot];
+    task->dynamicPriority = hot->dynamicPriority[slot];
+}
+
+Task *task_table_cold(const TaskHotTable *hot, int slot)
+{
+    Task *chunk = hot->coldChunks[slot / TASK_TABLE_CHUNK_SIZE];
+    return chunk ? &chunk[slot % TASK_TABLE_CHUNK_SIZE] : NULL;
+}
+
+uint32_t task_table_handle(const TaskHotTable *hot, int slot)
+{
+    return TASK_HANDLE_MAKE(slot, hot->generation[slot]);
+}
+
+// Index of the smallest non-zero key among active tasks, or -1 if none.
+// task_create_ex refuses zero periods and deadlines, so no task is skipped.
+// Split into a branch-free reduction and a short search so the first pass
+// vectorizes; ties resolve to the lowest slot like the scalar scans did.
+int task_table_argmin(const TaskHotTable *hot, const uint32_t *keys)
+{
+    int count = hot->count;
+    uint32_t best = UINT32_MAX;
+
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t key = (hot->active[i] && keys[i] > 0) ? keys[i] : UINT32_MAX;
+        best = key < best ? key : best;
+    }
+
+    if (best == UINT32_MAX)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (hot->active[i] && keys[i] == best)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,453 @@
+#include "../../include/timer_wheel.h"
+#include "../../include/system_config.h"
+#include "../../include/trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+#define WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_MAX_DELTA ((1ULL << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1)
+
+// Timer states
+enum
+{
+    TIMER_IDLE,
+    TIMER_ARMED,
+    TIMER_FIRING // Periodic timer whose callback is running
+};
+
+// Wheel levels; each slot is the sentinel head of a circular list
+static TimerWheelTimer g_wheel[TIMER_WHEEL_LEVELS][WHEEL_SLOTS];
+static TimerWheelTimer g_expired;
+static uint64_t g_currentTick = 0; // Next tick to process
+static uint64_t g_sleepUntilTick = UINT64_MAX;
+static uint32_t g_armedCount = 0;
+static CRITICAL_SECTION g_wheelLock;
+static HANDLE g_wheelThread = NULL;
+static HANDLE g_wheelTimer = NULL;
+static HANDLE g_wheelWake = NULL;
+static volatile int g_wheelRunning = 0;
+static int g_highResolution = 0;
+static int g_initialized = 0;
+static LARGE_INTEGER g_wheelFrequency;
+static LARGE_INTEGER g_wheelStart;
+
+static void list_init(TimerWheelTimer *head)
+{
+    head->next = head;
+    head->prev = head;
+}
+
+static int list_empty(const TimerWheelTimer *head)
+{
+    return head->next == head;
+}
+
+static void list_append(TimerWheelTimer *head, TimerWheelTimer *timer)
+{
+    timer->prev = head->prev;
+    timer->next = head;
+    head->prev->next = timer;
+    head->prev = timer;
+}
+
+static void list_unlink(TimerWheelTimer *timer)
+{
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->next = NULL;
+    timer->prev = NULL;
+}
+
+static uint64_t now_tick(void)
+{
+    return timer_wheel_now_us() / TIMER_WHEEL_TICK_US;
+}
+
+// Place a timer on the level whose span covers its remaining delay
+static void wheel_insert(TimerWheelTimer *timer)
+{
+    uint64_t expires = timer->expiresTick;
+    uint64_t delta;
+
+    if (expires < g_currentTick)
+    {
+        expires = g_currentTick; // Already due, fire on the next advance
+    }
+    delta = expires - g_currentTick;
+    if (delta > WHEEL_MAX_DELTA)
+    {
+        // Park far timers in the last slot; they re-cascade until in range
+        delta = WHEEL_MAX_DELTA;
+        expires = g_currentTick + WHEEL_MAX_DELTA;
+    }
+
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1ULL << ((level + 1) * TIMER_WHEEL_SLOT_BITS)))
+    {
+        level++;
+    }
+
+    int slot = (int)((expires >> (level * TIMER_WHEEL_SLOT_BITS)) & WHEEL_MASK);
+    list_append(&g_wheel[level][slot], timer);
+}
+
+// Redistribute one higher-level slot onto the levels below it
+static void wheel_cascade(int level, int index)
+{
+    TimerWheelTimer pending;
+    TimerWheelTimer *head = &g_wheel[level][index];
+
+    if (list_empty(head))
+    {
+        return;
+    }
+
+    // Detach the whole slot first, since re-insertion may target it again
+    pending.next = head->next;
+    pending.prev = head->prev;
+    pending.next->prev = &pending;
+    pending.prev->next = &pending;
+    list_init(head);
+
+    while (!list_empty(&pending))
+    {
+        TimerWheelTimer *timer = pending.next;
+        list_unlink(timer);
+        wheel_insert(timer);
+    }
+}
+
+// Move everything due up to targetTick onto the expired list
+static void wheel_advance_to(uint64_t targetTick)
+{
+    if (g_armedCount == 0)
+    {
+        // Nothing to expire, so no cascade can matter either
+        if (targetTick >= g_currentTick)
+        {
+            g_currentTick = targetTick + 1;
+        }
+        return;
+    }
+
+    while (g_currentTick <= targetTick)
+    {
+        int index = (int)(g_currentTick & WHEEL_MASK);
+
+        if (index == 0)
+        {
+            for (int level = 1; level < TIMER_WHEEL_LEVELS; level++)
+            {
+                int levelIndex = (int)((g_currentTick >> (level * TIMER_WHEEL_SLOT_BITS)) & WHEEL_MASK);
+                wheel_cascade(level, levelIndex);
+                if (levelIndex != 0)
+                {
+                    break;
+                }
+            }
+        }
+
+        TimerWheelTimer *head = &g_wheel[0][index];
+        while (!list_empty(head))
+        {
+            TimerWheelTimer *timer = head->next;
+            list_unlink(timer);
+            list_append(&g_expired, timer);
+        }
+
+        g_currentTick++;
+    }
+}
+
+// Fire all due timers. Callbacks run without the wheel lock held; one-shot
+// timers are never touched after their callback starts, so a waiter may
+// reuse or release the timer as soon as it has been signalled.
+static void wheel_fire_expired(void)
+{
+    EnterCriticalSection(&g_wheelLock);
+    wheel_advance_to(now_tick());
+
+    while (!list_empty(&g_expired))
+    {
+        TimerWheelTimer *timer = g_expired.next;
+        TimerCallback callback = timer->callback;
+        void *arg = timer->arg;
+        int periodic = timer->periodTicks > 0;
+
+        list_unlink(timer);
+        g_armedCount--;
+        timer->state = periodic ? TIMER_FIRING : TIMER_IDLE;
+
+        LeaveCriticalSection(&g_wheelLock);
+        callback(arg);
+        EnterCriticalSection(&g_wheelLock);
+
+        // Re-arm unless the callback or another thread cancelled or re-armed it
+        if (periodic && timer->state == TIMER_FIRING)
+        {
+            timer->expiresTick += timer->periodTicks;
+            timer->state = TIMER_ARMED;
+            g_armedCount++;
+            wheel_insert(timer);
+        }
+    }
+
+    LeaveCriticalSection(&g_wheelLock);
+}
+
+// Earliest tick the wheel must be serviced at (caller holds the lock)
+static uint64_t wheel_next_tick(void)
+{
+    if (!list_empty(&g_expired))
+    {
+        return g_currentTick;
+    }
+    if (g_armedCount == 0)
+    {
+        return UINT64_MAX;
+    }
+
+    // Scan level 0 up to the next cascade boundary; past it we wake to cascade
+    uint64_t boundary = (g_currentTick | WHEEL_MASK) + 1;
+    for (uint64_t tick = g_currentTick; tick < boundary; tick++)
+    {
+        if (!list_empty(&g_wheel[0][tick & WHEEL_MASK]))
+        {
+            return tick;
+        }
+    }
+
+    return boundary;
+}
+
+static DWORD WINAPI timer_wheel_thread_func(LPVOID lpParam)
+{
+    trace_thread_name("timer wheel");
+    while (g_wheelRunning)
+    {
+        wheel_fire_expired();
+
+        EnterCriticalSection(&g_wheelLock);
+        uint64_t nextTick = wheel_next_tick();
+        g_sleepUntilTick = nextTick;
+        LeaveCriticalSection(&g_wheelLock);
+
+        if (nextTick == UINT64_MAX)
+        {
+            WaitForSingleObject(g_wheelWake, INFINITE);
+            continue;
+        }
+
+        uint64_t nowUs = timer_wheel_now_us();
+        uint64_t dueUs = nextTick * TIMER_WHEEL_TICK_US;
+        if (dueUs <= nowUs)
+        {
+            continue;
+        }
+
+        // Relative due time in 100 ns units
+        LARGE_INTEGER due;
+        due.QuadPart = -(LONGLONG)((dueUs - nowUs) * 10);
+        SetWaitableTimer(g_wheelTimer, &due, 0, NULL, NULL, FALSE);
+
+        HANDLE handles[2] = {g_wheelTimer, g_wheelWake};
+        WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+    }
+
+    return 0;
+}
+
+void timer_wheel_init(void)
+{
+    if (g_initialized)
+    {
+        return;
+    }
+
+    QueryPerformanceFrequency(&g_wheelFrequency);
+    QueryPerformanceCounter(&g_wheelStart);
+    InitializeCriticalSection(&g_wheelLock);
+
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        for (int slot = 0; slot < WHEEL_SLOTS; slot++)
+        {
+            list_init(&g_wheel[level][slot]);
+        }
+    }
+    list_init(&g_expired);
+
+    g_currentTick = 0;
+    g_armedCount = 0;
+    g_initialized = 1;
+    printf("Timer wheel initialized: %d levels x %d slots, %d us resolution\n",
+           TIMER_WHEEL_LEVELS, WHEEL_SLOTS, TIMER_WHEEL_TICK_US);
+}
+
+void timer_wheel_start(void)
+{
+    if (!g_initialized || g_wheelRunning)
+    {
+        return;
+    }
+
+    // Prefer a high-resolution waitable timer; fall back to a 1 ms system timer period
+    g_wheelTimer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    g_highResolution = g_wheelTimer != NULL;
+    if (!g_highResolution)
+    {
+        timeBeginPeriod(1);
+        g_wheelTimer = CreateWaitableTimer(NULL, FALSE, NULL);
+    }
+    g_wheelWake = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (g_wheelTimer == NULL || g_wheelWake == NULL)
+    {
+        printf("Error: Failed to create timer wheel wait objects\n");
+        exit(1);
+    }
+
+    g_wheelRunning = 1;
+    g_wheelThread = CreateThread(NULL, 0, timer_wheel_thread_func, NULL, 0, NULL);
+    if (g_wheelThread == NULL)
+    {
+        printf("Error: Failed to create timer wheel thread\n");
+        exit(1);
+    }
+    SetThreadPriority(g_wheelThread, THREAD_PRIORITY_TIME_CRITICAL);
+}
+
+void timer_wheel_stop(void)
+{
+    if (!g_wheelRunning)
+    {
+        return;
+    }
+
+    g_wheelRunning = 0;
+    SetEvent(g_wheelWake);
+    WaitForSingleObject(g_wheelThread, INFINITE);
+
+    CloseHandle(g_wheelThread);
+    CloseHandle(g_wheelTimer);
+    CloseHandle(g_wheelWake);
+    if (!g_highResolution)
+    {
+        timeEndPeriod(1);
+    }
+}
+
+uint64_t timer_wheel_now_us(void)
+{
+    LARGE_INTEGER current;
+    QueryPerformanceCounter(&current);
+    return (uint64_t)(current.QuadPart - g_wheelStart.QuadPart) * 1000000ULL / (uint64_t)g_wheelFrequency.QuadPart;
+}
+
+// Arm (or re-arm) a timer. The first expiry is delayUs from now, rounded up
+// to the wheel resolution so it never fires early; periodUs > 0 makes it periodic.
+void timer_wheel_arm(TimerWheelTimer *timer, uint64_t delayUs, uint64_t periodUs,
+                     TimerCallback callback, void *arg)
+{
+    uint64_t periodTicks = (periodUs + TIMER_WHEEL_TICK_US - 1) / TIMER_WHEEL_TICK_US;
+    int wake = 0;
+
+    EnterCriticalSection(&g_wheelLock);
+
+    if (timer->state == TIMER_ARMED)
+    {
+        list_unlink(timer);
+        g_armedCount--;
+    }
+
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->periodTicks = periodTicks;
+    timer->expiresTick = (timer_wheel_now_us() + delayUs + TIMER_WHEEL_TICK_US - 1) / TIMER_WHEEL_TICK_US;
+    timer->state = TIMER_ARMED;
+    g_armedCount++;
+    wheel_insert(timer);
+
+    // Only interrupt the wheel thread if it would otherwise sleep past this timer
+    wake = timer->expiresTick < g_sleepUntilTick;
+    if (wake)
+    {
+        g_sleepUntilTick = timer->expiresTick;
+    }
+
+    LeaveCriticalSection(&g_wheelLock);
+
+    if (wake && g_wheelRunning)
+    {
+        SetEvent(g_wheelWake);
+    }
+}
+
+// Returns 1 if the timer was pending. A periodic callback already running
+// completes but is not re-armed; the timer must stay valid until it returns.
+int timer_wheel_cancel(TimerWheelTimer *timer)
+{
+    int wasPending = 0;
+
+    EnterCriticalSection(&g_wheelLock);
+    if (timer->state == TIMER_ARMED)
+    {
+        list_unlink(timer);
+        g_armedCount--;
+        wasPending = 1;
+    }
+    timer->state = TIMER_IDLE;
+    LeaveCriticalSection(&g_wheelLock);
+
+    return wasPending;
+}
+
+int timer_wheel_is_armed(const TimerWheelTimer *timer)
+{
+    return timer->state != TIMER_IDLE;
+}
+
+// Earliest time (us since start) at which the wheel has work, UINT64_MAX if idle
+uint64_t timer_wheel_next_expiry_us(void)
+{
+    EnterCriticalSection(&g_wheelLock);
+    uint64_t nextTick = wheel_next_tick();
+    LeaveCriticalSection(&g_wheelLock);
+
+    return nextTick == UINT64_MAX ? UINT64_MAX : nextTick * TIMER_WHEEL_TICK_US;
+}
+
+static void signal_event_callback(void *arg)
+{
+    SetEvent((HANDLE)arg);
+}
+
+void timer_wheel_sleep_us(uint64_t delayUs)
+{
+    if (!g_wheelRunning)
+    {
+        Sleep((DWORD)((delayUs + 999) / 1000));
+        return;
+    }
+
+    TimerWheelTimer timer;
+    memset(&timer, 0, sizeof(timer));
+
+    HANDLE done = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (done == NULL)
+    {
+        Sleep((DWORD)((delayUs + 999) / 1000));
+        return;
+    }
+
+    timer_wheel_arm(&timer, delayUs, 0, signal_event_callback, done);
+    WaitForSingleObject(done, INFINITE);
+    CloseHandle(done);
+}
@@ -0,0 +1,424 @@
+#include "../../include/tmr_executor.h"
+#include "../../include/tmr_vote.h"
+#include "../../include/fault_tolerance.h"
+#include "../../include/timer_wheel.h"
+#include "../../include/trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#define TMR_COMMITTED 0x100 // doneMask flag: the caller has taken a result
+
+// One replicated execution. Replica outputs live right after the job so
+// they stay valid until the last straggler has been checked.
+typedef struct
+{
+    volatile LONG refs;     // Queued replicas plus the waiting caller
+    volatile LONG doneMask; // Bit per finished replica, plus TMR_COMMITTED
+    LONG agreedMask;        // Replicas whose matching outputs were committed early
+    HANDLE doneEvent;       // Auto-reset; signalled as each replica finishes
+    uint32_t taskId;
+    void (*entryPoint)(void *);
+    void *args;
+    size_t outputSize;
+    uint8_t *outputs[TMR_REPLICAS];
+} TmrJob;
+
+// Replica worker; replica i of every job runs on worker i
+typedef struct
+{
+    HANDLE thread;
+    HANDLE pending; // Semaphore counting queued jobs
+    CRITICAL_SECTION lock;
+    TmrJob *queue[TMR_QUEUE_DEPTH];
+    int head;
+    int count;
+} TmrWorker;
+
+// What a running replica sees through tmr_replica_output
+typedef struct
+{
+    TmrJob *job;
+    int replica;
+} TmrReplicaContext;
+
+static TmrWorker g_tmrWorkers[TMR_REPLICAS];
+static volatile int g_tmrRunning = 0;
+static DWORD g_tmrTlsIndex = TLS_OUT_OF_INDEXES;
+static TmrExecutorStats g_tmrStats;
+
+static void tmr_job_release(TmrJob *job)
+{
+    if (InterlockedDecrement(&job->refs) == 0)
+    {
+        CloseHandle(job->doneEvent);
+        free(job);
+    }
+}
+
+static int first_difference(const uint8_t *a, const uint8_t *b, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        if (a[i] != b[i])
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static void tmr_flag_replica(TmrJob *job, int replica, uint32_t offset)
+{
+    InterlockedIncrement64((volatile LONG64 *)&g_tmrStats.disagreements[replica]);
+    TRACE(TRACE_TMR_OUTVOTED, job->taskId, replica, offset, 0);
+    fault_report(COMPUTATION_FAULT, job->taskId, offset);
+}
+
+// A replica that finished after an early commit is checked against the agreed output
+static void tmr_check_straggler(TmrJob *job, int replica)
+{
+    for (int agreed = 0; agreed < TMR_REPLICAS; agreed++)
+    {
+        if (job->agreedMask & (1 << agreed))
+        {
+            int offset = first_difference(job->outputs[replica], job->outputs[agreed], job->outputSize);
+            if (offset >= 0)
+            {
+                tmr_flag_replica(job, replica, (uint32_t)offset);
+            }
+            return;
+        }
+    }
+}
+
+static DWORD WINAPI tmr_worker_func(LPVOID lpParam)
+{
+    int replica = (int)(intptr_t)lpParam;
+    TmrWorker *worker = &g_tmrWorkers[replica];
+    trace_thread_name(replica == 0 ? "tmr replica 0" : replica == 1 ? "tmr replica 1" : "tmr replica 2");
+
+    while (g_tmrRunning)
+    {
+        WaitForSingleObject(worker->pending, INFINITE);
+
+        EnterCriticalSection(&worker->lock);
+        TmrJob *job = NULL;
+        if (worker->count > 0)
+        {
+            job = worker->queue[worker->head];
+            worker->head = (worker->head + 1) % TMR_QUEUE_DEPTH;
+            worker->count--;
+        }
+        LeaveCriticalSection(&worker->lock);
+
+        if (!job)
+        {
+            continue; // Woken for shutdown
+        }
+
+        TmrReplicaContext context = {job, replica};
+        TlsSetValue(g_tmrTlsIndex, &context);
+        job->entryPoint(job->args);
+        TlsSetValue(g_tmrTlsIndex, NULL);
+
+        LONG previous = InterlockedOr(&job->doneMask, 1 << replica);
+        if (previous & TMR_COMMITTED)
+        {
+            tmr_check_straggler(job, replica);
+        }
+        SetEvent(job->doneEvent);
+        tmr_job_release(job);
+    }
+
+    return 0;
+}
+
+void tmr_executor_start(void)
+{
+    if (g_tmrRunning)
+    {
+        return;
+    }
+
+    if (g_tmrTlsIndex == TLS_OUT_OF_INDEXES)
+    {
+        g_tmrTlsIndex = TlsAlloc();
+        if (g_tmrTlsIndex == TLS_OUT_OF_INDEXES)
+        {
+            printf("Error: Failed to allocate TMR replica TLS slot\n");
+            exit(1);
+        }
+    }
+
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    memset(&g_tmrStats, 0, sizeof(g_tmrStats));
+
+    g_tmrRunning = 1;
+    for (int i = 0; i < TMR_REPLICAS; i++)
+    {
+        TmrWorker *worker = &g_tmrWorkers[i];
+        InitializeCriticalSection(&worker->lock);
+        worker->head = 0;
+        worker->count = 0;
+        worker->pending = CreateSemaphore(NULL, 0, TMR_QUEUE_DEPTH + 1, NULL);
+        worker->thread = worker->pending ? CreateThread(NULL, 0, tmr_worker_func, (LPVOID)(intptr_t)i, 0, NULL) : NULL;
+        if (worker->thread == NULL)
+        {
+            printf("Error: Failed to create TMR replica worker\n");
+            exit(1);
+        }
+        SetThreadPriority(worker->thread, THREAD_PRIORITY_ABOVE_NORMAL);
+
+        // Pin replicas to distinct cores (from the top, away from core 0) when there are enough
+        if (systemInfo.dwNumberOfProcessors >= TMR_REPLICAS)
+        {
+            SetThreadAffinityMask(worker->thread, (DWORD_PTR)1 << (systemInfo.dwNumberOfProcessors - 1 - i));
+        }
+    }
+
+    printf("TMR executor started with %d replica workers\n", TMR_REPLICAS);
+}
+
+// Stop the workers; call only once nothing can be inside tmr_execute
+void tmr_executor_stop(void)
+{
+    if (!g_tmrRunning)
+    {
+        return;
+    }
+
+    g_tmrRunning = 0;
+    for (int i = 0; i < TMR_REPLICAS; i++)
+    {
+        ReleaseSemaphore(g_tmrWorkers[i].pending, 1, NULL);
+    }
+
+    for (int i = 0; i < TMR_REPLICAS; i++)
+    {
+        TmrWorker *worker = &g_tmrWorkers[i];
+        WaitForSingleObject(worker->thread, INFINITE);
+
+        // Drop replicas that never ran
+        while (worker->count > 0)
+        {
+            tmr_job_release(worker->queue[worker->head]);
+            worker->head = (worker->head + 1) % TMR_QUEUE_DEPTH;
+            worker->count--;
+        }
+
+        CloseHandle(worker->thread);
+        CloseHandle(worker->pending);
+        DeleteCriticalSection(&worker->lock);
+    }
+}
+
+// Queue one replica on every worker, or none if any queue is full
+static int tmr_dispatch(TmrJob *job)
+{
+    int full = 0;
+
+    for (int i = 0; i < TMR_REPLICAS; i++)
+    {
+        EnterCriticalSection(&g_tmrWorkers[i].lock);
+        full |= g_tmrWorkers[i].count == TMR_QUEUE_DEPTH;
+    }
+
+    for (int i = 0; i < TMR_REPLICAS; i++)
+    {
+        TmrWorker *worker = &g_tmrWorkers[i];
+        if (!full)
+        {
+            worker->queue[(worker->head + worker->count) % TMR_QUEUE_DEPTH] = job;
+            worker->count++;
+        }
+        LeaveCriticalSection(&worker->lock);
+    }
+
+    if (full)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < TMR_REPLICAS; i++)
+    {
+        ReleaseSemaphore(g_tmrWorkers[i].pending, 1, NULL);
+    }
+    return 0;
+}
+
+// Three-way bitwise vote into the task's output; outvoted replicas are flagged
+static void tmr_full_vote(TmrJob *job, void *output)
+{
+    TmrVoteReport report;
+
+    if (job->outputSize == 0 ||
+        tmr_vote_buffers(job->outputs[0], job->outputs[1], job->outputs[2], job->outputSize,
+                         output, 0, &report) == 0)
+    {
+        return;
+    }
+
+    for (int replica = 0; replica < TMR_REPLICAS; replica++)
+    {
+        if (!report.minorityBits[replica])
+        {
+            continue;
+        }
+        for (uint32_t i = 0; i < report.locationCount; i++)
+        {
+            if (report.locations[i].minorityMask & (1u << replica))
+            {
+                tmr_flag_replica(job, replica, (uint32_t)report.locations[i].offset);
+                break;
+            }
+        }
+    }
+}
+
+// Run three replicas of a task concurrently and commit the voted output.
+// TMR_MODE_EARLY commits as soon as two replicas agree; the third is
+// checked when it finishes. Returns 0 once committed, -1 if the task
+// could not be replicated, -2 if deadlineUs (0 = none) passed first.
+int tmr_execute(const Task *task, uint64_t deadlineUs)
+{
+    if (!g_tmrRunning || !task || !task->entryPoint)
+    {
+        return -1;
+    }
+
+    size_t outputSize = task->output ? task->outputSize : 0;
+    size_t stride = (outputSize + 31) & ~(size_t)31;
+    TmrJob *job = (TmrJob *)malloc(sizeof(TmrJob) + TMR_REPLICAS * stride);
+    if (!job)
+    {
+        return -1;
+    }
+
+    job->refs = TMR_REPLICAS + 1;
+    job->doneMask = 0;
+    job->agreedMask = 0;
+    job->doneEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    job->taskId = task->id;
+    job->entryPoint = task->entryPoint;
+    job->args = task->args;
+    job->outputSize = outputSize;
+    for (int i = 0; i < TMR_REPLICAS; i++)
+    {
+        // Replicas start from the committed state so incremental updates vote equal
+        job->outputs[i] = (uint8_t *)(job + 1) + i * stride;
+        if (outputSize)
+        {
+            memcpy(job->outputs[i], task->output, outputSize);
+        }
+    }
+
+    if (job->doneEvent == NULL || tmr_dispatch(job) != 0)
+    {
+        if (job->doneEvent)
+        {
+            CloseHandle(job->doneEvent);
+        }
+        free(job);
+        return -1;
+    }
+
+    g_tmrStats.executions++;
+    uint64_t startUs = timer_wheel_now_us();
+    int result = -2;
+
+    for (;;)
+    {
+        LONG mask = job->doneMask;
+        int done = (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1);
+
+        if (done == TMR_REPLICAS)
+        {
+            tmr_full_vote(job, task->output);
+            g_tmrStats.fullVotes++;
+            result = 0;
+            break;
+        }
+
+        if (task->tmrMode == TMR_MODE_EARLY && done == 2)
+        {
+            int first = (mask & 1) ? 0 : 1;
+            int second = (mask & 4) ? 2 : 1;
+
+            if (first_difference(job->outputs[first], job->outputs[second], outputSize) < 0)
+            {
+                // Publish the agreeing pair before claiming the commit, so a
+                // straggler that sees TMR_COMMITTED knows what to compare against
+                job->agreedMask = mask;
+                if (InterlockedCompareExchange(&job->doneMask, mask | TMR_COMMITTED, mask) == mask)
+                {
+                    if (outputSize)
+                    {
+                        memcpy(task->output, job->outputs[first], outputSize);
+                    }
+                    g_tmrStats.earlyCommits++;
+                    result = 0;
+                    break;
+                }
+                continue; // The third replica finished meanwhile; vote all three
+            }
+        }
+
+        DWORD waitMs = INFINITE;
+        if (deadlineUs)
+        {
+            uint64_t elapsedUs = timer_wheel_now_us() - startUs;
+            if (elapsedUs >= deadlineUs)
+            {
+                g_tmrStats.deadlineMisses++;
+                TRACE(TRACE_TMR_DEADLINE_MISS, task->id, 0, 0, 0);
+                fault_report(TIMING_FAULT, task->id, 0);
+                break;
+            }
+            waitMs = (DWORD)((deadlineUs - elapsedUs + 999) / 1000);
+        }
+        WaitForSingleObject(job->doneEvent, waitMs);
+    }
+
+    tmr_job_release(job);
+    return result;
+}
+
+// Output buffer of the calling replica, or NULL when not running replicated
+void *tmr_replica_output(size_t *size)
+{
+    TmrReplicaContext *context = g_tmrTlsIndex == TLS_OUT_OF_INDEXES ? NULL : (TmrReplicaContext *)TlsGetValue(g_tmrTlsIndex);
+
+    if (!context || !context->job->outputSize)
+    {
+        if (size)
+        {
+            *size = 0;
+        }
+        return NULL;
+    }
+
+    if (size)
+    {
+        *size = context->job->outputSize;
+    }
+    return context->job->outputs[context->replica];
+}
+
+// Replica index of the calling thread, or -1 outside a replica
+int tmr_replica_index(void)
+{
+    TmrReplicaContext *context = g_tmrTlsIndex == TLS_OUT_OF_INDEXES ? NULL : (TmrReplicaContext *)TlsGetValue(g_tmrTlsIndex);
+    return context ? context->replica : -1;
+}
+
+void tmr_executor_get_stats(TmrExecutorStats *stats)
+{
+    if (stats)
+    {
+        *stats = g_tmrStats;
+    }
+}
@@ -0,0 +1,336 @@
+#include "../../include/trace.h"
+#include "../../include/task_manager.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+#define TRACE_CALIBRATION_MS 20
+#define TRACE_NO_RING ((TraceRing *)(intptr_t)-1) // The thread found every ring taken
+
+// External functions
+extern int kernel_get_task_slot_count(void);
+extern int kernel_read_task_slot(int slot, Task *snapshot);
+
+// Single-producer ring owned by one thread and emptied by the drain thread
+typedef struct
+{
+    volatile uint32_t head;    // Next slot the owner writes
+    volatile uint32_t tail;    // Next slot the drain thread reads
+    volatile uint32_t dropped; // Events lost to a full ring
+    uint32_t droppedReported;  // Drain side
+    uint32_t threadId;
+    TraceEvent events[TRACE_RING_EVENTS];
+} TraceRing;
+
+// Category names for trace_parse_categories, in bit order
+static const char *g_categoryNames[] = {"META", "SCHED", "TASK", "FAULT", "MEMORY", "TMR", "BUDGET"};
+
+volatile uint32_t g_traceCategories = 0;
+static TraceRing *volatile g_traceRings[TRACE_MAX_THREADS];
+static volatile LONG g_traceRingCount = 0;
+static volatile LONG g_traceUnringed = 0; // Events from threads beyond TRACE_MAX_THREADS
+static DWORD g_traceTlsIndex = TLS_OUT_OF_INDEXES;
+static FILE *g_traceFile = NULL;
+static HANDLE g_traceDrainThread = NULL;
+static HANDLE g_traceStopEvent = NULL;
+static uint64_t g_traceEvents = 0;
+static uint64_t g_traceDropped = 0;
+static int g_traceRunning = 0;
+
+// First event from a thread claims it a ring; rings outlive their threads
+static TraceRing *trace_ring(void)
+{
+    TraceRing *ring = (TraceRing *)TlsGetValue(g_traceTlsIndex);
+    if (ring)
+    {
+        return ring;
+    }
+
+    LONG index = InterlockedIncrement(&g_traceRingCount) - 1;
+    ring = index < TRACE_MAX_THREADS ? (TraceRing *)calloc(1, sizeof(TraceRing)) : NULL;
+    if (!ring)
+    {
+        TlsSetValue(g_traceTlsIndex, TRACE_NO_RING);
+        return TRACE_NO_RING;
+    }
+
+    ring->threadId = GetCurrentThreadId();
+    MemoryBarrier(); // Initialized before the drain thread can see it
+    g_traceRings[index] = ring;
+    TlsSetValue(g_traceTlsIndex, ring);
+    return ring;
+}
+
+void trace_emit(TraceEventId event, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    TraceRing *ring = trace_ring();
+    if (ring == TRACE_NO_RING)
+    {
+        InterlockedIncrement(&g_traceUnringed);
+        return;
+    }
+
+    uint32_t head = ring->head;
+    if (head - ring->tail >= TRACE_RING_EVENTS)
+    {
+        ring->dropped++;
+        return;
+    }
+
+    TraceEvent *record = &ring->events[head & (TRACE_RING_EVENTS - 1)];
+    record->tsc = __rdtsc();
+    record->threadId = ring->threadId;
+    record->event = (uint16_t)event;
+    record->reserved = 0;
+    record->args[0] = a0;
+    record->args[1] = a1;
+    record->args[2] = a2;
+    record->args[3] = a3;
+
+    MemoryBarrier(); // Publish the record before the new head
+    ring->head = head + 1;
+}
+
+// Copy everything published so far to the file and release the slots
+static void trace_drain(void)
+{
+    LONG count = g_traceRingCount < TRACE_MAX_THREADS ? g_traceRingCount : TRACE_MAX_THREADS;
+
+    for (LONG i = 0; i < count; i++)
+    {
+        TraceRing *ring = g_traceRings[i];
+        if (!ring)
+        {
+            continue;
+        }
+
+        uint32_t head = ring->head;
+        uint32_t tail = ring->tail;
+        MemoryBarrier(); // Records up to head are complete
+        while (tail != head)
+        {
+            uint32_t index = tail & (TRACE_RING_EVENTS - 1);
+            uint32_t run = head - tail < TRACE_RING_EVENTS - index ? head - tail : TRACE_RING_EVENTS - index;
+            fwrite(&ring->events[index], sizeof(TraceEvent), run, g_traceFile);
+            g_traceEvents += run;
+            tail += run;
+        }
+        MemoryBarrier(); // Done reading before the owner may reuse the slots
+        ring->tail = tail;
+
+        uint32_t dropped = ring->dropped;
+        if (dropped != ring->droppedReported)
+        {
+            TraceEvent record = {0};
+            record.tsc = __rdtsc();
+            record.threadId = ring->threadId;
+            record.event = TRACE_DROPPED;
+            record.args[0] = dropped - ring->droppedReported;
+            fwrite(&record, sizeof(TraceEvent), 1, g_traceFile);
+            g_traceDropped += record.args[0];
+            ring->droppedReported = dropped;
+        }
+    }
+}
+
+static DWORD WINAPI trace_drain_thread_func(LPVOID lpParam)
+{
+    while (WaitForSingleObject(g_traceStopEvent, TRACE_DRAIN_MS) == WAIT_TIMEOUT)
+    {
+        trace_drain();
+    }
+    trace_drain();
+    return 0;
+}
+
+// TSC ticks per microsecond, measured against the performance counter
+static double trace_calibrate_tsc(void)
+{
+    LARGE_INTEGER frequency, start, end;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+    uint64_t startTsc = __rdtsc();
+
+    Sleep(TRACE_CALIBRATION_MS);
+
+    QueryPerformanceCounter(&end);
+    uint64_t endTsc = __rdtsc();
+    double elapsedUs = (double)(end.QuadPart - start.QuadPart) * 1000000.0 / (double)frequency.QuadPart;
+    return elapsedUs > 0.0 ? (double)(endTsc - startTsc) / elapsedUs : 1000.0;
+}
+
+// Start recording the given categories to a binary trace file; decode it
+// with trace_decode. Call after kernel_init. Returns 0 on success, -1 on error.
+int trace_start(const char *path, uint32_t categories)
+{
+    if (g_traceRunning)
+    {
+        return -1;
+    }
+
+    if (g_traceTlsIndex == TLS_OUT_OF_INDEXES)
+    {
+        g_traceTlsIndex = TlsAlloc();
+        if (g_traceTlsIndex == TLS_OUT_OF_INDEXES)
+        {
+            printf("Error: Failed to allocate trace TLS slot\n");
+            return -1;
+        }
+    }
+
+    g_traceFile = fopen(path, "wb");
+    if (!g_traceFile)
+    {
+        printf("Error: Cannot open trace file %s\n", path);
+        return -1;
+    }
+
+    TraceFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_FILE_VERSION;
+    header.eventSize = sizeof(TraceEvent);
+    header.tscPerUs = trace_calibrate_tsc();
+    header.startTsc = __rdtsc();
+    fwrite(&header, sizeof(header), 1, g_traceFile);
+
+    g_traceStopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    g_traceDrainThread = g_traceStopEvent ? CreateThread(NULL, 0, trace_drain_thread_func, NULL, 0, NULL) : NULL;
+    if (!g_traceDrainThread)
+    {
+        printf("Error: Failed to create trace drain thread\n");
+        if (g_traceStopEvent)
+        {
+            CloseHandle(g_traceStopEvent);
+        }
+        fclose(g_traceFile);
+        g_traceFile = NULL;
+        return -1;
+    }
+    SetThreadPriority(g_traceDrainThread, THREAD_PRIORITY_BELOW_NORMAL);
+
+    g_traceEvents = 0;
+    g_traceDropped = 0;
+    g_traceRunning = 1;
+    g_traceCategories = (categories & TRACE_CAT_ALL) | TRACE_CAT_META;
+
+    // Name the tasks created before tracing started
+    int count = kernel_get_task_slot_count();
+    for (int i = 0; i < count; i++)
+    {
+        Task snapshot;
+        if (kernel_read_task_slot(i, &snapshot) == 0)
+        {
+            trace_task_name(snapshot.id, snapshot.name);
+        }
+    }
+
+    printf("Tracing to %s: categories 0x%02X, %.0f TSC ticks/us\n", path, g_traceCategories, header.tscPerUs);
+    return 0;
+}
+
+// Stop recording and flush the rings. Events raced in after this are lost.
+void trace_stop(void)
+{
+    if (!g_traceRunning)
+    {
+        return;
+    }
+
+    g_traceCategories = 0;
+    g_traceRunning = 0;
+    SetEvent(g_traceStopEvent);
+    WaitForSingleObject(g_traceDrainThread, INFINITE);
+    CloseHandle(g_traceDrainThread);
+    CloseHandle(g_traceStopEvent);
+    g_traceDrainThread = NULL;
+    g_traceStopEvent = NULL;
+
+    fclose(g_traceFile);
+    g_traceFile = NULL;
+
+    printf("Trace stopped: %llu events written, %llu dropped\n",
+           (unsigned long long)g_traceEvents,
+           (unsigned long long)(g_traceDropped + (uint64_t)g_traceUnringed));
+}
+
+void trace_set_categories(uint32_t categories)
+{
+    if (g_traceRunning)
+    {
+        g_traceCategories = (categories & TRACE_CAT_ALL) | TRACE_CAT_META;
+    }
+}
+
+// Names travel 8 characters per metadata event
+static void trace_name(TraceEventId event, uint32_t id, const char *name)
+{
+    char chars[32] = {0};
+    uint32_t words[2];
+
+    if (!(g_traceCategories & TRACE_CAT_META) || !name)
+    {
+        return;
+    }
+
+    strncpy(chars, name, sizeof(chars) - 1);
+    uint32_t length = (uint32_t)strlen(chars);
+    for (uint32_t offset = 0; offset == 0 || offset < length; offset += 8)
+    {
+        memcpy(words, chars + offset, sizeof(words));
+        trace_emit(event, id, offset, words[0], words[1]);
+    }
+}
+
+void trace_thread_name(const char *name)
+{
+    trace_name(TRACE_THREAD_NAME, 0, name);
+}
+
+void trace_task_name(uint32_t taskId, const char *name)
+{
+    trace_name(TRACE_TASK_NAME, taskId, name);
+}
+
+// Parse "SCHED,FAULT,..." or "ALL" into TRACE_CAT_* bits
+int trace_parse_categories(const char *list, uint32_t *categories)
+{
+    char buffer[128];
+    uint32_t mask = 0;
+
+    strncpy(buffer, list, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    for (char *name = strtok(buffer, ","); name; name = strtok(NULL, ","))
+    {
+        uint32_t bit = 0;
+        if (_stricmp(name, "ALL") == 0)
+        {
+            bit = TRACE_CAT_ALL;
+        }
+        for (int i = 0; i < (int)(sizeof(g_categoryNames) / sizeof(g_categoryNames[0])) && !bit; i++)
+        {
+            if (_stricmp(name, g_categoryNames[i]) == 0)
+            {
+                bit = 1u << i;
+            }
+        }
+        if (!bit)
+        {
+            printf("Error: Unknown trace category '%s'\n", name);
+            return -1;
+        }
+        mask |= bit;
+    }
+
+    *categories = mask;
+    return mask ? 0 : -1;
+}
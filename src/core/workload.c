@@ -0,0 +1,568 @@
+#include "../../include/workload.h"
+#include "../../include/task_manager.h"
+#include "../../include/job_executor.h"
+#include "../../include/timer_wheel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <windows.h>
+
+#define WORKLOAD_SPLIT_ATTEMPTS 1000 // UUniFast-Discard retries before giving up
+#define WORKLOAD_SPORADIC_JITTER 0.5 // Mean extra inter-arrival gap, as a fraction of the period
+
+static const char g_levelLetters[] = {'A', 'B', 'C', 'D'};
+
+// Replay of the sporadic arrivals, running beside the kernel
+static const WorkloadSet *g_replaySet = NULL;
+static HANDLE g_replayThread = NULL;
+static HANDLE g_replayStop = NULL;
+static WorkloadReplayStats g_replayStats;
+
+static uint32_t workload_random(uint32_t *state)
+{
+    // xorshift32, so a seed reproduces the same task set
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Uniform in (0, 1]
+static double workload_uniform(uint32_t *state)
+{
+    return ((workload_random(state) >> 8) + 1) / 16777216.0;
+}
+
+static double workload_normal(uint32_t *state)
+{
+    // Box-Muller
+    return sqrt(-2.0 * log(workload_uniform(state))) * cos(6.283185307179586 * workload_uniform(state));
+}
+
+// Gamma(alpha, 1) by Marsaglia and Tsang
+static double workload_gamma(uint32_t *state, double alpha)
+{
+    if (alpha < 1.0)
+    {
+        return workload_gamma(state, alpha + 1.0) * pow(workload_uniform(state), 1.0 / alpha);
+    }
+
+    double d = alpha - 1.0 / 3.0;
+    double c = 1.0 / sqrt(9.0 * d);
+    for (;;)
+    {
+        double x = workload_normal(state);
+        double v = 1.0 + c * x;
+        if (v <= 0.0)
+        {
+            continue;
+        }
+        v = v * v * v;
+        double u = workload_uniform(state);
+        if (log(u) < 0.5 * x * x + d - d * v + d * log(v))
+        {
+            return d * v;
+        }
+    }
+}
+
+// Split total utilization into n shares, none above 1: UUniFast-Discard
+// when alpha is 0, otherwise a Dirichlet(alpha) draw (alpha = 1 is uniform
+// over the simplex, like UUniFast; smaller alphas give more skewed sets)
+static int workload_split(uint32_t *state, uint32_t n, double total, double alpha, double *shares)
+{
+    for (int attempt = 0; attempt < WORKLOAD_SPLIT_ATTEMPTS; attempt++)
+    {
+        int valid = 1;
+
+        if (alpha <= 0.0)
+        {
+            double remaining = total;
+            for (uint32_t i = 0; i + 1 < n; i++)
+            {
+                double next = remaining * pow(workload_uniform(state), 1.0 / (double)(n - 1 - i));
+                shares[i] = remaining - next;
+                remaining = next;
+            }
+            shares[n - 1] = remaining;
+        }
+        else
+        {
+            double sum = 0.0;
+            for (uint32_t i = 0; i < n; i++)
+            {
+                shares[i] = workload_gamma(state, alpha);
+                sum += shares[i];
+            }
+            for (uint32_t i = 0; i < n; i++)
+            {
+                shares[i] = total * shares[i] / sum;
+            }
+        }
+
+        for (uint32_t i = 0; i < n && valid; i++)
+        {
+            valid = shares[i] <= 1.0;
+        }
+        if (valid)
+        {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static CriticalityLevel workload_pick_level(uint32_t *state, const uint32_t *mix)
+{
+    uint32_t total = mix[DAL_A] + mix[DAL_B] + mix[DAL_C] + mix[DAL_D];
+    uint32_t pick = total ? workload_random(state) % total : 0;
+
+    for (int level = DAL_A; level < DAL_D; level++)
+    {
+        if (pick < mix[level])
+        {
+            return (CriticalityLevel)level;
+        }
+        pick -= mix[level];
+    }
+    return DAL_D;
+}
+
+static int compare_jobs(const void *a, const void *b)
+{
+    const WorkloadJob *left = (const WorkloadJob *)a;
+    const WorkloadJob *right = (const WorkloadJob *)b;
+    if (left->offsetMs != right->offsetMs)
+    {
+        return left->offsetMs < right->offsetMs ? -1 : 1;
+    }
+    return (left->task > right->task) - (left->task < right->task);
+}
+
+static int workload_add_job(WorkloadSet *set, uint32_t *capacity, uint32_t offsetMs, uint32_t task)
+{
+    if (set->jobCount == *capacity)
+    {
+        uint32_t grown = *capacity ? *capacity * 2 : 256;
+        WorkloadJob *jobs = (WorkloadJob *)realloc(set->jobs, grown * sizeof(WorkloadJob));
+        if (!jobs)
+        {
+            return -1;
+        }
+        set->jobs = jobs;
+        *capacity = grown;
+    }
+
+    set->jobs[set->jobCount].offsetMs = offsetMs;
+    set->jobs[set->jobCount].task = task;
+    set->jobCount++;
+    return 0;
+}
+
+void workload_defaults(WorkloadConfig *config)
+{
+    memset(config, 0, sizeof(WorkloadConfig));
+    config->taskCount = 100;
+    config->utilization = 0.7f;
+    config->periodMinMs = 10;
+    config->periodMaxMs = 1000;
+    config->deadlineMinRatio = 1.0f;
+    config->criticalityMix[DAL_A] = 10;
+    config->criticalityMix[DAL_B] = 20;
+    config->criticalityMix[DAL_C] = 30;
+    config->criticalityMix[DAL_D] = 40;
+    config->durationMs = 10000;
+    config->seed = 1;
+}
+
+// Generate a task set and, for its sporadic tasks, arrivals over durationMs.
+// The same config and seed always give the same set. Returns 0 or -1.
+int workload_generate(const WorkloadConfig *config, WorkloadSet *set)
+{
+    uint32_t rng = config->seed ? config->seed : 1;
+    uint32_t n = config->taskCount;
+    uint32_t jobCapacity = 0;
+
+    memset(set, 0, sizeof(WorkloadSet));
+    if (n == 0 || n > WORKLOAD_MAX_TASKS || config->utilization <= 0.0f || config->utilization > (float)n ||
+        config->periodMinMs == 0 || config->periodMaxMs < config->periodMinMs)
+    {
+        printf("Error: Invalid workload parameters\n");
+        return -1;
+    }
+
+    double *shares = (double *)malloc(n * sizeof(double));
+    set->tasks = (WorkloadTask *)calloc(n, sizeof(WorkloadTask));
+    if (!shares || !set->tasks)
+    {
+        free(shares);
+        free(set->tasks);
+        set->tasks = NULL;
+        return -1;
+    }
+    if (workload_split(&rng, n, config->utilization, config->dirichletAlpha, shares) != 0)
+    {
+        printf("Error: Could not split utilization %.2f over %u tasks\n", config->utilization, n);
+        free(shares);
+        free(set->tasks);
+        set->tasks = NULL;
+        return -1;
+    }
+
+    double logMin = log((double)config->periodMinMs);
+    double logMax = log((double)config->periodMaxMs);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        WorkloadTask *task = &set->tasks[i];
+        double periodMs = floor(exp(logMin + (logMax - logMin) * workload_uniform(&rng)));
+        if (periodMs < config->periodMinMs)
+        {
+            periodMs = config->periodMinMs;
+        }
+
+        double wcetMs = shares[i] * periodMs;
+        double ratio = config->deadlineMinRatio + (1.0 - config->deadlineMinRatio) * workload_uniform(&rng);
+        double deadlineMs = ceil(wcetMs + ratio * (periodMs - wcetMs));
+
+        snprintf(task->name, sizeof(task->name), "W%u", i);
+        task->periodMs = (uint32_t)periodMs;
+        task->deadlineMs = deadlineMs < periodMs ? (uint32_t)deadlineMs : (uint32_t)periodMs;
+        task->wcetUs = wcetMs * 1000.0 >= 1.0 ? (uint32_t)(wcetMs * 1000.0) : 1;
+        task->criticality = workload_pick_level(&rng, config->criticalityMix);
+        task->sporadic = workload_random(&rng) % 100 < config->sporadicPercent;
+        task->taskId = TASK_INVALID_ID;
+    }
+    free(shares);
+    set->taskCount = n;
+    set->durationMs = config->durationMs;
+
+    // Sporadic arrivals keep at least a period apart, plus exponential slack
+    for (uint32_t i = 0; i < n; i++)
+    {
+        WorkloadTask *task = &set->tasks[i];
+        if (!task->sporadic)
+        {
+            continue;
+        }
+
+        double offsetMs = task->periodMs * workload_uniform(&rng);
+        while (offsetMs < set->durationMs)
+        {
+            if (workload_add_job(set, &jobCapacity, (uint32_t)offsetMs, i) != 0)
+            {
+                workload_free(set);
+                return -1;
+            }
+            offsetMs += task->periodMs * (1.0 - WORKLOAD_SPORADIC_JITTER * log(workload_uniform(&rng)));
+        }
+    }
+    if (set->jobCount)
+    {
+        qsort(set->jobs, set->jobCount, sizeof(WorkloadJob), compare_jobs);
+    }
+
+    return 0;
+}
+
+typedef struct
+{
+    const char *name;
+    uint32_t task;
+} WorkloadName;
+
+static int compare_names(const void *a, const void *b)
+{
+    return strcmp(((const WorkloadName *)a)->name, ((const WorkloadName *)b)->name);
+}
+
+// Load a task set written by workload_save or by hand:
+//   duration <ms>
+//   task <name> <period ms> <deadline ms> <wcet us> <A|B|C|D> <periodic|sporadic>
+//   job <offset ms> <task name>
+// Tasks named by job lines are made sporadic. Returns 0 or -1.
+int workload_load(const char *path, WorkloadSet *set)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        printf("Error: Cannot open workload '%s'\n", path);
+        return -1;
+    }
+
+    char line[160];
+    int lineNumber = 0;
+    uint32_t taskCapacity = 0, jobCapacity = 0;
+    WorkloadName *index = NULL;
+    memset(set, 0, sizeof(WorkloadSet));
+
+    while (fgets(line, sizeof(line), file))
+    {
+        char name[32], kind[16], level;
+        uint32_t a, b, c;
+        lineNumber++;
+
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+        {
+            continue;
+        }
+
+        if (sscanf(line, "duration %u", &a) == 1)
+        {
+            set->durationMs = a;
+            continue;
+        }
+
+        if (sscanf(line, "task %31s %u %u %u %c %15s", name, &a, &b, &c, &level, kind) == 6 &&
+            a > 0 && b > 0 && level >= 'A' && level <= 'D' && !index && set->taskCount < WORKLOAD_MAX_TASKS)
+        {
+            if (set->taskCount == taskCapacity)
+            {
+                taskCapacity = taskCapacity ? taskCapacity * 2 : 64;
+                WorkloadTask *grown = (WorkloadTask *)realloc(set->tasks, taskCapacity * sizeof(WorkloadTask));
+                if (!grown)
+                {
+                    break;
+                }
+                set->tasks = grown;
+            }
+
+            WorkloadTask *task = &set->tasks[set->taskCount++];
+            memset(task, 0, sizeof(WorkloadTask));
+            strncpy(task->name, name, sizeof(task->name) - 1);
+            task->periodMs = a;
+            task->deadlineMs = b;
+            task->wcetUs = c;
+            task->criticality = (CriticalityLevel)(level - 'A');
+            task->sporadic = strcmp(kind, "sporadic") == 0;
+            task->taskId = TASK_INVALID_ID;
+            continue;
+        }
+
+        if (sscanf(line, "job %u %31s", &a, name) == 2 && set->taskCount > 0)
+        {
+            // Job lines follow the tasks; index the names once
+            if (!index)
+            {
+                index = (WorkloadName *)malloc(set->taskCount * sizeof(WorkloadName));
+                if (!index)
+                {
+                    break;
+                }
+                for (uint32_t i = 0; i < set->taskCount; i++)
+                {
+                    index[i].name = set->tasks[i].name;
+                    index[i].task = i;
+                }
+                qsort(index, set->taskCount, sizeof(WorkloadName), compare_names);
+            }
+
+            WorkloadName key = {name, 0};
+            WorkloadName *found = (WorkloadName *)bsearch(&key, index, set->taskCount, sizeof(WorkloadName), compare_names);
+            if (found && workload_add_job(set, &jobCapacity, a, found->task) == 0)
+            {
+                set->tasks[found->task].sporadic = 1;
+                continue;
+            }
+        }
+
+        printf("Error: Bad workload line at %s:%d\n", path, lineNumber);
+        free(index);
+        workload_free(set);
+        fclose(file);
+        return -1;
+    }
+
+    free(index);
+    fclose(file);
+
+    if (set->taskCount == 0)
+    {
+        printf("Error: Workload '%s' has no tasks\n", path);
+        workload_free(set);
+        return -1;
+    }
+    if (set->jobCount)
+    {
+        qsort(set->jobs, set->jobCount, sizeof(WorkloadJob), compare_jobs);
+        if (set->durationMs <= set->jobs[set->jobCount - 1].offsetMs)
+        {
+            set->durationMs = set->jobs[set->jobCount - 1].offsetMs + 1;
+        }
+    }
+    return 0;
+}
+
+int workload_save(const char *path, const WorkloadSet *set)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        printf("Error: Cannot create workload '%s'\n", path);
+        return -1;
+    }
+
+    fprintf(file, "# %u tasks, utilization %.4f, %u sporadic arrivals\n",
+            set->taskCount, workload_utilization(set), set->jobCount);
+    fprintf(file, "duration %u\n", set->durationMs);
+    for (uint32_t i = 0; i < set->taskCount; i++)
+    {
+        const WorkloadTask *task = &set->tasks[i];
+        fprintf(file, "task %s %u %u %u %c %s\n", task->name, task->periodMs, task->deadlineMs, task->wcetUs,
+                g_levelLetters[task->criticality], task->sporadic ? "sporadic" : "periodic");
+    }
+    for (uint32_t i = 0; i < set->jobCount; i++)
+    {
+        fprintf(file, "job %u %s\n", set->jobs[i].offsetMs, set->tasks[set->jobs[i].task].name);
+    }
+
+    fclose(file);
+    return 0;
+}
+
+void workload_free(WorkloadSet *set)
+{
+    free(set->tasks);
+    free(set->jobs);
+    memset(set, 0, sizeof(WorkloadSet));
+}
+
+float workload_utilization(const WorkloadSet *set)
+{
+    double total = 0.0;
+    for (uint32_t i = 0; i < set->taskCount; i++)
+    {
+        total += set->tasks[i].wcetUs / (1000.0 * set->tasks[i].periodMs);
+    }
+    return (float)total;
+}
+
+// Synthetic job: busy for the task's WCET, abortable by its budget
+static void workload_task_body(void *args)
+{
+    const WorkloadTask *task = (const WorkloadTask *)args;
+    uint64_t startUs = timer_wheel_now_us();
+
+    while (timer_wheel_now_us() - startUs < task->wcetUs)
+    {
+        job_abort_point();
+    }
+}
+
+// Create every task of the set in the kernel. The set must outlive the
+// tasks, which run its synthetic bodies. Returns the number created.
+int workload_apply(WorkloadSet *set)
+{
+    int created = 0;
+
+    for (uint32_t i = 0; i < set->taskCount; i++)
+    {
+        WorkloadTask *task = &set->tasks[i];
+        Task descriptor;
+        int taskId = task_create_ex(&descriptor, task->name, workload_task_body, task, task->periodMs,
+                                    task->deadlineMs, (task->wcetUs + 999) / 1000, task->criticality);
+        if (taskId < 0)
+        {
+            printf("Error: Failed to create workload task %s\n", task->name);
+            continue;
+        }
+
+        task->taskId = (uint32_t)taskId;
+        if (task->sporadic)
+        {
+            task_set_sporadic(task->taskId);
+        }
+        created++;
+    }
+
+    printf("Workload applied: %d of %u tasks, utilization %.3f, %u sporadic arrivals\n",
+           created, set->taskCount, workload_utilization(set), set->jobCount);
+    return created;
+}
+
+static DWORD WINAPI workload_replay_thread_func(LPVOID lpParam)
+{
+    const WorkloadSet *set = g_replaySet;
+    uint64_t startUs = timer_wheel_now_us();
+
+    for (uint32_t i = 0; i < set->jobCount; i++)
+    {
+        const WorkloadJob *job = &set->jobs[i];
+        uint64_t targetUs = (uint64_t)job->offsetMs * 1000;
+        uint64_t nowUs = timer_wheel_now_us() - startUs;
+
+        if (targetUs > nowUs)
+        {
+            // Waiting on the stop event keeps the replay cancellable
+            DWORD waitMs = (DWORD)((targetUs - nowUs + 999) / 1000);
+            if (WaitForSingleObject(g_replayStop, waitMs) == WAIT_OBJECT_0)
+            {
+                break;
+            }
+            nowUs = timer_wheel_now_us() - startUs;
+        }
+
+        if (nowUs > targetUs && nowUs - targetUs > g_replayStats.maxLagUs)
+        {
+            g_replayStats.maxLagUs = nowUs - targetUs;
+        }
+        if (task_release(set->tasks[job->task].taskId) == 0)
+        {
+            g_replayStats.released++;
+        }
+        else
+        {
+            g_replayStats.skipped++;
+        }
+    }
+    return 0;
+}
+
+// Replay the set's sporadic arrivals against the running kernel, relative
+// to now. Call after workload_apply and kernel_start.
+int workload_replay_start(const WorkloadSet *set)
+{
+    if (g_replayThread || !set)
+    {
+        return -1;
+    }
+
+    memset(&g_replayStats, 0, sizeof(g_replayStats));
+    g_replaySet = set;
+    g_replayStop = CreateEvent(NULL, TRUE, FALSE, NULL);
+    g_replayThread = g_replayStop ? CreateThread(NULL, 0, workload_replay_thread_func, NULL, 0, NULL) : NULL;
+    if (!g_replayThread)
+    {
+        printf("Error: Failed to create workload replay thread\n");
+        if (g_replayStop)
+        {
+            CloseHandle(g_replayStop);
+            g_replayStop = NULL;
+        }
+        return -1;
+    }
+
+    SetThreadPriority(g_replayThread, THREAD_PRIORITY_ABOVE_NORMAL);
+    return 0;
+}
+
+void workload_replay_stop(WorkloadReplayStats *stats)
+{
+    if (g_replayThread)
+    {
+        SetEvent(g_replayStop);
+        WaitForSingleObject(g_replayThread, INFINITE);
+        CloseHandle(g_replayThread);
+        CloseHandle(g_replayStop);
+        g_replayThread = NULL;
+        g_replayStop = NULL;
+    }
+
+    if (stats)
+    {
+        *stats = g_replayStats;
+    }
+}
@@ -0,0 +1,392 @@
+#include "../include/fault_campaign.h"
+#include "../include/fault_tolerance.h"
+#include "../include/timer_wheel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+#include <task_manager.h>
+
+// External function declarations
+extern int kernel_read_task_slot(int slot, Task *snapshot);
+extern int kernel_get_task_slot_count(void);
+
+typedef struct
+{
+    uint32_t offsetMs;
+    FaultType type;
+    char taskName[32];
+} CampaignStep;
+
+static const char *g_levelNames[] = {"DAL_A", "DAL_B", "DAL_C", "DAL_D"};
+
+static uint32_t campaign_random(uint32_t *state)
+{
+    // xorshift32, so a seed reproduces the same campaign
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static FaultType campaign_parse_type(const char *name)
+{
+    for (int type = TIMING_FAULT; type < FAULT_TYPE_COUNT; type++)
+    {
+        if (_stricmp(name, fault_type_name((FaultType)type)) == 0)
+        {
+            return (FaultType)type;
+        }
+    }
+    return NO_FAULT;
+}
+
+static int compare_steps(const void *a, const void *b)
+{
+    const CampaignStep *left = (const CampaignStep *)a;
+    const CampaignStep *right = (const CampaignStep *)b;
+    return (left->offsetMs > right->offsetMs) - (left->offsetMs < right->offsetMs);
+}
+
+static int campaign_load_script(const char *path, CampaignStep **steps, int *stepCount)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        printf("Error: Cannot open campaign script '%s'\n", path);
+        return -1;
+    }
+
+    char line[128];
+    int count = 0, capacity = 0, lineNumber = 0;
+    CampaignStep *list = NULL;
+
+    while (fgets(line, sizeof(line), file))
+    {
+        char typeName[32];
+        CampaignStep step;
+        lineNumber++;
+
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+        {
+            continue;
+        }
+        if (sscanf(line, "%u %31s %31[^\r\n]", &step.offsetMs, typeName, step.taskName) != 3 ||
+            (step.type = campaign_parse_type(typeName)) == NO_FAULT)
+        {
+            printf("Error: Bad campaign step at %s:%d\n", path, lineNumber);
+            free(list);
+            fclose(file);
+            return -1;
+        }
+
+        if (count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 64;
+            CampaignStep *grown = (CampaignStep *)realloc(list, (size_t)capacity * sizeof(CampaignStep));
+            if (!grown)
+            {
+                free(list);
+                fclose(file);
+                return -1;
+            }
+            list = grown;
+        }
+        list[count++] = step;
+    }
+
+    fclose(file);
+    qsort(list, (size_t)count, sizeof(CampaignStep), compare_steps);
+    *steps = list;
+    *stepCount = count;
+    return 0;
+}
+
+static int campaign_find_task(const char *name, Task *task)
+{
+    int count = kernel_get_task_slot_count();
+    for (int i = 0; i < count; i++)
+    {
+        if (kernel_read_task_slot(i, task) == 0 && strcmp(task->name, name) == 0)
+        {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int campaign_random_task(uint32_t *rng, Task *task)
+{
+    int count = kernel_get_task_slot_count();
+    for (int attempt = 0; count > 0 && attempt < 8; attempt++)
+    {
+        if (kernel_read_task_slot((int)(campaign_random(rng) % (uint32_t)count), task) == 0)
+        {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static FaultType campaign_random_type(uint32_t *rng, uint32_t typeMask)
+{
+    FaultType candidates[FAULT_TYPE_COUNT];
+    int count = 0;
+
+    for (int type = TIMING_FAULT; type < FAULT_TYPE_COUNT; type++)
+    {
+        if (typeMask & (1u << type))
+        {
+            candidates[count++] = (FaultType)type;
+        }
+    }
+    return count ? candidates[campaign_random(rng) % (uint32_t)count] : NO_FAULT;
+}
+
+static void campaign_sleep_until(uint64_t startUs, uint64_t offsetUs)
+{
+    uint64_t now = timer_wheel_now_us() - startUs;
+    if (offsetUs > now)
+    {
+        timer_wheel_sleep_us(offsetUs - now);
+    }
+}
+
+// True once every type has recovered at least as many faults as were injected
+static int campaign_drained(const uint32_t *injected)
+{
+    for (int type = TIMING_FAULT; type < FAULT_TYPE_COUNT; type++)
+    {
+        uint64_t recovered = 0;
+        for (int level = DAL_A; level <= DAL_D; level++)
+        {
+            FaultLatencyStats stats;
+            if (fault_get_latency_stats((FaultType)type, (CriticalityLevel)level, &stats) == 0)
+            {
+                recovered += stats.count;
+            }
+        }
+        if (recovered < injected[type])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static uint64_t capped_percentile(const uint32_t *histogram, uint64_t count, double percentile, uint64_t maxUs)
+{
+    uint64_t value = fault_latency_percentile(histogram, count, percentile);
+    return value < maxUs ? value : maxUs;
+}
+
+static void write_distribution(FILE *out, const char *name, uint64_t sumUs, uint64_t maxUs,
+                               const uint32_t *histogram, uint64_t count)
+{
+    // Percentiles are bucket upper bounds (within ~19%), capped at the observed max
+    fprintf(out, "\"%s\": {\"mean\": %llu, \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"p999\": %llu, \"max\": %llu}",
+            name,
+            (unsigned long long)(count ? sumUs / count : 0),
+            (unsigned long long)capped_percentile(histogram, count, 50.0, maxUs),
+            (unsigned long long)capped_percentile(histogram, count, 90.0, maxUs),
+            (unsigned long long)capped_percentile(histogram, count, 99.0, maxUs),
+            (unsigned long long)capped_percentile(histogram, count, 99.9, maxUs),
+            (unsigned long long)maxUs);
+}
+
+// Quoted JSON string, or null; paths carry backslashes on Windows
+static void write_json_string(FILE *out, const char *value)
+{
+    if (!value)
+    {
+        fprintf(out, "null");
+        return;
+    }
+
+    fputc('"', out);
+    for (const unsigned char *c = (const unsigned char *)value; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            fprintf(out, "\\%c", *c);
+        }
+        else if (*c < 0x20)
+        {
+            fprintf(out, "\\u%04x", *c);
+        }
+        else
+        {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static int campaign_write_report(const FaultCampaignConfig *config, const uint32_t *injected,
+                                 uint32_t skipped, uint64_t elapsedUs)
+{
+    FILE *out = fopen(config->outputPath, "w");
+    if (!out)
+    {
+        printf("Error: Cannot write campaign report '%s'\n", config->outputPath);
+        return -1;
+    }
+
+    fprintf(out, "{\n  \"durationMs\": %u,\n  \"elapsedUs\": %llu,\n  \"faultsPerSecond\": %u,\n  \"seed\": %u,\n",
+            config->durationMs, (unsigned long long)elapsedUs, config->faultsPerSecond, config->seed);
+    fprintf(out, "  \"script\": ");
+    write_json_string(out, config->scriptPath);
+    fprintf(out, ",\n");
+    fprintf(out, "  \"latencyUnit\": \"us\",\n  \"skipped\": %u,\n  \"injected\": {", skipped);
+    for (int type = TIMING_FAULT; type < FAULT_TYPE_COUNT; type++)
+    {
+        fprintf(out, "%s\"%s\": %u", type == TIMING_FAULT ? "" : ", ", fault_type_name((FaultType)type), injected[type]);
+    }
+    fprintf(out, "},\n  \"recovered\": [");
+
+    // Recovered counts include watchdog timeouts raised by the system itself
+    int first = 1;
+    for (int type = TIMING_FAULT; type < FAULT_TYPE_COUNT; type++)
+    {
+        for (int level = DAL_A; level <= DAL_D; level++)
+        {
+            FaultLatencyStats stats;
+            if (fault_get_latency_stats((FaultType)type, (CriticalityLevel)level, &stats) != 0 || stats.count == 0)
+            {
+                continue;
+            }
+
+            fprintf(out, "%s\n    {\"type\": \"%s\", \"criticality\": \"%s\", \"count\": %llu, ",
+                    first ? "" : ",", fault_type_name((FaultType)type), g_levelNames[level],
+                    (unsigned long long)stats.count);
+            write_distribution(out, "detect", stats.detectSumUs, stats.detectMaxUs, stats.detectHistogram, stats.count);
+            fprintf(out, ", ");
+            write_distribution(out, "recover", stats.recoverSumUs, stats.recoverMaxUs, stats.recoverHistogram, stats.count);
+            fprintf(out, "}");
+            first = 0;
+        }
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    fclose(out);
+    return 0;
+}
+
+void fault_campaign_defaults(FaultCampaignConfig *config)
+{
+    memset(config, 0, sizeof(FaultCampaignConfig));
+    config->durationMs = 10000;
+    config->faultsPerSecond = 20;
+    config->seed = 1;
+    for (int type = TIMING_FAULT; type < FAULT_TYPE_COUNT; type++)
+    {
+        config->typeMask |= 1u << type;
+    }
+}
+
+// Parse a comma-separated list of fault type names into a mask
+int fault_campaign_parse_types(const char *list, uint32_t *typeMask)
+{
+    char buffer[128];
+    uint32_t mask = 0;
+
+    strncpy(buffer, list, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    for (char *name = strtok(buffer, ","); name; name = strtok(NULL, ","))
+    {
+        FaultType type = campaign_parse_type(name);
+        if (type == NO_FAULT)
+        {
+            printf("Error: Unknown fault type '%s'\n", name);
+            return -1;
+        }
+        mask |= 1u << type;
+    }
+
+    *typeMask = mask;
+    return mask ? 0 : -1;
+}
+
+// Run a campaign against the running kernel and write the JSON report
+int fault_campaign_run(const FaultCampaignConfig *config)
+{
+    uint32_t injected[FAULT_TYPE_COUNT] = {0};
+    uint32_t skipped = 0;
+    uint32_t total = 0;
+    uint32_t rng = config->seed ? config->seed : 1;
+    CampaignStep *steps = NULL;
+    int stepCount = 0;
+
+    if (!config->outputPath)
+    {
+        printf("Error: Campaign needs an output path\n");
+        return -1;
+    }
+    if (config->scriptPath && campaign_load_script(config->scriptPath, &steps, &stepCount) != 0)
+    {
+        return -1;
+    }
+
+    printf("Fault campaign started: %s\n", config->scriptPath ? config->scriptPath : "random injection");
+    fault_reset_latency_stats();
+    uint64_t startUs = timer_wheel_now_us();
+
+    if (steps)
+    {
+        for (int i = 0; i < stepCount; i++)
+        {
+            Task task;
+            campaign_sleep_until(startUs, (uint64_t)steps[i].offsetMs * 1000);
+            if (campaign_find_task(steps[i].taskName, &task) != 0 ||
+                fault_inject(steps[i].type, task.id, 0x1000 + (campaign_random(&rng) % 0x1000)) != 0)
+            {
+                skipped++;
+                continue;
+            }
+            injected[steps[i].type]++;
+            total++;
+        }
+        free(steps);
+    }
+    else if (config->faultsPerSecond > 0)
+    {
+        uint64_t intervalUs = 1000000ULL / config->faultsPerSecond;
+        if (intervalUs == 0)
+        {
+            intervalUs = 1; // Past FAULT_CAMPAIGN_MAX_RATE; inject as fast as scheduling allows
+        }
+        uint64_t durationUs = (uint64_t)config->durationMs * 1000;
+
+        for (uint64_t offsetUs = 0; offsetUs < durationUs; offsetUs += intervalUs)
+        {
+            Task task;
+            campaign_sleep_until(startUs, offsetUs);
+
+            FaultType type = campaign_random_type(&rng, config->typeMask);
+            if (type == NO_FAULT || campaign_random_task(&rng, &task) != 0 ||
+                fault_inject(type, task.id, 0x1000 + (campaign_random(&rng) % 0x1000)) != 0)
+            {
+                skipped++;
+                continue;
+            }
+            injected[type]++;
+            total++;
+        }
+    }
+
+    // Let outstanding recoveries finish before taking the distributions
+    uint64_t drainStart = timer_wheel_now_us();
+    while (!campaign_drained(injected) && timer_wheel_now_us() - drainStart < FAULT_CAMPAIGN_DRAIN_MS * 1000ULL)
+    {
+        timer_wheel_sleep_us(10000);
+    }
+
+    uint64_t elapsedUs = timer_wheel_now_us() - startUs;
+    int result = campaign_write_report(config, injected, skipped, elapsedUs);
+    printf("Fault campaign finished: %u injected, %u skipped, report in %s\n", total, skipped, config->outputPath);
+    return result;
+}
@@ -1,6 +1,11 @@
 #include "../include/fault_tolerance.h"
 #include "../include/system_config.h"
 #include "../include/memory_matrix.h"
+#include "../include/task_table.h"
+#include "../include/timer_wheel.h"
+#include "../include/checkpoint.h"
+#include "../include/trace.h"
+#include "../include/sched_log.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -10,92 +15,626 @@
 #include <task_manager.h>
 
 // External function declarations
-extern Task *kernel_get_tasks(int *count);
-
-// Fault monitoring variables
-static FaultType g_injectedFaults[MAX_TASKS] = {NO_FAULT};
-static uint32_t g_faultAddresses[MAX_TASKS] = {0};
-static uint32_t g_watchdogTimers[MAX_TASKS] = {0};
-static uint64_t g_watchdogDeadlines[MAX_TASKS] = {0};
-static uint32_t g_faultRecoveryCounter[MAX_TASKS] = {0};
+extern int kernel_read_task(uint32_t taskId, Task *snapshot);
+extern int kernel_read_task_slot(int slot, Task *snapshot);
+extern int kernel_get_task_slot_count(void);
+
+// Per-task fault monitoring state, allocated in chunks as the task table grows
+typedef struct
+{
+    volatile LONG injectedFault; // FaultType, taken atomically by the collector
+    uint32_t faultAddress;
+    uint32_t watchdogTimer;
+    uint32_t watchdogTaskId; // Task the armed watchdog belongs to
+    volatile LONG watchdogExpired;
+    uint64_t injectedUs;
+    uint64_t watchdogExpiredUs;
+    TimerWheelTimer watchdog;
+    uint32_t faultRecoveryCounter;
+    uint32_t recoveryTaskId; // Task the recovery counter belongs to
+} FaultTaskState;
+
+// Where a queued fault came from; flag-backed sources are revalidated on collection
+typedef enum
+{
+    FAULT_SOURCE_REPORT,
+    FAULT_SOURCE_INJECTED,
+    FAULT_SOURCE_WATCHDOG
+} FaultSource;
+
+typedef struct
+{
+    volatile LONG sequence;
+    FaultSource source;
+    FaultDetectionResult fault;
+} FaultQueueCell;
+
+// Bounded lock-free queue. Each cell's sequence tells producers and
+// consumers whose turn it is, so any thread may push or pop.
+typedef struct
+{
+    FaultQueueCell cells[FAULT_EVENT_QUEUE_SIZE];
+    volatile LONG head; // Next position to fill
+    volatile LONG tail; // Next position to drain
+} FaultQueue;
+
+// Recovery worker. Tasks are sharded across workers by slot, which
+// serializes recovery per task; each worker drains DAL_A first.
+typedef struct
+{
+    FaultQueue queues[DAL_D + 1];
+    HANDLE wake; // Auto-reset; signalled after every dispatch
+    HANDLE thread;
+    FaultLatencyStats latency[FAULT_TYPE_COUNT][DAL_D + 1]; // Written only by this worker
+} RecoveryWorker;
+
+static FaultTaskState *g_faultStateChunks[TASK_TABLE_MAX_CHUNKS] = {NULL};
 static uint64_t g_lastCheckTime = 0;
 
+static FaultQueue g_faultIntake; // Reports from any thread, drained by the monitor
+static volatile LONG g_faultQueueOverflows = 0;
+static HANDLE g_faultEvent = NULL; // Auto-reset; signalled after every report
+static RecoveryWorker g_recoveryWorkers[FAULT_RECOVERY_WORKERS];
+static volatile int g_recoveryRunning = 0;
+static volatile LONG g_recoveryDropped[DAL_D + 1]; // Faults dropped at a full worker queue
+
+static FaultTaskState *fault_state(uint32_t slot)
+{
+    if (slot >= TASK_TABLE_MAX_CAPACITY)
+    {
+        return NULL;
+    }
+
+    FaultTaskState *chunk = g_faultStateChunks[slot / TASK_TABLE_CHUNK_SIZE];
+    return chunk ? &chunk[slot % TASK_TABLE_CHUNK_SIZE] : NULL;
+}
+
+static void fault_queue_init(FaultQueue *queue)
+{
+    for (int i = 0; i < FAULT_EVENT_QUEUE_SIZE; i++)
+    {
+        queue->cells[i].sequence = i;
+    }
+    queue->head = 0;
+    queue->tail = 0;
+}
+
+static int fault_queue_push(FaultQueue *queue, FaultSource source, const FaultDetectionResult *fault)
+{
+    for (;;)
+    {
+        LONG position = queue->head;
+        FaultQueueCell *cell = &queue->cells[position & (FAULT_EVENT_QUEUE_SIZE - 1)];
+        LONG difference = cell->sequence - position;
+
+        if (difference == 0)
+        {
+            if (InterlockedCompareExchange(&queue->head, position + 1, position) == position)
+            {
+                cell->source = source;
+                cell->fault = *fault;
+                MemoryBarrier();
+                cell->sequence = position + 1; // Publish to consumers
+                return 0;
+            }
+        }
+        else if (difference < 0)
+        {
+            return -1; // Full
+        }
+        else
+        {
+            YieldProcessor(); // Another producer claimed this position
+        }
+    }
+}
+
+static int fault_queue_pop(FaultQueue *queue, FaultQueueCell *out)
+{
+    for (;;)
+    {
+        LONG position = queue->tail;
+        FaultQueueCell *cell = &queue->cells[position & (FAULT_EVENT_QUEUE_SIZE - 1)];
+        LONG difference = cell->sequence - (position + 1);
+
+        if (difference == 0)
+        {
+            if (InterlockedCompareExchange(&queue->tail, position + 1, position) == position)
+            {
+                *out = *cell;
+                MemoryBarrier();
+                cell->sequence = position + FAULT_EVENT_QUEUE_SIZE; // Hand back to producers
+                return 1;
+            }
+        }
+        else if (difference < 0)
+        {
+            return 0; // Empty
+        }
+        else
+        {
+            YieldProcessor();
+        }
+    }
+}
+
+static int fault_queue_ready(const FaultQueue *queue)
+{
+    LONG position = queue->tail;
+    return queue->cells[position & (FAULT_EVENT_QUEUE_SIZE - 1)].sequence == position + 1;
+}
+
+static int fault_enqueue(FaultSource source, FaultType type, uint32_t taskId, uint32_t address)
+{
+    FaultDetectionResult fault = {0};
+    fault.faultDetected = 1;
+    fault.type = type;
+    fault.taskId = taskId;
+    fault.address = address;
+    fault.timestamp = GetTickCount64();
+    fault.raisedUs = timer_wheel_now_us();
+
+    int result = fault_queue_push(&g_faultIntake, source, &fault);
+    if (result != 0)
+    {
+        // Flag-backed faults are found again by a rescan; plain reports are lost
+        InterlockedIncrement(&g_faultQueueOverflows);
+        if (source == FAULT_SOURCE_REPORT)
+        {
+            printf("Warning: Fault queue full, dropped fault %d for task %u\n", type, taskId);
+        }
+    }
+
+    SetEvent(g_faultEvent);
+    return result;
+}
+
+static int latency_bucket(uint64_t us)
+{
+    if (us < 4)
+    {
+        return (int)us;
+    }
+
+    int msb = 63;
+    while (!(us >> msb))
+    {
+        msb--;
+    }
+
+    int bucket = (msb - 1) * 4 + (int)((us >> (msb - 2)) & 3);
+    return bucket < FAULT_LATENCY_BUCKETS ? bucket : FAULT_LATENCY_BUCKETS - 1;
+}
+
+// Smallest latency that falls into the bucket after this one
+static uint64_t latency_bucket_limit(int bucket)
+{
+    bucket++;
+    if (bucket < 4)
+    {
+        return (uint64_t)bucket;
+    }
+
+    int msb = bucket / 4 + 1;
+    return (uint64_t)(4 + bucket % 4) << (msb - 2);
+}
+
+static void fault_record_latency(RecoveryWorker *worker, const FaultDetectionResult *fault, CriticalityLevel criticality)
+{
+    if ((int)fault->type <= NO_FAULT || (int)fault->type >= FAULT_TYPE_COUNT)
+    {
+        return;
+    }
+
+    FaultLatencyStats *stats = &worker->latency[fault->type][criticality];
+    uint64_t now = timer_wheel_now_us();
+    uint64_t detect = fault->detectedUs > fault->raisedUs ? fault->detectedUs - fault->raisedUs : 0;
+    uint64_t recover = now > fault->raisedUs ? now - fault->raisedUs : 0;
+
+    stats->count++;
+    stats->detectSumUs += detect;
+    stats->recoverSumUs += recover;
+    if (detect > stats->detectMaxUs)
+    {
+        stats->detectMaxUs = detect;
+    }
+    if (recover > stats->recoverMaxUs)
+    {
+        stats->recoverMaxUs = recover;
+    }
+    stats->detectHistogram[latency_bucket(detect)]++;
+    stats->recoverHistogram[latency_bucket(recover)]++;
+}
+
+static DWORD WINAPI recovery_worker_func(LPVOID lpParam)
+{
+    RecoveryWorker *worker = (RecoveryWorker *)lpParam;
+    trace_thread_name("recovery worker");
+
+    while (g_recoveryRunning)
+    {
+        // Re-check from the top after every recovery so a DAL_A fault
+        // waits for at most the one recovery already in progress
+        FaultQueueCell item;
+        CriticalityLevel criticality = DAL_A;
+        int found = 0;
+        for (int level = DAL_A; level <= DAL_D && !found; level++)
+        {
+            found = fault_queue_pop(&worker->queues[level], &item);
+            criticality = (CriticalityLevel)level;
+        }
+
+        if (!found)
+        {
+            WaitForSingleObject(worker->wake, INFINITE);
+            continue;
+        }
+
+        fault_recovery_action(&item.fault);
+        fault_record_latency(worker, &item.fault, criticality);
+    }
+
+    return 0;
+}
+
+// Hand a collected fault to the worker that owns its task
+static void fault_dispatch(const FaultDetectionResult *fault, CriticalityLevel criticality)
+{
+    if (!g_recoveryRunning)
+    {
+        FaultDetectionResult copy = *fault;
+        fault_recovery_action(&copy); // No pool yet, recover inline
+        fault_record_latency(&g_recoveryWorkers[0], &copy, criticality);
+        return;
+    }
+
+    // Waiting for room would stall the intake and every fault behind it,
+    // so a full DAL_C/DAL_D queue drops the fault. DAL_A/DAL_B faults are
+    // never dropped; they wait only for a DAL_A/DAL_B backlog.
+    RecoveryWorker *worker = &g_recoveryWorkers[TASK_HANDLE_SLOT(fault->taskId) % FAULT_RECOVERY_WORKERS];
+    while (fault_queue_push(&worker->queues[criticality], FAULT_SOURCE_REPORT, fault) != 0)
+    {
+        if (criticality >= DAL_C)
+        {
+            InterlockedIncrement(&g_recoveryDropped[criticality]);
+            TRACE(TRACE_FAULT_DROPPED, fault->taskId, fault->type, criticality, 0);
+            break;
+        }
+        SetEvent(worker->wake);
+        Sleep(0);
+    }
+    SetEvent(worker->wake);
+}
+
 void fault_tolerance_init(void)
 {
     printf("Initializing fault tolerance subsystem\n");
 
     // Reset all fault status
-    for (int i = 0; i < MAX_TASKS; i++)
+    for (int i = 0; i < TASK_TABLE_MAX_CHUNKS; i++)
+    {
+        if (g_faultStateChunks[i])
+        {
+            memset(g_faultStateChunks[i], 0, TASK_TABLE_CHUNK_SIZE * sizeof(FaultTaskState));
+        }
+    }
+
+    fault_queue_init(&g_faultIntake);
+    g_faultQueueOverflows = 0;
+
+    if (g_faultEvent == NULL)
     {
-        g_injectedFaults[i] = NO_FAULT;
-        g_faultAddresses[i] = 0;
-        g_watchdogTimers[i] = 0;
-        g_watchdogDeadlines[i] = 0;
-        g_faultRecoveryCounter[i] = 0;
+        g_faultEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+        if (g_faultEvent == NULL)
+        {
+            printf("Error: Failed to create fault event\n");
+            exit(1);
+        }
     }
 
     g_lastCheckTime = GetTickCount64();
     printf("Fault tolerance initialized\n");
 }
 
-FaultDetectionResult fault_check_system(void)
+void fault_recovery_start(void)
 {
-    FaultDetectionResult result = {0};
-    uint64_t currentTime = GetTickCount64();
+    if (g_recoveryRunning)
+    {
+        return;
+    }
+
+    g_recoveryRunning = 1;
+    for (int i = 0; i < FAULT_RECOVERY_WORKERS; i++)
+    {
+        RecoveryWorker *worker = &g_recoveryWorkers[i];
+        for (int level = DAL_A; level <= DAL_D; level++)
+        {
+            fault_queue_init(&worker->queues[level]);
+        }
 
-    // Check for watchdog timeouts
-    int count;
-    Task *tasks = kernel_get_tasks(&count);
+        worker->wake = CreateEvent(NULL, FALSE, FALSE, NULL);
+        worker->thread = worker->wake ? CreateThread(NULL, 0, recovery_worker_func, worker, 0, NULL) : NULL;
+        if (worker->thread == NULL)
+        {
+            printf("Error: Failed to create fault recovery worker\n");
+            exit(1);
+        }
+        SetThreadPriority(worker->thread, THREAD_PRIORITY_HIGHEST);
+    }
 
-    for (int i = 0; i < count; i++)
+    printf("Fault recovery pool started with %d workers\n", FAULT_RECOVERY_WORKERS);
+}
+
+// Stop the pool; faults still queued for recovery are discarded
+void fault_recovery_stop(void)
+{
+    if (!g_recoveryRunning)
+    {
+        return;
+    }
+
+    g_recoveryRunning = 0;
+    for (int i = 0; i < FAULT_RECOVERY_WORKERS; i++)
+    {
+        SetEvent(g_recoveryWorkers[i].wake);
+    }
+    for (int i = 0; i < FAULT_RECOVERY_WORKERS; i++)
+    {
+        WaitForSingleObject(g_recoveryWorkers[i].thread, INFINITE);
+        CloseHandle(g_recoveryWorkers[i].thread);
+        CloseHandle(g_recoveryWorkers[i].wake);
+    }
+}
+
+// Make sure fault state exists for the first taskCapacity slots
+int fault_tolerance_reserve(int taskCapacity)
+{
+    for (int chunk = 0; chunk * TASK_TABLE_CHUNK_SIZE < taskCapacity; chunk++)
     {
-        if (tasks[i].active && g_watchdogTimers[i] > 0)
+        if (chunk >= TASK_TABLE_MAX_CHUNKS)
+        {
+            return -1;
+        }
+        if (g_faultStateChunks[chunk] == NULL)
         {
-            if (currentTime > g_watchdogDeadlines[i])
+            g_faultStateChunks[chunk] = (FaultTaskState *)calloc(TASK_TABLE_CHUNK_SIZE, sizeof(FaultTaskState));
+            if (!g_faultStateChunks[chunk])
             {
-                // Watchdog timeout detected
-                result.faultDetected = 1;
-                result.type = TIMING_FAULT;
-                result.taskId = i;
-                result.timestamp = currentTime;
-                printf("FAULT DETECTED: Watchdog timeout for task '%s'\n", tasks[i].name);
-                return result;
+                return -1;
             }
         }
+    }
+
+    return 0;
+}
+
+// Forget everything about a recycled slot so its next task starts clean.
+// Queued faults for the old task are dropped once its ID is stale.
+void fault_tolerance_release(int slot)
+{
+    FaultTaskState *state = fault_state((uint32_t)slot);
+    if (state)
+    {
+        timer_wheel_cancel(&state->watchdog);
+        memset(state, 0, sizeof(FaultTaskState));
+    }
+}
+
+// Watchdog expiry, called on the timer wheel thread
+static void watchdog_expired_callback(void *arg)
+{
+    FaultTaskState *state = (FaultTaskState *)arg;
+    if (InterlockedExchange(&state->watchdogExpired, 1) == 0)
+    {
+        state->watchdogExpiredUs = timer_wheel_now_us();
+        fault_enqueue(FAULT_SOURCE_WATCHDOG, TIMING_FAULT, state->watchdogTaskId, 0);
+    }
+}
+
+// Report a fault detected by another subsystem; safe from any thread
+int fault_report(FaultType type, uint32_t taskId, uint32_t address)
+{
+    if (type == NO_FAULT)
+    {
+        return -1;
+    }
+
+    return fault_enqueue(FAULT_SOURCE_REPORT, type, taskId, address);
+}
+
+// Block until a fault is reported or timeoutMs elapses. Returns 1 if faults
+// may be pending; spurious returns are harmless since checking never blocks.
+int fault_wait(uint32_t timeoutMs)
+{
+    if (g_faultQueueOverflows || fault_queue_ready(&g_faultIntake))
+    {
+        return 1;
+    }
+
+    return WaitForSingleObject(g_faultEvent, timeoutMs) == WAIT_OBJECT_0;
+}
+
+// Wake a thread blocked in fault_wait, e.g. for shutdown
+void fault_wake_monitor(void)
+{
+    SetEvent(g_faultEvent);
+}
+
+// Take ownership of a task's injected fault, if it still has one
+static int fault_take_injected(FaultTaskState *state, FaultDetectionResult *fault)
+{
+    FaultType type = (FaultType)InterlockedExchange(&state->injectedFault, NO_FAULT);
+    if (type == NO_FAULT)
+    {
+        return 0;
+    }
+
+    fault->type = type;
+    fault->address = state->faultAddress;
+    fault->raisedUs = state->injectedUs;
+    return 1;
+}
+
+// Validate a reported event against the task's current state
+static int fault_collect_event(FaultQueueCell *event, CriticalityLevel *criticality)
+{
+    Task task;
+    FaultDetectionResult *fault = &event->fault;
+    FaultTaskState *state = fault_state(TASK_HANDLE_SLOT(fault->taskId));
+
+    // System memory belongs to no task; treat it as critical to all of them
+    if (fault->taskId == TASK_INVALID_ID && event->source == FAULT_SOURCE_REPORT)
+    {
+        TRACE(TRACE_FAULT_DETECTED, TASK_INVALID_ID, fault->type, fault->address, TRACE_SOURCE_REPORTED);
+        fault->detectedUs = timer_wheel_now_us();
+        *criticality = DAL_A;
+        return 1;
+    }
+
+    if (!state || kernel_read_task(fault->taskId, &task) != 0)
+    {
+        return 0; // Task deleted since the report
+    }
+
+    switch (event->source)
+    {
+    case FAULT_SOURCE_WATCHDOG:
+        // A rescan, or a re-arm by the slot's next owner, may have consumed it already
+        if (!InterlockedExchange(&state->watchdogExpired, 0) || state->watchdogTaskId != fault->taskId || !task.active)
+        {
+            return 0;
+        }
+        TRACE(TRACE_FAULT_DETECTED, fault->taskId, fault->type, fault->address, TRACE_SOURCE_WATCHDOG);
+        break;
+
+    case FAULT_SOURCE_INJECTED:
+        if (!fault_take_injected(state, fault))
+        {
+            return 0;
+        }
+        TRACE(TRACE_FAULT_DETECTED, fault->taskId, fault->type, fault->address, TRACE_SOURCE_INJECTED);
+        break;
+
+    default:
+        TRACE(TRACE_FAULT_DETECTED, fault->taskId, fault->type, fault->address, TRACE_SOURCE_REPORTED);
+        break;
+    }
+
+    fault->detectedUs = timer_wheel_now_us();
+    *criticality = task.criticality;
+    return 1;
+}
+
+// Full scan of the per-task flags, only needed after the intake overflowed
+static int fault_scan_tasks(void)
+{
+    int collected = 0;
+    uint64_t currentTime = GetTickCount64();
+    int count = kernel_get_task_slot_count();
+
+    for (int i = 0; i < count; i++)
+    {
+        // Snapshot so a concurrent suspend or recycle cannot tear the view
+        Task snapshot;
+        Task *task = &snapshot;
+        FaultTaskState *state = fault_state((uint32_t)i);
+        if (!state || kernel_read_task_slot(i, &snapshot) != 0)
+        {
+            continue;
+        }
+
+        FaultDetectionResult fault = {0};
+        fault.faultDetected = 1;
+        fault.taskId = task->id;
+        fault.timestamp = currentTime;
+
+        if (state->watchdogExpired && task->active && state->watchdogTaskId == task->id &&
+            InterlockedExchange(&state->watchdogExpired, 0))
+        {
+            // Watchdog timeout detected
+            fault.type = TIMING_FAULT;
+            fault.raisedUs = state->watchdogExpiredUs;
+            fault.detectedUs = timer_wheel_now_us();
+            TRACE(TRACE_FAULT_DETECTED, task->id, fault.type, 0, TRACE_SOURCE_WATCHDOG);
+            fault_dispatch(&fault, task->criticality);
+            collected++;
+        }
 
         // Check for injected faults (for testing)
-        if (g_injectedFaults[i] != NO_FAULT)
+        if (fault_take_injected(state, &fault))
         {
-            result.faultDetected = 1;
-            result.type = g_injectedFaults[i];
-            result.taskId = i;
-            result.address = g_faultAddresses[i];
-            result.timestamp = currentTime;
-            printf("FAULT DETECTED: Injected %d fault for task '%s'\n", result.type, tasks[i].name);
-            return result;
+            fault.detectedUs = timer_wheel_now_us();
+            TRACE(TRACE_FAULT_DETECTED, task->id, fault.type, fault.address, TRACE_SOURCE_INJECTED);
+            fault_dispatch(&fault, task->criticality);
+            collected++;
         }
     }
 
-    g_lastCheckTime = currentTime;
-    return result;
+    return collected;
+}
+
+// Collect every pending fault in one pass and hand each to the recovery
+// worker owning its task. Never blocks; returns the number collected.
+int fault_check_system(void)
+{
+    int collected = 0;
+    FaultQueueCell event;
+    CriticalityLevel criticality;
+
+    while (fault_queue_pop(&g_faultIntake, &event))
+    {
+        if (fault_collect_event(&event, &criticality))
+        {
+            fault_dispatch(&event.fault, criticality);
+            collected++;
+        }
+    }
+
+    // Events lost to a full intake are recovered from the per-task flags
+    LONG overflows = g_faultQueueOverflows;
+    if (overflows)
+    {
+        collected += fault_scan_tasks();
+        InterlockedCompareExchange(&g_faultQueueOverflows, 0, overflows);
+    }
+
+    g_lastCheckTime = GetTickCount64();
+    return collected;
 }
 
+// Inject a fault into a task. A task holds one injected fault at a time:
+// injecting again before the previous one is collected would overwrite it
+// and lose its recovery, so that is refused. Returns 0, or -1.
 int fault_inject(FaultType type, uint32_t taskId, uint32_t address)
 {
-    int count;
-    Task *tasks = kernel_get_tasks(&count);
+    Task task;
+    FaultTaskState *state = fault_state(TASK_HANDLE_SLOT(taskId));
 
-    if (taskId < count)
+    if (state && type != NO_FAULT && state->injectedFault == NO_FAULT && kernel_read_task(taskId, &task) == 0)
     {
-        g_injectedFaults[taskId] = type;
-        g_faultAddresses[taskId] = address;
-        printf("Fault injected: Type %d for task '%s'\n", type, tasks[taskId].name);
+        state->faultAddress = address;
+        state->injectedUs = timer_wheel_now_us();
+        MemoryBarrier();
+        state->injectedFault = type;
+        TRACE(TRACE_FAULT_INJECTED, taskId, type, 0, 0);
+        fault_enqueue(FAULT_SOURCE_INJECTED, type, taskId, address);
         return 0; // Success
     }
 
     return -1; // Failed
 }
 
+// Roll back the memory-matrix region named by a fault address, if any
+static void fault_rollback_region(uint32_t address)
+{
+    SharedMemoryRegion region;
+    if (memory_matrix_region_from_address(address, &region) == 0)
+    {
+        int pages = memory_matrix_rollback(region);
+        TRACE(TRACE_MM_ROLLBACK, region, pages, 0, 0);
+    }
+}
+
 void fault_recovery_action(FaultDetectionResult *result)
 {
     if (!result || !result->faultDetected)
@@ -103,49 +642,64 @@ void fault_recovery_action(FaultDetectionResult *result)
         return;
     }
 
-    int count;
-    Task *tasks = kernel_get_tasks(&count);
+    // Faults in system memory, e.g. found by the scrubber
+    if (result->taskId == TASK_INVALID_ID)
+    {
+        TRACE(TRACE_FAULT_RECOVERY_BEGIN, result->taskId, result->type, 0, 0);
+        if (result->type == MEMORY_FAULT)
+        {
+            fault_rollback_region(result->address);
+        }
+        else
+        {
+            printf("No recovery action for system fault type %d\n", result->type);
+        }
+        TRACE(TRACE_FAULT_RECOVERY_END, result->taskId, result->type, 0, 0);
+        return;
+    }
+
+    Task snapshot;
+    Task *faultyTask = &snapshot;
+    FaultTaskState *state = fault_state(TASK_HANDLE_SLOT(result->taskId));
 
-    if (result->taskId >= count)
+    if (!state || kernel_read_task(result->taskId, &snapshot) != 0)
     {
         printf("Error: Invalid task ID in fault recovery\n");
         return;
     }
 
-    Task *faultyTask = &tasks[result->taskId];
-
-    printf("Executing recovery for task '%s' (fault type: %d)\n", faultyTask->name, result->type);
+    TRACE(TRACE_FAULT_RECOVERY_BEGIN, result->taskId, result->type, 0, 0);
+    state->recoveryTaskId = result->taskId;
 
     switch (result->type)
     {
     case TIMING_FAULT:
         // Reset watchdog and mark task for re-execution
         set_watchdog_timer(result->taskId, faultyTask->deadlineMs * 2); // Extended deadline
-        g_faultRecoveryCounter[result->taskId]++;
+        state->faultRecoveryCounter++;
         break;
 
     case MEMORY_FAULT:
-        // Restore task state from backup
-        printf("Restoring task state from backup\n");
-        g_faultRecoveryCounter[result->taskId]++;
+        // Roll a corrupted region back now; the task's own state is rolled
+        // back by the scheduler before its next job
+        fault_rollback_region(result->address);
+        checkpoint_request_rollback(faultyTask->stateArea);
+        state->faultRecoveryCounter++;
         break;
 
     case COMPUTATION_FAULT:
         // Re-execute the task
-        printf("Scheduling task re-execution\n");
-        g_faultRecoveryCounter[result->taskId]++;
+        state->faultRecoveryCounter++;
         break;
 
     case COMMUNICATION_FAULT:
         // Reset communication channels
-        printf("Resetting communication channels\n");
-        g_faultRecoveryCounter[result->taskId]++;
+        state->faultRecoveryCounter++;
         break;
 
     case POWER_FAULT:
         // Switch to low-power mode
-        printf("Switching to low-power mode\n");
-        g_faultRecoveryCounter[result->taskId]++;
+        state->faultRecoveryCounter++;
         break;
 
     default:
@@ -153,28 +707,23 @@ void fault_recovery_action(FaultDetectionResult *result)
         break;
     }
 
-    // Clear the injected fault (for testing)
-    g_injectedFaults[result->taskId] = NO_FAULT;
-    g_faultAddresses[result->taskId] = 0;
+    if (result->type != NO_FAULT && result->type < FAULT_TYPE_COUNT)
+    {
+        sched_log_fault(result->taskId, result->type); // Raised the task's recovery factor
+    }
+    TRACE(TRACE_FAULT_RECOVERY_END, result->taskId, result->type, 0, 0);
 }
 
-uint8_t tmr_voting(uint32_t result1, uint32_t result2, uint32_t result3)
+uint32_t tmr_voting(uint32_t result1, uint32_t result2, uint32_t result3)
 {
-    // Simple majority voting for Triple Modular Redundancy
-    if (result1 == result2 || result1 == result3)
+    // Bitwise majority for Triple Modular Redundancy; equals the word
+    // majority whenever two results agree, and masks single-bit upsets otherwise
+    if (result1 != result2 && result1 != result3 && result2 != result3)
     {
-        return result1;
-    }
-    else if (result2 == result3)
-    {
-        return result2;
-    }
-    else
-    {
-        // No majority, this is an error case
         printf("TMR ERROR: No majority in voting\n");
-        return 0xFF; // Error code
     }
+
+    return (result1 & result2) | (result1 & result3) | (result2 & result3);
 }
 
 float get_fault_recovery_factor(uint32_t taskId)
@@ -182,10 +731,13 @@ float get_fault_recovery_factor(uint32_t taskId)
     // Higher value indicates task needs priority boost for recovery
     float factor = 1.0f;
 
-    if (taskId < MAX_TASKS && g_faultRecoveryCounter[taskId] > 0)
+    FaultTaskState *state = fault_state(TASK_HANDLE_SLOT(taskId));
+
+    // A stale ID must not inherit the recoveries of the slot's new owner
+    if (state && state->faultRecoveryCounter > 0 && state->recoveryTaskId == taskId)
     {
         // Apply exponential backoff for repeated faults
-        factor = 1.0f + (float)(g_faultRecoveryCounter[taskId]) * 0.2f;
+        factor = 1.0f + (float)(state->faultRecoveryCounter) * 0.2f;
         if (factor > 2.0f)
             factor = 2.0f; // Cap at 2.0
     }
@@ -195,10 +747,147 @@ float get_fault_recovery_factor(uint32_t taskId)
 
 void set_watchdog_timer(uint32_t taskId, uint32_t timeoutMs)
 {
-    if (taskId < MAX_TASKS)
+    FaultTaskState *state = fault_state(TASK_HANDLE_SLOT(taskId));
+    Task snapshot;
+
+    // A stale ID would re-arm the watchdog of the slot's new owner
+    if (state && kernel_read_task(taskId, &snapshot) == 0)
     {
-        g_watchdogTimers[taskId] = timeoutMs;
-        g_watchdogDeadlines[taskId] = GetTickCount64() + timeoutMs;
+        // Re-arming replaces the previous deadline in O(1). An expiry the
+        // monitor has not handled yet is left for it, unless it belongs to
+        // the slot's previous owner.
+        if (state->watchdogTaskId != taskId)
+        {
+            InterlockedExchange(&state->watchdogExpired, 0);
+        }
+        state->watchdogTaskId = taskId;
+        state->watchdogTimer = timeoutMs;
+        timer_wheel_arm(&state->watchdog, (uint64_t)timeoutMs * 1000, 0, watchdog_expired_callback, state);
         printf("Watchdog set for task %u: %u ms\n", taskId, timeoutMs);
     }
 }
+
+const char *fault_type_name(FaultType type)
+{
+    switch (type)
+    {
+    case NO_FAULT:
+        return "NONE";
+    case TIMING_FAULT:
+        return "TIMING";
+    case MEMORY_FAULT:
+        return "MEMORY";
+    case COMPUTATION_FAULT:
+        return "COMPUTATION";
+    case COMMUNICATION_FAULT:
+        return "COMMUNICATION";
+    case POWER_FAULT:
+        return "POWER";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+// Sum the per-worker latency distributions for one type and criticality
+int fault_get_latency_stats(FaultType type, CriticalityLevel criticality, FaultLatencyStats *stats)
+{
+    if ((int)type <= NO_FAULT || (int)type >= FAULT_TYPE_COUNT || criticality < DAL_A || criticality > DAL_D || !stats)
+    {
+        return -1;
+    }
+
+    memset(stats, 0, sizeof(FaultLatencyStats));
+    for (int i = 0; i < FAULT_RECOVERY_WORKERS; i++)
+    {
+        const FaultLatencyStats *worker = &g_recoveryWorkers[i].latency[type][criticality];
+        stats->count += worker->count;
+        stats->detectSumUs += worker->detectSumUs;
+        stats->recoverSumUs += worker->recoverSumUs;
+        if (worker->detectMaxUs > stats->detectMaxUs)
+        {
+            stats->detectMaxUs = worker->detectMaxUs;
+        }
+        if (worker->recoverMaxUs > stats->recoverMaxUs)
+        {
+            stats->recoverMaxUs = worker->recoverMaxUs;
+        }
+        for (int bucket = 0; bucket < FAULT_LATENCY_BUCKETS; bucket++)
+        {
+            stats->detectHistogram[bucket] += worker->detectHistogram[bucket];
+            stats->recoverHistogram[bucket] += worker->recoverHistogram[bucket];
+        }
+    }
+
+    return 0;
+}
+
+void fault_reset_latency_stats(void)
+{
+    for (int i = 0; i < FAULT_RECOVERY_WORKERS; i++)
+    {
+        memset(g_recoveryWorkers[i].latency, 0, sizeof(g_recoveryWorkers[i].latency));
+    }
+    for (int level = DAL_A; level <= DAL_D; level++)
+    {
+        InterlockedExchange(&g_recoveryDropped[level], 0);
+    }
+}
+
+// Upper bound (us) of the bucket holding the given percentile (0-100)
+uint64_t fault_latency_percentile(const uint32_t *histogram, uint64_t count, double percentile)
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)count + 0.5);
+    uint64_t seen = 0;
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+
+    for (int bucket = 0; bucket < FAULT_LATENCY_BUCKETS; bucket++)
+    {
+        seen += histogram[bucket];
+        if (seen >= rank)
+        {
+            return latency_bucket_limit(bucket);
+        }
+    }
+
+    return latency_bucket_limit(FAULT_LATENCY_BUCKETS - 1);
+}
+
+void fault_latency_dump(void)
+{
+    static const char *levels[] = {"DAL_A", "DAL_B", "DAL_C", "DAL_D"};
+
+    printf("\nFault recovery latency (us, raised -> recovered):\n");
+    for (int type = TIMING_FAULT; type < FAULT_TYPE_COUNT; type++)
+    {
+        for (int level = DAL_A; level <= DAL_D; level++)
+        {
+            FaultLatencyStats stats;
+            if (fault_get_latency_stats((FaultType)type, (CriticalityLevel)level, &stats) != 0 || stats.count == 0)
+            {
+                continue;
+            }
+
+            uint64_t p99 = fault_latency_percentile(stats.recoverHistogram, stats.count, 99.0);
+            printf("  %-13s %s: %llu faults, detect avg %llu, recover avg %llu p99 <%llu max %llu\n",
+                   fault_type_name((FaultType)type), levels[level],
+                   (unsigned long long)stats.count,
+                   (unsigned long long)(stats.detectSumUs / stats.count),
+                   (unsigned long long)(stats.recoverSumUs / stats.count),
+                   (unsigned long long)(p99 < stats.recoverMaxUs ? p99 : stats.recoverMaxUs),
+                   (unsigned long long)stats.recoverMaxUs);
+        }
+    }
+    if (g_recoveryDropped[DAL_C] || g_recoveryDropped[DAL_D])
+    {
+        printf("  Dropped at full recovery queues: %ld DAL_C, %ld DAL_D\n", (long)g_recoveryDropped[DAL_C],
+               (long)g_recoveryDropped[DAL_D]);
+    }
+}
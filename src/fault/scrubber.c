@@ -0,0 +1,425 @@
+#include "../include/scrubber.h"
+#include "../include/fault_tolerance.h"
+#include "../include/system_config.h"
+#include "../include/timer_wheel.h"
+#include "../include/trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+// The SSE4.2 crc32 instruction computes CRC32C directly; 8 bytes per step on x64
+#if defined(_M_X64) || defined(__x86_64__)
+#define SCRUB_CRC_X64 1
+#include <immintrin.h>
+#else
+#define SCRUB_CRC_X64 0
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SCRUB_TARGET_SSE42
+#else
+#define SCRUB_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+
+#ifndef PF_SSE4_2_INSTRUCTIONS_AVAILABLE
+#define PF_SSE4_2_INSTRUCTIONS_AVAILABLE 38
+#endif
+
+#define CRC32C_POLY 0x82F63B78u // Castagnoli, reflected
+
+// One protected area with a checksum per SCRUB_BLOCK_SIZE block
+typedef struct
+{
+    const uint8_t *base;
+    size_t size;
+    uint32_t blockCount;
+    uint32_t *checksums;
+    uint8_t *failed; // Already reported; cleared once the block verifies or is rewritten
+    uint32_t ownerTaskId;
+    uint32_t faultAddressBase; // 0 reports the block's own (truncated) address
+    ScrubLockFn lock;
+    ScrubLockFn unlock;
+    void *lockArg;
+    int inUse;
+    char name[32];
+} ScrubArea;
+
+static ScrubArea g_scrubAreas[SCRUB_MAX_AREAS]; // Area ID n lives at index n - 1
+static CRITICAL_SECTION g_scrubLock;            // Serializes scrubbing and registration
+static ScrubberStats g_scrubStats;
+static int g_cursorArea = 0;
+static uint32_t g_cursorBlock = 0;
+static uint64_t g_cycleStartUs = 0;
+static uint32_t g_crcTable[256];
+static int g_useSse42 = 0;
+static int g_initialized = 0;
+
+static uint32_t crc32c_table(uint32_t crc, const uint8_t *data, size_t size)
+{
+    while (size--)
+    {
+        crc = g_crcTable[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#if SCRUB_CRC_X64
+SCRUB_TARGET_SSE42
+static uint32_t crc32c_sse42(uint32_t crc, const uint8_t *data, size_t size)
+{
+    uint64_t crc64 = crc;
+    for (; size >= 8; data += 8, size -= 8)
+    {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+
+    crc = (uint32_t)crc64;
+    while (size--)
+    {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+#endif
+
+uint32_t scrubber_crc32c(const void *data, size_t size)
+{
+#if SCRUB_CRC_X64
+    if (g_useSse42)
+    {
+        return ~crc32c_sse42(0xFFFFFFFFu, (const uint8_t *)data, size);
+    }
+#endif
+    return ~crc32c_table(0xFFFFFFFFu, (const uint8_t *)data, size);
+}
+
+const char *scrubber_isa(void)
+{
+    return g_useSse42 ? "SSE4.2" : "table";
+}
+
+static ScrubArea *scrub_area(int areaId)
+{
+    if (areaId <= 0 || areaId > SCRUB_MAX_AREAS || !g_scrubAreas[areaId - 1].inUse)
+    {
+        return NULL;
+    }
+    return &g_scrubAreas[areaId - 1];
+}
+
+static uint32_t scrub_block_checksum(const ScrubArea *area, uint32_t block)
+{
+    size_t offset = (size_t)block * SCRUB_BLOCK_SIZE;
+    size_t length = area->size - offset < SCRUB_BLOCK_SIZE ? area->size - offset : SCRUB_BLOCK_SIZE;
+    return scrubber_crc32c(area->base + offset, length);
+}
+
+// Compare one block with its checksum, with the area's lock held. Returns
+// 1 the first time the block is found bad.
+static int scrub_compare_block(ScrubArea *area, uint32_t block)
+{
+    int bad = scrub_block_checksum(area, block) != area->checksums[block];
+    int report = bad && !area->failed[block];
+    area->failed[block] = (uint8_t)bad;
+    InterlockedIncrement64((volatile LONGLONG *)&g_scrubStats.blocksVerified);
+    return report;
+}
+
+// Report a newly bad block as a MEMORY_FAULT
+static void scrub_report_block(ScrubArea *area, uint32_t block)
+{
+    size_t offset = (size_t)block * SCRUB_BLOCK_SIZE;
+    uint32_t address = area->faultAddressBase ? area->faultAddressBase + (uint32_t)offset
+                                              : (uint32_t)(uintptr_t)(area->base + offset);
+    InterlockedIncrement64((volatile LONGLONG *)&g_scrubStats.failures);
+    TRACE(TRACE_SCRUB_MISMATCH, area->ownerTaskId, address, offset, 0);
+    fault_report(MEMORY_FAULT, area->ownerTaskId, address);
+}
+
+// Check one block; reports a MEMORY_FAULT the first time it is found bad
+static int scrub_verify_block(ScrubArea *area, uint32_t block)
+{
+    if (area->lock)
+    {
+        area->lock(area->lockArg);
+    }
+    int report = scrub_compare_block(area, block);
+    if (area->unlock)
+    {
+        area->unlock(area->lockArg);
+    }
+
+    if (report)
+    {
+        scrub_report_block(area, block);
+    }
+    return report;
+}
+
+static void scrub_cycle_complete(void)
+{
+    uint64_t now = timer_wheel_now_us();
+    g_scrubStats.cycles++;
+    g_scrubStats.lastCycleUs = now - g_cycleStartUs;
+    if (g_scrubStats.lastCycleUs > g_scrubStats.maxCycleUs)
+    {
+        g_scrubStats.maxCycleUs = g_scrubStats.lastCycleUs;
+    }
+    g_cycleStartUs = now;
+}
+
+void scrubber_init(void)
+{
+    if (g_initialized)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+        }
+        g_crcTable[i] = crc;
+    }
+#if SCRUB_CRC_X64
+    g_useSse42 = IsProcessorFeaturePresent(PF_SSE4_2_INSTRUCTIONS_AVAILABLE) != 0;
+#endif
+
+    InitializeCriticalSection(&g_scrubLock);
+    memset(g_scrubAreas, 0, sizeof(g_scrubAreas));
+    memset(&g_scrubStats, 0, sizeof(g_scrubStats));
+    g_initialized = 1;
+
+    printf("Memory scrubber initialized: CRC32C (%s), %d byte blocks, %d blocks per %d ms slot\n",
+           scrubber_isa(), SCRUB_BLOCK_SIZE, SCRUB_BLOCKS_PER_SLOT, SCRUB_SLOT_MS);
+}
+
+// Start protecting [base, base + size) with checksums of its current contents.
+// Legitimate writers must call scrubber_update, holding lock if one is given.
+// Returns the area ID, or -1.
+int scrubber_protect(const char *name, const void *base, size_t size, uint32_t ownerTaskId,
+                     uint32_t faultAddressBase, ScrubLockFn lock, ScrubLockFn unlock, void *lockArg)
+{
+    if (!g_initialized || !base || size == 0)
+    {
+        return -1;
+    }
+
+    uint32_t blockCount = (uint32_t)((size + SCRUB_BLOCK_SIZE - 1) / SCRUB_BLOCK_SIZE);
+    uint32_t *checksums = (uint32_t *)malloc(blockCount * sizeof(uint32_t));
+    uint8_t *failed = (uint8_t *)calloc(blockCount, 1);
+    if (!checksums || !failed)
+    {
+        free(checksums);
+        free(failed);
+        return -1;
+    }
+
+    EnterCriticalSection(&g_scrubLock);
+    int index = 0;
+    while (index < SCRUB_MAX_AREAS && g_scrubAreas[index].inUse)
+    {
+        index++;
+    }
+    if (index == SCRUB_MAX_AREAS)
+    {
+        LeaveCriticalSection(&g_scrubLock);
+        free(checksums);
+        free(failed);
+        printf("Error: No free scrubber area for '%s'\n", name ? name : "unnamed");
+        return -1;
+    }
+
+    ScrubArea *area = &g_scrubAreas[index];
+    memset(area, 0, sizeof(ScrubArea));
+    area->base = (const uint8_t *)base;
+    area->size = size;
+    area->blockCount = blockCount;
+    area->checksums = checksums;
+    area->failed = failed;
+    area->ownerTaskId = ownerTaskId;
+    area->faultAddressBase = faultAddressBase;
+    area->lock = lock;
+    area->unlock = unlock;
+    area->lockArg = lockArg;
+    strncpy(area->name, name ? name : "unnamed", sizeof(area->name) - 1);
+
+    if (lock)
+    {
+        lock(lockArg);
+    }
+    for (uint32_t block = 0; block < blockCount; block++)
+    {
+        checksums[block] = scrub_block_checksum(area, block);
+    }
+    if (unlock)
+    {
+        unlock(lockArg);
+    }
+
+    area->inUse = 1;
+    g_scrubStats.protectedBlocks += blockCount;
+    LeaveCriticalSection(&g_scrubLock);
+
+    return index + 1;
+}
+
+void scrubber_unprotect(int areaId)
+{
+    EnterCriticalSection(&g_scrubLock);
+    ScrubArea *area = scrub_area(areaId);
+    if (area)
+    {
+        area->inUse = 0;
+        g_scrubStats.protectedBlocks -= area->blockCount;
+        free(area->checksums);
+        free(area->failed);
+        area->checksums = NULL;
+        area->failed = NULL;
+    }
+    LeaveCriticalSection(&g_scrubLock);
+}
+
+// Re-checksum the blocks covering a legitimate write. Called by the
+// writer with the area's lock held; does not take the scrubber lock.
+void scrubber_update(int areaId, size_t offset, size_t size)
+{
+    ScrubArea *area = scrub_area(areaId);
+    if (!area || size == 0 || offset >= area->size)
+    {
+        return;
+    }
+
+    uint32_t first = (uint32_t)(offset / SCRUB_BLOCK_SIZE);
+    uint32_t last = (uint32_t)((offset + size - 1) / SCRUB_BLOCK_SIZE);
+    if (last >= area->blockCount)
+    {
+        last = area->blockCount - 1;
+    }
+
+    for (uint32_t block = first; block <= last; block++)
+    {
+        area->checksums[block] = scrub_block_checksum(area, block);
+        area->failed[block] = 0;
+    }
+}
+
+// Verify the blocks covering [offset, offset + size) now, e.g. before a
+// checkpoint copies them. Called with the area's lock held, like
+// scrubber_update; does not take the scrubber lock. Returns the number of
+// bad blocks (reported or not), or -1 for an unknown area.
+int scrubber_verify_range(int areaId, size_t offset, size_t size)
+{
+    ScrubArea *area = scrub_area(areaId);
+    if (!area)
+    {
+        return -1;
+    }
+    if (size == 0 || offset >= area->size)
+    {
+        return 0;
+    }
+
+    uint32_t first = (uint32_t)(offset / SCRUB_BLOCK_SIZE);
+    uint32_t last = (uint32_t)((offset + size - 1) / SCRUB_BLOCK_SIZE);
+    if (last >= area->blockCount)
+    {
+        last = area->blockCount - 1;
+    }
+
+    int bad = 0;
+    for (uint32_t block = first; block <= last; block++)
+    {
+        if (scrub_compare_block(area, block))
+        {
+            scrub_report_block(area, block);
+        }
+        bad += area->failed[block];
+    }
+    return bad;
+}
+
+// Verify up to blockBudget blocks, continuing round-robin from the last
+// call. A full cycle takes ceil(protectedBlocks / budget) calls, which
+// bounds how long silent corruption can go unnoticed. Returns the number
+// of newly failed blocks.
+int scrubber_run(uint32_t blockBudget)
+{
+    int failures = 0;
+
+    if (!g_initialized)
+    {
+        return 0;
+    }
+
+    EnterCriticalSection(&g_scrubLock);
+    if (g_cycleStartUs == 0)
+    {
+        g_cycleStartUs = timer_wheel_now_us();
+    }
+
+    for (uint32_t n = 0; n < blockBudget && g_scrubStats.protectedBlocks > 0; n++)
+    {
+        while (!g_scrubAreas[g_cursorArea].inUse || g_cursorBlock >= g_scrubAreas[g_cursorArea].blockCount)
+        {
+            g_cursorBlock = 0;
+            if (++g_cursorArea == SCRUB_MAX_AREAS)
+            {
+                g_cursorArea = 0;
+                scrub_cycle_complete();
+            }
+        }
+        failures += scrub_verify_block(&g_scrubAreas[g_cursorArea], g_cursorBlock++);
+    }
+    LeaveCriticalSection(&g_scrubLock);
+
+    return failures;
+}
+
+// Verify a whole area now, e.g. before trusting it. Returns the number of
+// bad blocks (reported or not), or -1 for an unknown area.
+int scrubber_verify(int areaId)
+{
+    int bad = 0;
+
+    EnterCriticalSection(&g_scrubLock);
+    ScrubArea *area = scrub_area(areaId);
+    if (!area)
+    {
+        LeaveCriticalSection(&g_scrubLock);
+        return -1;
+    }
+
+    for (uint32_t block = 0; block < area->blockCount; block++)
+    {
+        scrub_verify_block(area, block);
+        bad += area->failed[block];
+    }
+    LeaveCriticalSection(&g_scrubLock);
+
+    return bad;
+}
+
+void scrubber_get_stats(ScrubberStats *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+    if (!g_initialized)
+    {
+        memset(stats, 0, sizeof(ScrubberStats));
+        return;
+    }
+
+    EnterCriticalSection(&g_scrubLock);
+    *stats = g_scrubStats;
+    LeaveCriticalSection(&g_scrubLock);
+}
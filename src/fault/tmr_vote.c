@@ -0,0 +1,215 @@
+#include "../include/tmr_vote.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <windows.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TMR_VOTE_X86 1
+#include <immintrin.h>
+#else
+#define TMR_VOTE_X86 0
+#endif
+
+// MSVC accepts AVX2 intrinsics anywhere; GCC and Clang need the target enabled per function
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TMR_TARGET_AVX2
+#else
+#define TMR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#ifndef PF_AVX2_INSTRUCTIONS_AVAILABLE
+#define PF_AVX2_INSTRUCTIONS_AVAILABLE 40
+#endif
+
+// Instruction set used for voting, picked once at first use
+typedef enum
+{
+    TMR_ISA_UNKNOWN,
+    TMR_ISA_SCALAR,
+    TMR_ISA_SSE2,
+    TMR_ISA_AVX2
+} TmrIsa;
+
+static volatile TmrIsa g_tmrIsa = TMR_ISA_UNKNOWN;
+
+static TmrIsa tmr_detect_isa(void)
+{
+    if (g_tmrIsa == TMR_ISA_UNKNOWN)
+    {
+#if TMR_VOTE_X86
+        g_tmrIsa = IsProcessorFeaturePresent(PF_AVX2_INSTRUCTIONS_AVAILABLE) ? TMR_ISA_AVX2 : TMR_ISA_SSE2;
+#else
+        g_tmrIsa = TMR_ISA_SCALAR;
+#endif
+    }
+    return g_tmrIsa;
+}
+
+static uint32_t popcount64(uint64_t value)
+{
+    value = value - ((value >> 1) & 0x5555555555555555ULL);
+    value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (uint32_t)((value * 0x0101010101010101ULL) >> 56);
+}
+
+// Vote one word of up to 8 bytes; handles reporting and correction
+static void vote_word(uint8_t *replicas[3], size_t offset, size_t length, uint8_t *out, int flags,
+                      TmrVoteReport *report)
+{
+    uint64_t a = 0, b = 0, c = 0;
+    memcpy(&a, replicas[0] + offset, length);
+    memcpy(&b, replicas[1] + offset, length);
+    memcpy(&c, replicas[2] + offset, length);
+
+    uint64_t majority = (a & b) | (a & c) | (b & c);
+    if (out)
+    {
+        memcpy(out + offset, &majority, length);
+    }
+
+    uint64_t diff[3] = {a ^ majority, b ^ majority, c ^ majority};
+    if (!(diff[0] | diff[1] | diff[2]))
+    {
+        return;
+    }
+
+    uint8_t mask = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        if (diff[i])
+        {
+            mask |= (uint8_t)(1u << i);
+            report->minorityBits[i] += popcount64(diff[i]);
+            if (flags & TMR_VOTE_CORRECT)
+            {
+                memcpy(replicas[i] + offset, &majority, length);
+            }
+        }
+    }
+
+    if (report->locationCount < TMR_MAX_REPORTED_MISMATCHES)
+    {
+        report->locations[report->locationCount].offset = offset;
+        report->locations[report->locationCount].minorityMask = mask;
+        report->locationCount++;
+    }
+    report->mismatchedWords++;
+}
+
+// Scalar fallback for [start, end); also used for vector blocks that disagree
+static void vote_range_scalar(uint8_t *replicas[3], size_t start, size_t end, uint8_t *out, int flags,
+                              TmrVoteReport *report)
+{
+    for (size_t offset = start; offset < end; offset += 8)
+    {
+        vote_word(replicas, offset, end - offset < 8 ? end - offset : 8, out, flags, report);
+    }
+}
+
+#if TMR_VOTE_X86
+// 16 bytes per step. Agreeing blocks cost three loads, five logic ops and a
+// test; only blocks that disagree drop to the scalar path for reporting.
+static size_t vote_sse2(uint8_t *replicas[3], size_t size, uint8_t *out, int flags, TmrVoteReport *report)
+{
+    size_t offset = 0;
+    for (; offset + 16 <= size; offset += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(replicas[0] + offset));
+        __m128i b = _mm_loadu_si128((const __m128i *)(replicas[1] + offset));
+        __m128i c = _mm_loadu_si128((const __m128i *)(replicas[2] + offset));
+        __m128i majority = _mm_or_si128(_mm_and_si128(a, b), _mm_and_si128(c, _mm_or_si128(a, b)));
+        __m128i diff = _mm_or_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, c));
+
+        // SSE2 has no ptest, so compare the any-difference mask against zero
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) == 0xFFFF)
+        {
+            if (out)
+            {
+                _mm_storeu_si128((__m128i *)(out + offset), majority);
+            }
+            continue;
+        }
+        vote_range_scalar(replicas, offset, offset + 16, out, flags, report);
+    }
+    return offset;
+}
+
+TMR_TARGET_AVX2
+static size_t vote_avx2(uint8_t *replicas[3], size_t size, uint8_t *out, int flags, TmrVoteReport *report)
+{
+    size_t offset = 0;
+    for (; offset + 32 <= size; offset += 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(replicas[0] + offset));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(replicas[1] + offset));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(replicas[2] + offset));
+        __m256i majority = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        __m256i diff = _mm256_or_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, c));
+
+        if (_mm256_testz_si256(diff, diff))
+        {
+            if (out)
+            {
+                _mm256_storeu_si256((__m256i *)(out + offset), majority);
+            }
+            continue;
+        }
+        vote_range_scalar(replicas, offset, offset + 32, out, flags, report);
+    }
+    return offset;
+}
+#endif
+
+// Bitwise majority vote over three equally sized buffers. The majority is
+// written to out (may be NULL, or alias one replica); with TMR_VOTE_CORRECT
+// the minority copies are repaired in place. Returns the number of 64-bit
+// words in which the replicas disagreed.
+size_t tmr_vote_buffers(void *replica0, void *replica1, void *replica2, size_t size,
+                        void *out, int flags, TmrVoteReport *report)
+{
+    TmrVoteReport scratch;
+    uint8_t *replicas[3] = {(uint8_t *)replica0, (uint8_t *)replica1, (uint8_t *)replica2};
+    size_t offset = 0;
+
+    if (!replica0 || !replica1 || !replica2)
+    {
+        return 0;
+    }
+    if (!report)
+    {
+        report = &scratch;
+    }
+    memset(report, 0, sizeof(TmrVoteReport));
+
+    switch (tmr_detect_isa())
+    {
+#if TMR_VOTE_X86
+    case TMR_ISA_AVX2:
+        offset = vote_avx2(replicas, size, (uint8_t *)out, flags, report);
+        break;
+    case TMR_ISA_SSE2:
+        offset = vote_sse2(replicas, size, (uint8_t *)out, flags, report);
+        break;
+#endif
+    default:
+        break;
+    }
+
+    vote_range_scalar(replicas, offset, size, (uint8_t *)out, flags, report);
+    return report->mismatchedWords;
+}
+
+const char *tmr_vote_isa(void)
+{
+    switch (tmr_detect_isa())
+    {
+    case TMR_ISA_AVX2:
+        return "AVX2";
+    case TMR_ISA_SSE2:
+        return "SSE2";
+    default:
+        return "scalar";
+    }
+}
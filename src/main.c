@@ -4,6 +4,20 @@
 #include "../include/ml_engine.h"
 #include "../include/fault_tolerance.h"
 #include "../include/memory_matrix.h"
+#include "../include/fault_campaign.h"
+#include "../include/trace.h"
+#include "../include/tmr_executor.h"
+#include "../include/checkpoint.h"
+#include "../include/scrubber.h"
+#include "../include/job_executor.h"
+#include "../include/workload.h"
+#include "../include/sched_log.h"
+#include "../include/schedulability.h"
+#include "../include/job_stats.h"
+#include "../include/sched_policy.h"
+#include "../include/mixed_criticality.h"
+#include "../include/reservation_server.h"
+#include "../include/cyclic_schedule.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -15,18 +29,57 @@
 // External kernel functions
 extern void kernel_init(void);
 extern void kernel_start(void);
+extern int kernel_set_tickless(uint8_t enabled);
+extern int kernel_is_tickless(void);
+extern uint64_t kernel_get_tick_count(void);
 extern void kernel_stop(void);
 extern void kernel_update_load(float cpuLoad, float memoryUsage);
 extern SystemStateVector *kernel_get_system_state(void);
+extern int kernel_get_running(void);
+extern int kernel_read_task_slot(int slot, Task *snapshot);
+extern int kernel_get_task_slot_count(void);
+extern int kernel_get_overdue_releases(uint32_t taskId);
+
+// Output of the safety task, committed by the TMR vote
+typedef struct
+{
+    uint32_t cycle;
+    float actuatorCommand;
+} SafetyOutput;
+
+static SafetyOutput g_safetyFallback;
+// Checkpointed task state when available. Only SafetyCritical's own jobs
+// dereference it, and they pin the state, so it stays valid for them even
+// if the task is deleted.
+static SafetyOutput *g_safetyOutput = &g_safetyFallback;
+static int g_reportServer = -1; // Aperiodic health reports
 
 // Example task functions
 void safety_critical_task(void *args);
 void control_task(void *args);
 void monitoring_task(void *args);
 void background_task(void *args);
+void health_report_handler(void *args);
+
+// Command line options
+typedef struct
+{
+    FaultCampaignConfig campaign;
+    const char *tracePath;
+    uint32_t traceCategories;
+    const char *recordPath;   // Log scheduler inputs for policy_eval
+    const char *workloadPath; // Replace the example tasks with a workload file
+    const char *generatePath; // Write a synthetic workload and exit
+    const char *cyclicPath;   // Dispatch from a cyclic table, written here ("-" to skip writing)
+    int tickless;             // -1 keeps SCHEDULER_TICKLESS
+    WorkloadConfig generator;
+} RunOptions;
 
 // Test fault injection
 void inject_random_faults(void);
+int parse_args(int argc, char *argv[], RunOptions *options);
+int start_cyclic_executive(const char *path);
+void run_interactive(void);
 DWORD WINAPI system_monitor_thread(LPVOID lpParam);
 
 // Utility functions
@@ -35,21 +88,114 @@ void print_jitter_statistics(void);
 
 int main(int argc, char *argv[])
 {
+    RunOptions options;
+    WorkloadSet workload;
+    int exitCode = 0;
+
+    if (parse_args(argc, argv, &options) != 0)
+    {
+        printf("Usage: %s [--campaign <report.json> [--duration <ms>] [--rate <faults/s>]\n"
+               "          [--types TIMING,MEMORY,...] [--seed <n>] [--script <file>]]\n"
+               "          [--trace <trace.bin> [--trace-categories SCHED,TASK,FAULT,MEMORY,TMR,BUDGET]]\n"
+               "          [--record <sched.log>] [--workload <file>] [--cyclic <table.c>|-]\n"
+               "          [--tickless 0|1]\n"
+               "       %s --generate <file> [--tasks <n>] [--utilization <u>] [--alpha <a>] [--periods <min:max>]\n"
+               "          [--deadline-ratio <r>] [--mix <A:B:C:D>] [--sporadic <percent>] [--duration <ms>] [--seed <n>]\n",
+               argv[0], argv[0]);
+        return 1;
+    }
+    FaultCampaignConfig *campaign = &options.campaign;
+    int campaignMode = campaign->outputPath != NULL;
+
+    if (options.generatePath)
+    {
+        if (workload_generate(&options.generator, &workload) != 0 || workload_save(options.generatePath, &workload) != 0)
+        {
+            return 1;
+        }
+        printf("Generated %u tasks (utilization %.3f, %u sporadic arrivals) into %s\n",
+               workload.taskCount, workload_utilization(&workload), workload.jobCount, options.generatePath);
+        workload_free(&workload);
+        return 0;
+    }
+    if (options.workloadPath && workload_load(options.workloadPath, &workload) != 0)
+    {
+        return 1;
+    }
+
     printf("Starting Hardware-Accelerated ML RTOS Simulation\n");
     printf("-----------------------------------------------\n\n");
 
     // Initialize kernel subsystems
     kernel_init();
+    if (options.tickless >= 0 && kernel_set_tickless((uint8_t)options.tickless) != 0)
+    {
+        return 1;
+    }
+
+    // Before the tasks exist, so their names are in the trace
+    if (options.tracePath && trace_start(options.tracePath, options.traceCategories) != 0)
+    {
+        return 1;
+    }
+    if (options.recordPath && sched_log_start(options.recordPath) != 0)
+    {
+        return 1;
+    }
 
     // Create tasks
-    Task task1, task2, task3, task4;
+    if (options.workloadPath)
+    {
+        workload_apply(&workload);
+    }
+    else
+    {
+        Task task1, task2, task3, task4;
+
+        // Admission control may reject a task; the demo needs all four
+        if (task_create_ex(&task1, "SafetyCritical", safety_critical_task, NULL, 100, 100, 10, DAL_A) < 0 ||
+            task_create_ex(&task2, "Control", control_task, NULL, 200, 180, 25, DAL_B) < 0 ||
+            task_create_ex(&task3, "Monitoring", monitoring_task, NULL, 500, 450, 20, DAL_C) < 0 ||
+            task_create_ex(&task4, "Background", background_task, NULL, 1000, 900, 50, DAL_D) < 0)
+        {
+            printf("Error: Demo task set was not admitted\n");
+            return 1;
+        }
+
+        // SafetyCritical usually needs 10 ms. A job past 15 ms raises the
+        // criticality mode to DAL_B and sheds the tasks that cannot afford
+        // it; the raised modes are admitted with its DAL_A budget of 20 ms.
+        uint32_t safetyBudgetMs[4] = {20, 20, 15, 15};
+        task_set_criticality_budgets(task1.id, safetyBudgetMs);
+
+        // Health reports arrive in bursts; the server caps them at 5 ms per
+        // 100 ms, and each is submitted as taking at most 4 ms
+        g_reportServer = server_create("Reports", SERVER_CBS, 5, 100, DAL_C);
+        SafetyOutput *safetyState = (SafetyOutput *)task_alloc_state(task1.id, sizeof(SafetyOutput));
+        if (safetyState)
+        {
+            g_safetyOutput = safetyState;
+        }
+        else
+        {
+            task_set_output(task1.id, g_safetyOutput, sizeof(SafetyOutput));
+        }
+    }
 
-    task_create(&task1, "SafetyCritical", safety_critical_task, NULL, 100, 100, DAL_A);
-    task_create(&task2, "Control", control_task, NULL, 200, 180, DAL_B);
-    task_create(&task3, "Monitoring", monitoring_task, NULL, 500, 450, DAL_C);
-    task_create(&task4, "Background", background_task, NULL, 1000, 900, DAL_D);
+    // The table is checked against the task set, so only once it is complete
+    if (options.cyclicPath)
+    {
+        start_cyclic_executive(options.cyclicPath);
+    }
 
-    // Start system monitor thread
+    // Start kernel
+    kernel_start();
+    if (options.workloadPath)
+    {
+        workload_replay_start(&workload);
+    }
+
+    // Start system monitor thread (after the kernel, since it runs while the kernel is running)
     HANDLE monitorThread = CreateThread(NULL, 0, system_monitor_thread, NULL, 0, NULL);
     if (monitorThread == NULL)
     {
@@ -57,10 +203,84 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // Start kernel
-    kernel_start();
+    if (campaignMode)
+    {
+        // Headless: run the fault campaign, then shut down
+        exitCode = fault_campaign_run(campaign) == 0 ? 0 : 1;
+    }
+    else if (options.workloadPath)
+    {
+        // Headless: run until the last arrival of the workload
+        printf("\nReplaying workload for %u ms...\n\n", workload.durationMs);
+        Sleep(workload.durationMs);
+    }
+    else
+    {
+        run_interactive();
+    }
+
+    if (options.workloadPath)
+    {
+        WorkloadReplayStats replayStats;
+        workload_replay_stop(&replayStats);
+        printf("Workload replay: %u arrivals released, %u skipped, max release lag %llu us\n",
+               replayStats.released, replayStats.skipped, (unsigned long long)replayStats.maxLagUs);
+    }
+
+    // Stop kernel
+    kernel_stop();
+    sched_log_stop();
+
+    // Wait for monitor thread to terminate
+    WaitForSingleObject(monitorThread, INFINITE);
+    CloseHandle(monitorThread);
+
+    trace_stop();
+
+    // Print final statistics
+    print_jitter_statistics();
+
+    printf("\nRTOS simulation terminated.\n");
+    return exitCode;
+}
+
+// Replace the scheduling policy with a cyclic-executive table: the one
+// compiled in by the build if it fits the task set, otherwise one built for
+// the live tasks and written to path for review or a later build
+int start_cyclic_executive(const char *path)
+{
+#ifdef CYCLIC_BUILTIN_TABLE
+    extern const CyclicTable g_cyclicTable;
+    if (cyclic_enable(&g_cyclicTable) == 0)
+    {
+        return 0;
+    }
+#endif
+
+    CyclicTable table;
+    if (cyclic_build_live_table(&table) != 0)
+    {
+        printf("Continuing with the %s policy\n", scheduler_get_policy());
+        return -1;
+    }
+
+    int result = 0;
+    if (strcmp(path, "-") != 0 && cyclic_emit_source(&table, path, "g_cyclicTable") == 0)
+    {
+        printf("Cyclic table written to %s\n", path);
+    }
+    if (cyclic_enable(&table) != 0)
+    {
+        printf("Continuing with the %s policy\n", scheduler_get_policy());
+        result = -1;
+    }
+    cyclic_free_table(&table);
+    return result;
+}
 
-    // Main processing loop
+// Main processing loop for interactive runs
+void run_interactive(void)
+{
     printf("\nSystem running... Press Enter to inject a fault, q to quit\n\n");
     char input;
     while (1)
@@ -96,28 +316,158 @@ int main(int argc, char *argv[])
 
         Sleep(100); // Main loop interval
     }
+}
 
-    // Stop kernel
-    kernel_stop();
+// Command line: [--campaign <report> [--duration ms] [--rate n] [--types list] [--seed n] [--script file]]
+//               [--trace <file> [--trace-categories list]] [--record <file>] [--workload <file>]
+//               [--cyclic <file>|-] [--tickless 0|1]
+//               or --generate <file> with generator options; --duration and --seed are shared
+int parse_args(int argc, char *argv[], RunOptions *options)
+{
+    FaultCampaignConfig *config = &options->campaign;
+    WorkloadConfig *generator = &options->generator;
 
-    // Wait for monitor thread to terminate
-    WaitForSingleObject(monitorThread, INFINITE);
-    CloseHandle(monitorThread);
+    memset(options, 0, sizeof(RunOptions));
+    fault_campaign_defaults(config);
+    workload_defaults(generator);
+    options->traceCategories = TRACE_CAT_ALL;
+    options->tickless = -1;
 
-    // Print final statistics
-    print_jitter_statistics();
+    for (int i = 1; i < argc; i++)
+    {
+        const char *option = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value)
+        {
+            return -1;
+        }
+        i++;
 
-    printf("\nRTOS simulation terminated.\n");
-    return 0;
+        if (strcmp(option, "--campaign") == 0)
+        {
+            config->outputPath = value;
+        }
+        else if (strcmp(option, "--duration") == 0)
+        {
+            config->durationMs = (uint32_t)strtoul(value, NULL, 10);
+            generator->durationMs = config->durationMs;
+        }
+        else if (strcmp(option, "--rate") == 0)
+        {
+            config->faultsPerSecond = (uint32_t)strtoul(value, NULL, 10);
+            if (config->faultsPerSecond > FAULT_CAMPAIGN_MAX_RATE)
+            {
+                printf("Error: Fault rate above %u faults/s\n", FAULT_CAMPAIGN_MAX_RATE);
+                return -1;
+            }
+        }
+        else if (strcmp(option, "--types") == 0)
+        {
+            if (fault_campaign_parse_types(value, &config->typeMask) != 0)
+            {
+                return -1;
+            }
+        }
+        else if (strcmp(option, "--seed") == 0)
+        {
+            config->seed = (uint32_t)strtoul(value, NULL, 10);
+            generator->seed = config->seed;
+        }
+        else if (strcmp(option, "--script") == 0)
+        {
+            config->scriptPath = value;
+        }
+        else if (strcmp(option, "--trace") == 0)
+        {
+            options->tracePath = value;
+        }
+        else if (strcmp(option, "--trace-categories") == 0)
+        {
+            if (trace_parse_categories(value, &options->traceCategories) != 0)
+            {
+                return -1;
+            }
+        }
+        else if (strcmp(option, "--record") == 0)
+        {
+            options->recordPath = value;
+        }
+        else if (strcmp(option, "--workload") == 0)
+        {
+            options->workloadPath = value;
+        }
+        else if (strcmp(option, "--cyclic") == 0)
+        {
+            options->cyclicPath = value;
+        }
+        else if (strcmp(option, "--tickless") == 0)
+        {
+            options->tickless = atoi(value) != 0;
+        }
+        else if (strcmp(option, "--generate") == 0)
+        {
+            options->generatePath = value;
+        }
+        else if (strcmp(option, "--tasks") == 0)
+        {
+            generator->taskCount = (uint32_t)strtoul(value, NULL, 10);
+        }
+        else if (strcmp(option, "--utilization") == 0)
+        {
+            generator->utilization = (float)atof(value);
+        }
+        else if (strcmp(option, "--alpha") == 0)
+        {
+            generator->dirichletAlpha = (float)atof(value);
+        }
+        else if (strcmp(option, "--periods") == 0)
+        {
+            if (sscanf(value, "%u:%u", &generator->periodMinMs, &generator->periodMaxMs) != 2)
+            {
+                return -1;
+            }
+        }
+        else if (strcmp(option, "--deadline-ratio") == 0)
+        {
+            generator->deadlineMinRatio = (float)atof(value);
+        }
+        else if (strcmp(option, "--mix") == 0)
+        {
+            if (sscanf(value, "%u:%u:%u:%u", &generator->criticalityMix[DAL_A], &generator->criticalityMix[DAL_B],
+                       &generator->criticalityMix[DAL_C], &generator->criticalityMix[DAL_D]) != 4)
+            {
+                return -1;
+            }
+        }
+        else if (strcmp(option, "--sporadic") == 0)
+        {
+            generator->sporadicPercent = (uint32_t)strtoul(value, NULL, 10);
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    return options->generatePath && options->workloadPath ? -1 : 0;
 }
 
 // Example task implementations
 void safety_critical_task(void *args)
 {
+    // Under TMR each replica computes into its own copy of the output
+    SafetyOutput *output = (SafetyOutput *)tmr_replica_output(NULL);
+    if (!output)
+    {
+        output = g_safetyOutput;
+    }
+
     printf("[SAFETY] Task executing critical operations\n");
 
     // Simulate computation
     Sleep(10);
+    output->cycle++;
+    output->actuatorCommand = 0.5f * (float)(output->cycle % 100);
 
     // Occasionally miss deadline (for testing fault detection)
     if (rand() % 100 < 2)
@@ -160,6 +510,27 @@ void background_task(void *args)
 
     // Simulate background work
     Sleep(30 + (rand() % 20));
+
+    // Occasionally spin on the CPU; the budget aborts it at an abort point
+    if (rand() % 100 < 1)
+    {
+        printf("[BACKGROUND] Simulating runaway loop\n");
+        ULONGLONG until = GetTickCount64() + 500;
+        while (GetTickCount64() < until)
+        {
+            job_abort_point();
+        }
+    }
+}
+
+// Aperiodic job run by the report server
+void health_report_handler(void *args)
+{
+    SystemStateVector *state = kernel_get_system_state();
+    printf("[REPORT] Health report: CPU Load %.2f, Temp %.1f°C, %u active tasks\n",
+           state->cpuLoad, state->temperature, state->activeTaskCount);
+
+    Sleep(3);
 }
 
 // System monitoring thread
@@ -170,6 +541,9 @@ DWORD WINAPI system_monitor_thread(LPVOID lpParam)
         // Update ML model integrity periodically
         ml_model_integrity_check();
 
+        // Periodic lock contention report
+        memory_matrix_profile_tick();
+
         // Periodically check overall system health
         if (rand() % 10 == 0)
         {
@@ -178,11 +552,13 @@ DWORD WINAPI system_monitor_thread(LPVOID lpParam)
             {
                 printf("WARNING: High temperature detected (%.1f°C)\n", state->temperature);
                 state->state = DEGRADED_STATE;
+                server_submit(g_reportServer, health_report_handler, NULL, 4);
             }
             else if (state->cpuLoad > 0.85f)
             {
                 printf("WARNING: High CPU load detected (%.2f)\n", state->cpuLoad);
                 state->state = DEGRADED_STATE;
+                server_submit(g_reportServer, health_report_handler, NULL, 4);
             }
             else
             {
@@ -208,6 +584,7 @@ void print_system_state(void)
     printf("  Active Tasks: %u\n", state->activeTaskCount);
     printf("  System Mode: %s\n",
            state->state == NORMAL_STATE ? "NORMAL" : (state->state == RECOVERY_STATE ? "RECOVERY" : "DEGRADED"));
+    printf("  Criticality Mode: DAL_%c\n", 'A' + mc_get_mode());
     printf("  Scheduling Jitter: %u ns\n", scheduler_get_jitter_ns());
 }
 
@@ -215,29 +592,216 @@ void print_jitter_statistics(void)
 {
     printf("\nPerformance Statistics:\n");
     printf("  Worst-case scheduling jitter: %u ns\n", scheduler_get_jitter_ns());
+    printf("  Scheduler decisions: %llu (%s)\n", (unsigned long long)kernel_get_tick_count(),
+           kernel_is_tickless() ? "tickless" : "ticked");
+
+    for (int i = 0; i < sched_policy_count(); i++)
+    {
+        SchedPolicyStats policyStats;
+        const char *policy = sched_policy_at(i)->name;
+        if (sched_policy_get_stats(policy, &policyStats) == 0 && policyStats.decisions > 0)
+        {
+            printf("  %s decisions: %llu, avg %llu ns, max %llu ns\n", policy,
+                   (unsigned long long)policyStats.decisions,
+                   (unsigned long long)(policyStats.decideNs / policyStats.decisions),
+                   (unsigned long long)policyStats.maxDecideNs);
+        }
+    }
+
+    // Bounded blocking on shared regions is what makes the jitter figure meaningful
+    for (int i = 0; i < SHM_COUNT; i++)
+    {
+        MemoryLockStats lockStats;
+        if (memory_matrix_get_lock_stats((SharedMemoryRegion)i, &lockStats) == 0 && lockStats.blockedAcquisitions > 0)
+        {
+            printf("  Region %d blocking: %llu of %llu acquisitions, max %llu ns, %u priority boosts\n",
+                   i,
+                   (unsigned long long)lockStats.blockedAcquisitions,
+                   (unsigned long long)lockStats.acquisitions,
+                   (unsigned long long)lockStats.maxBlockingNs,
+                   lockStats.priorityBoosts);
+        }
+    }
+
+    TmrExecutorStats tmrStats;
+    tmr_executor_get_stats(&tmrStats);
+    if (tmrStats.executions > 0)
+    {
+        printf("  TMR executions: %llu (%llu early, %llu full votes, %llu deadline misses), outvoted %llu/%llu/%llu\n",
+               (unsigned long long)tmrStats.executions,
+               (unsigned long long)tmrStats.earlyCommits,
+               (unsigned long long)tmrStats.fullVotes,
+               (unsigned long long)tmrStats.deadlineMisses,
+               (unsigned long long)tmrStats.disagreements[0],
+               (unsigned long long)tmrStats.disagreements[1],
+               (unsigned long long)tmrStats.disagreements[2]);
+    }
+
+    CheckpointStats checkpointStats;
+    checkpoint_get_totals(&checkpointStats);
+    printf("  Checkpoints: %llu taken, %llu pages copied, %llu rejected, %llu rollbacks restoring %llu pages\n",
+           (unsigned long long)checkpointStats.checkpoints,
+           (unsigned long long)checkpointStats.pagesCopied,
+           (unsigned long long)checkpointStats.rejected,
+           (unsigned long long)checkpointStats.rollbacks,
+           (unsigned long long)checkpointStats.pagesRestored);
+
+    JobExecutorStats jobStats;
+    job_executor_get_stats(&jobStats);
+    printf("  Job budgets: %llu jobs, %llu overruns (%llu demoted, %llu aborted, %llu workers detached, %llu detaches refused), max overrun %llu us\n",
+           (unsigned long long)jobStats.jobs,
+           (unsigned long long)jobStats.overruns,
+           (unsigned long long)jobStats.demotions,
+           (unsigned long long)jobStats.aborts,
+           (unsigned long long)jobStats.detachedWorkers,
+           (unsigned long long)jobStats.detachRefusals,
+           (unsigned long long)jobStats.maxOverrunUs);
+
+    SchedAnalysisStats analysisStats;
+    sched_analysis_get_stats(&analysisStats);
+    printf("  Admission: %u tasks admitted (utilization %.3f), %u rejected, %u degraded\n",
+           analysisStats.admitted, analysisStats.utilization, analysisStats.rejected, analysisStats.degraded);
+    if (analysisStats.fixedPriority && analysisStats.admitted > 0)
+    {
+        printf("  Response-time analysis: worst slack %u us\n", analysisStats.worstSlackUs);
+    }
+
+    // Per-job deadline accounting: late finishes, abandoned jobs and
+    // releases skipped in a backlog all count as misses; overdue releases
+    // are still waiting past their deadline
+    JobTimingStats jobTiming;
+    int slotCount = kernel_get_task_slot_count();
+    int overdueTotal = 0;
+    for (int i = 0; i < slotCount; i++)
+    {
+        Task snapshot;
+        int overdue = kernel_read_task_slot(i, &snapshot) == 0 ? kernel_get_overdue_releases(snapshot.id) : -1;
+        overdueTotal += overdue > 0 ? overdue : 0;
+    }
+    job_stats_get_totals(&jobTiming);
+    printf("  Deadlines: %llu jobs, %llu met, %llu missed (%llu late, %llu abandoned, %llu skipped), %d overdue\n",
+           (unsigned long long)jobTiming.jobs,
+           (unsigned long long)jobTiming.hits,
+           (unsigned long long)jobTiming.misses,
+           (unsigned long long)(jobTiming.misses - jobTiming.abandoned - jobTiming.skipped),
+           (unsigned long long)jobTiming.abandoned,
+           (unsigned long long)jobTiming.skipped,
+           overdueTotal);
+    for (int i = 0; i < slotCount; i++)
+    {
+        Task snapshot;
+        if (kernel_read_task_slot(i, &snapshot) != 0 || job_stats_get(snapshot.id, &jobTiming) != 0)
+        {
+            continue;
+        }
+
+        int overdue = kernel_get_overdue_releases(snapshot.id);
+        if (jobTiming.jobs == 0 && jobTiming.skipped == 0)
+        {
+            if (overdue > 0)
+            {
+                printf("    %-16s no jobs run, %d overdue\n", snapshot.name, overdue);
+            }
+            continue;
+        }
+
+        uint64_t completed = jobTiming.completed;
+        uint64_t late = jobTiming.misses - jobTiming.abandoned - jobTiming.skipped;
+        printf("    %-16s %llu jobs, %llu missed, %d overdue; start avg %llu p99 <%llu max %llu; "
+               "response p50 <%llu p99 <%llu max %llu; lateness max %lld, tardiness p99 <%llu us\n",
+               snapshot.name,
+               (unsigned long long)jobTiming.jobs,
+               (unsigned long long)jobTiming.misses,
+               overdue > 0 ? overdue : 0,
+               (unsigned long long)(jobTiming.jobs ? jobTiming.latencySumUs / jobTiming.jobs : 0),
+               (unsigned long long)job_stats_percentile(jobTiming.latencyHistogram, jobTiming.jobs, 99.0),
+               (unsigned long long)jobTiming.latencyMaxUs,
+               (unsigned long long)job_stats_percentile(jobTiming.responseHistogram, completed, 50.0),
+               (unsigned long long)job_stats_percentile(jobTiming.responseHistogram, completed, 99.0),
+               (unsigned long long)jobTiming.responseMaxUs,
+               (long long)jobTiming.latenessMaxUs,
+               (unsigned long long)job_stats_percentile(jobTiming.tardinessHistogram, late, 99.0));
+    }
+
+    for (int i = 0; i < server_count(); i++)
+    {
+        ServerStats serverStats;
+        if (server_get_stats(i, &serverStats) == 0)
+        {
+            printf("  Server %s (%s, %u/%u us): %llu jobs, %u queued, %llu rejected, %llu exhaustions, "
+                   "response avg %llu max %llu us\n",
+                   serverStats.name,
+                   serverStats.kind == SERVER_CBS ? "CBS" : "sporadic",
+                   serverStats.budgetUs,
+                   serverStats.periodUs,
+                   (unsigned long long)serverStats.jobs,
+                   serverStats.queued,
+                   (unsigned long long)serverStats.rejected,
+                   (unsigned long long)serverStats.exhaustions,
+                   (unsigned long long)(serverStats.jobs ? serverStats.responseSumUs / serverStats.jobs : 0),
+                   (unsigned long long)serverStats.responseMaxUs);
+        }
+    }
+
+    McStats mcStats;
+    mc_get_stats(&mcStats);
+    printf("  Mixed criticality: DAL_%c mode, %u raises, %u restores, %u tasks shed, %llu jobs dropped, "
+           "%llu throttled, %llu us raised\n",
+           'A' + mcStats.mode,
+           mcStats.modeSwitches,
+           mcStats.restores,
+           mcStats.shedTasks,
+           (unsigned long long)mcStats.droppedJobs,
+           (unsigned long long)mcStats.throttledJobs,
+           (unsigned long long)mcStats.raisedUs);
+
+    CyclicStats cyclicStats;
+    cyclic_get_stats(&cyclicStats);
+    if (cyclicStats.length > 0 || cyclicStats.fallbacks > 0)
+    {
+        printf("  Cyclic executive: %s, %u entries of %u us, %llu dispatches, %llu idle frames, %llu skipped, "
+               "%u fallbacks\n",
+               cyclicStats.enabled ? "on" : "off",
+               cyclicStats.length,
+               cyclicStats.quantumUs,
+               (unsigned long long)cyclicStats.dispatches,
+               (unsigned long long)cyclicStats.idleFrames,
+               (unsigned long long)cyclicStats.skippedFrames,
+               cyclicStats.fallbacks);
+    }
+
+    ScrubberStats scrubStats;
+    scrubber_get_stats(&scrubStats);
+    printf("  Scrubber: %u blocks protected, %llu verified, %llu failures, %llu cycles (last %llu us, max %llu us)\n",
+           scrubStats.protectedBlocks,
+           (unsigned long long)scrubStats.blocksVerified,
+           (unsigned long long)scrubStats.failures,
+           (unsigned long long)scrubStats.cycles,
+           (unsigned long long)scrubStats.lastCycleUs,
+           (unsigned long long)scrubStats.maxCycleUs);
+
+    fault_latency_dump();
+    memory_matrix_profile_dump();
     // In a real system, we would have more statistics here
 }
 
 void inject_random_faults(void)
 {
     // Get task count
-    int count;
-    Task *tasks = kernel_get_tasks(&count);
+    int count = kernel_get_task_slot_count();
 
     if (count == 0)
         return;
 
-    // Select random task and fault type
-    uint32_t taskId = rand() % count;
+    // Select random live task and fault type
+    Task snapshot;
+    Task *task = &snapshot;
+    if (kernel_read_task_slot(rand() % count, &snapshot) != 0)
+        return;
     FaultType faultType = (FaultType)((rand() % 5) + 1); // 1-5 (skipping NO_FAULT)
 
     // Inject fault
-    printf("\nInjecting %s fault into task '%s'...\n",
-           faultType == TIMING_FAULT ? "TIMING" : faultType == MEMORY_FAULT      ? "MEMORY"
-                                              : faultType == COMPUTATION_FAULT   ? "COMPUTATION"
-                                              : faultType == COMMUNICATION_FAULT ? "COMMUNICATION"
-                                                                                 : "POWER",
-           tasks[taskId].name);
-
-    fault_inject(faultType, taskId, 0x1000 + (rand() % 0x1000));
+    printf("\nInjecting %s fault into task '%s'...\n", fault_type_name(faultType), task->name);
+
+    fault_inject(faultType, task->id, 0x1000 + (rand() % 0x1000));
 }
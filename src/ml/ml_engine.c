@@ -1,6 +1,7 @@
 #include "../../include/ml_engine.h"
 #include "../../include/system_config.h"
 #include "../../include/fault_tolerance.h"
+#include "../../include/scrubber.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -26,6 +27,10 @@ static float g_fuzzyMembershipMatrix[FUZZY_LEVELS][FUZZY_LEVELS] = {
 
 static int g_modelLoaded = 0;
 
+// Scrubber areas guarding the coefficients, which never change after loading
+static int g_weightsScrubArea = -1;
+static int g_fuzzyScrubArea = -1;
+
 // Forward declarations of helper functions
 static void extract_features(Task *task, SystemStateVector *sysState, TaskFeatureVector *featureVector);
 static float xgboost_inference(TaskFeatureVector *features);
@@ -39,6 +44,13 @@ void ml_engine_init(void)
     // Simulate loading a pre-trained model
     g_modelLoaded = 1;
     printf("ML model loaded successfully\n");
+
+#if SCRUB_ENABLED
+    g_weightsScrubArea = scrubber_protect("ml_weights", g_featureWeights, sizeof(g_featureWeights),
+                                          TASK_INVALID_ID, 0, NULL, NULL, NULL);
+    g_fuzzyScrubArea = scrubber_protect("ml_fuzzy", g_fuzzyMembershipMatrix, sizeof(g_fuzzyMembershipMatrix),
+                                        TASK_INVALID_ID, 0, NULL, NULL, NULL);
+#endif
 }
 
 float ml_predict_urgency(Task *task, SystemStateVector *sysState)
@@ -105,6 +117,13 @@ void ml_update_task_history(Task *task)
 }
 
 float compute_dynamic_priority(Task *task, SystemStateVector *sysState)
+{
+    return ml_dynamic_priority(task, sysState, get_fault_recovery_factor(task->id));
+}
+
+// compute_dynamic_priority with the fault recovery factor supplied, for
+// task sets that are not the kernel's (policy replay)
+float ml_dynamic_priority(Task *task, SystemStateVector *sysState, float faultFactor)
 {
     // Base priority score from task configuration
     float basePriority = (float)task->basePriority / (float)MAX_PRIORITY_LEVELS;
@@ -112,9 +131,6 @@ float compute_dynamic_priority(Task *task, SystemStateVector *sysState)
     // ML-based urgency prediction
     float mlUrgency = ml_predict_urgency(task, sysState);
 
-    // Get fault recovery factor
-    float faultFactor = get_fault_recovery_factor(task->id);
-
     // Energy penalty based on system state
     float energyPenalty = 0.0f;
     if (sysState->powerConsumption > 4.0f)
@@ -143,7 +159,15 @@ float compute_dynamic_priority(Task *task, SystemStateVector *sysState)
 
 void ml_model_integrity_check(void)
 {
-    // Simulate model integrity check to prevent tampering
+#if SCRUB_ENABLED
+    // Full pass over the coefficient checksums; mismatches are raised as memory faults
+    int badBlocks = scrubber_verify(g_weightsScrubArea) + scrubber_verify(g_fuzzyScrubArea);
+    if (badBlocks != 0)
+    {
+        printf("ML model integrity check failed: %d corrupted blocks\n", badBlocks);
+        return;
+    }
+#endif
     printf("ML model integrity verified\n");
 }
 
@@ -190,7 +214,9 @@ static void extract_features(Task *task, SystemStateVector *sysState, TaskFeatur
     featureVector->features[11] = sysState->memoryUsage;
     featureVector->features[12] = sysState->temperature / 100.0f;    // Normalize
     featureVector->features[13] = sysState->powerConsumption / 5.0f; // Normalize
-    featureVector->features[14] = (float)sysState->activeTaskCount / MAX_TASKS;
+    // Normalize to the nominal table size; the table grows past it, but the model expects at most 1
+    float taskLoad = (float)sysState->activeTaskCount / TASK_TABLE_INITIAL_CAPACITY;
+    featureVector->features[14] = taskLoad < 1.0f ? taskLoad : 1.0f;
     featureVector->features[15] = (float)sysState->state;
 
     // The remaining features would be more complex in a real system
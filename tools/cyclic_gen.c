@@ -0,0 +1,86 @@
+// Offline cyclic-table generator: builds the cyclic-executive dispatch table
+// for a workload file's tasks and writes it as C source, to be compiled into
+// ml_rtos (see CYCLIC_TABLE_WORKLOAD in CMakeLists.txt) or reviewed.
+//
+// Tasks get the execution time workload_apply gives them, the WCET rounded
+// up to whole milliseconds, so the table matches the tasks ml_rtos creates
+// from the same file. Sporadic tasks get slots at their minimum
+// inter-arrival time; a slot with no job pending stays idle.
+//
+// Usage: cyclic_gen <workload.txt> <table.c> [--symbol <name>] [--quantum-us <us>]
+// The default symbol is g_cyclicTable and the default quantum the
+// scheduler's dispatch period.
+
+#include "../include/system_config.h"
+#include "../include/workload.h"
+#include "../include/cyclic_schedule.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char *argv[])
+{
+    const char *symbol = "g_cyclicTable";
+    uint32_t quantumUs = SCHEDULER_PERIOD_MS * 1000;
+
+    if (argc < 3 || argc % 2 != 1)
+    {
+        printf("Usage: %s <workload.txt> <table.c> [--symbol <name>] [--quantum-us <us>]\n", argv[0]);
+        return 1;
+    }
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--symbol") == 0)
+        {
+            symbol = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--quantum-us") == 0)
+        {
+            quantumUs = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+        }
+        else
+        {
+            printf("Error: Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    WorkloadSet workload;
+    if (workload_load(argv[1], &workload) != 0)
+    {
+        return 1;
+    }
+
+    CyclicTableTask *tasks = (CyclicTableTask *)calloc(workload.taskCount ? workload.taskCount : 1,
+                                                       sizeof(CyclicTableTask));
+    if (!tasks)
+    {
+        workload_free(&workload);
+        return 1;
+    }
+    for (uint32_t i = 0; i < workload.taskCount; i++)
+    {
+        memcpy(tasks[i].name, workload.tasks[i].name, sizeof(tasks[i].name));
+        tasks[i].periodMs = workload.tasks[i].periodMs;
+        tasks[i].deadlineMs = workload.tasks[i].deadlineMs;
+        tasks[i].executionTimeMs = (workload.tasks[i].wcetUs + 999) / 1000;
+    }
+
+    CyclicTable table;
+    int result = cyclic_build_table(tasks, workload.taskCount, quantumUs, &table);
+    if (result == 0)
+    {
+        result = cyclic_emit_source(&table, argv[2], symbol);
+        if (result == 0)
+        {
+            printf("%u tasks, %u entries of %u us written to %s as %s\n", table.taskCount, table.length,
+                   table.quantumUs, argv[2], symbol);
+        }
+        cyclic_free_table(&table);
+    }
+
+    free(tasks);
+    workload_free(&workload);
+    return result == 0 ? 0 : 1;
+}
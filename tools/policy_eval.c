@@ -0,0 +1,712 @@
+// Offline policy evaluator: replays a scheduler input log written by
+// sched_log_start (ml_rtos --record) against every scheduling policy at
+// once, one replay thread per core, and reports deadline misses, tardiness
+// and decision cost per policy.
+//
+// The replay is a discrete-event simulation of one non-preemptive processor,
+// as the scheduler thread runs jobs: at each decision point the policy sees
+// the tasks with a released job pending, the same gate the kernel applies.
+// Each job runs for the CPU time the live run measured for it, or the
+// task's declared execution time.
+//
+// Two things the live dispatcher does are not in the log, so the replay
+// leaves them out: reservation servers, which run on queued work rather
+// than releases, never run here, and tasks the mixed-criticality mode shed
+// stay eligible. The report says so.
+//
+// Usage: policy_eval <sched.log> [--policies RMS,EDF,...] [--output <report.json>]
+// Without --policies every registered policy is replayed.
+
+#include "../include/system_config.h"
+#include "../include/task_manager.h"
+#include "../include/task_table.h"
+#include "../include/scheduler.h"
+#include "../include/sched_log.h"
+#include "../include/sched_policy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#define EVAL_MAX_POLICIES SCHED_POLICY_MAX
+#define EVAL_JOB_QUEUE_INITIAL 4
+#define EVAL_MODEL_NOTE "released jobs only; reservation servers and criticality shedding not replayed"
+
+// External functions
+extern void kernel_init(void);
+
+// Released jobs of one task, oldest first
+typedef struct
+{
+    uint64_t releaseUs;
+    uint64_t deadlineUs;
+    uint32_t demandUs;
+} EvalJob;
+
+typedef struct
+{
+    EvalJob *jobs; // Ring buffer
+    uint32_t head;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t faultCount; // Recoveries so far, for the ML fault factor
+    uint8_t present;
+    uint8_t enabled; // Active in the live task table
+} EvalTask;
+
+typedef struct
+{
+    uint64_t jobs;   // Completed
+    uint64_t judged; // Completed, or past their deadline when the log ends
+    uint64_t misses;
+    uint64_t unfinished; // Pending at the end of the log with the deadline still ahead
+    uint64_t tardinessUs;
+    uint64_t maxTardinessUs;
+    uint64_t responseUs;
+    uint64_t jobsByLevel[4];
+    uint64_t missesByLevel[4];
+    uint64_t decisions;
+    uint64_t decideNs;
+    uint64_t maxDecideNs;
+} EvalResult;
+
+// One policy's replay; each runs on its own thread with a private task table
+typedef struct
+{
+    const char *policy;
+    SchedPolicyInstance instance; // Private policy state, as the kernel's own
+    TaskHotTable *hot;
+    Task *chunks[TASK_TABLE_MAX_CHUNKS];
+    EvalTask *tasks;
+    SystemStateVector state;
+    int eligible; // Tasks with a job pending
+    int runningSlot;
+    EvalJob running;
+    uint64_t busyUntilUs;
+    EvalResult result;
+} EvalRun;
+
+static SchedLogRecord *g_records = NULL;
+static uint32_t *g_demandUs = NULL; // Per release record
+static size_t g_recordCount = 0;
+static int g_slotCount = 0;
+static double g_nsPerCount = 1.0;
+
+static uint64_t eval_now_ns(void)
+{
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * g_nsPerCount);
+}
+
+static int eval_load(const char *path)
+{
+    FILE *in = fopen(path, "rb");
+    if (!in)
+    {
+        printf("Error: Cannot open %s\n", path);
+        return -1;
+    }
+
+    SchedLogHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1 || memcmp(header.magic, SCHED_LOG_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SCHED_LOG_VERSION || header.recordSize != sizeof(SchedLogRecord))
+    {
+        printf("Error: %s is not a version %d scheduler log\n", path, SCHED_LOG_VERSION);
+        fclose(in);
+        return -1;
+    }
+
+    fseek(in, 0, SEEK_END);
+    long bytes = ftell(in) - (long)sizeof(header);
+    fseek(in, (long)sizeof(header), SEEK_SET);
+    g_recordCount = bytes > 0 ? (size_t)bytes / sizeof(SchedLogRecord) : 0;
+    g_records = (SchedLogRecord *)malloc(g_recordCount ? g_recordCount * sizeof(SchedLogRecord) : 1);
+    if (!g_records || fread(g_records, sizeof(SchedLogRecord), g_recordCount, in) != g_recordCount)
+    {
+        printf("Error: Failed to read %zu records from %s\n", g_recordCount, path);
+        fclose(in);
+        return -1;
+    }
+    fclose(in);
+
+    if (g_recordCount == 0)
+    {
+        printf("Error: %s holds no records\n", path);
+        return -1;
+    }
+
+    for (size_t i = 0; i < g_recordCount; i++)
+    {
+        int slot = (int)TASK_HANDLE_SLOT(g_records[i].taskId);
+        if (g_records[i].type != SCHED_LOG_STATE && slot + 1 > g_slotCount)
+        {
+            g_slotCount = slot + 1;
+        }
+    }
+    return 0;
+}
+
+// A released job needs the CPU time of the first job the live run executed
+// for the task at or after the release; failing that, the declared time
+typedef struct
+{
+    uint32_t taskId;
+    uint32_t value;
+} EvalSlotValue;
+
+static int eval_assign_demands(void)
+{
+    EvalSlotValue *next = (EvalSlotValue *)calloc(g_slotCount ? g_slotCount : 1, sizeof(EvalSlotValue));
+    EvalSlotValue *declared = (EvalSlotValue *)calloc(g_slotCount ? g_slotCount : 1, sizeof(EvalSlotValue));
+    g_demandUs = (uint32_t *)calloc(g_recordCount, sizeof(uint32_t));
+    if (!next || !declared || !g_demandUs)
+    {
+        free(next);
+        free(declared);
+        return -1;
+    }
+
+    for (size_t i = g_recordCount; i-- > 0;)
+    {
+        const SchedLogRecord *record = &g_records[i];
+        if (record->type == SCHED_LOG_STATE)
+        {
+            continue;
+        }
+
+        EvalSlotValue *entry = &next[TASK_HANDLE_SLOT(record->taskId)];
+        if (record->type == SCHED_LOG_JOB)
+        {
+            entry->taskId = record->taskId;
+            entry->value = record->args[0];
+        }
+        else if (record->type == SCHED_LOG_RELEASE && entry->taskId == record->taskId)
+        {
+            g_demandUs[i] = entry->value;
+        }
+    }
+
+    for (size_t i = 0; i < g_recordCount; i++)
+    {
+        const SchedLogRecord *record = &g_records[i];
+        if (record->type == SCHED_LOG_STATE)
+        {
+            continue;
+        }
+
+        EvalSlotValue *entry = &declared[TASK_HANDLE_SLOT(record->taskId)];
+        if (record->type == SCHED_LOG_TASK)
+        {
+            entry->taskId = record->taskId;
+            entry->value = record->args[2] * 1000;
+        }
+        else if (record->type == SCHED_LOG_RELEASE && g_demandUs[i] == 0)
+        {
+            g_demandUs[i] = entry->taskId == record->taskId && entry->value ? entry->value : 1;
+        }
+    }
+
+    free(next);
+    free(declared);
+    return 0;
+}
+
+// Cold descriptors and fault history for the policy, from the replay's own table
+static int eval_view_read(void *context, int slot, Task *snapshot)
+{
+    EvalRun *run = (EvalRun *)context;
+    if (!run->tasks[slot].present)
+    {
+        return -1;
+    }
+
+    *snapshot = *task_table_cold(run->hot, slot);
+    return 0;
+}
+
+static float eval_view_fault_factor(void *context, uint32_t taskId)
+{
+    // Same backoff as get_fault_recovery_factor
+    EvalRun *run = (EvalRun *)context;
+    float factor = 1.0f + (float)run->tasks[TASK_HANDLE_SLOT(taskId)].faultCount * 0.2f;
+    return factor > 2.0f ? 2.0f : factor;
+}
+
+static void eval_update_eligible(EvalRun *run, int slot)
+{
+    EvalTask *task = &run->tasks[slot];
+    uint8_t eligible = task->present && task->enabled && task->count > 0;
+    if (eligible != run->hot->active[slot])
+    {
+        run->eligible += eligible ? 1 : -1;
+        run->hot->active[slot] = eligible;
+    }
+}
+
+static void eval_drop_jobs(EvalTask *task)
+{
+    task->head = 0;
+    task->count = 0;
+    task->faultCount = 0;
+}
+
+static int eval_push_job(EvalTask *task, const EvalJob *job)
+{
+    if (task->count == task->capacity)
+    {
+        uint32_t capacity = task->capacity ? task->capacity * 2 : EVAL_JOB_QUEUE_INITIAL;
+        EvalJob *jobs = (EvalJob *)malloc(capacity * sizeof(EvalJob));
+        if (!jobs)
+        {
+            return -1;
+        }
+        for (uint32_t i = 0; i < task->count; i++)
+        {
+            jobs[i] = task->jobs[(task->head + i) % task->capacity];
+        }
+        free(task->jobs);
+        task->jobs = jobs;
+        task->head = 0;
+        task->capacity = capacity;
+    }
+
+    task->jobs[(task->head + task->count) % task->capacity] = *job;
+    task->count++;
+    return 0;
+}
+
+static void eval_account(EvalRun *run, int slot, const EvalJob *job, uint64_t finishUs)
+{
+    Task *cold = task_table_cold(run->hot, slot);
+    int level = cold->criticality <= DAL_D ? cold->criticality : DAL_D;
+
+    run->result.jobs++;
+    run->result.judged++;
+    run->result.jobsByLevel[level]++;
+    run->result.responseUs += finishUs - job->releaseUs;
+    sched_policy_complete(&run->instance, cold->id, finishUs, finishUs > job->deadlineUs);
+    if (finishUs > job->deadlineUs)
+    {
+        uint64_t tardinessUs = finishUs - job->deadlineUs;
+        run->result.misses++;
+        run->result.missesByLevel[level]++;
+        run->result.tardinessUs += tardinessUs;
+        if (tardinessUs > run->result.maxTardinessUs)
+        {
+            run->result.maxTardinessUs = tardinessUs;
+        }
+        cold->missedDeadlines++;
+    }
+
+    // What record_execution_time feeds the ML history
+    cold->lastExecutionTime = job->demandUs / 1000;
+}
+
+// Pick and start the next job if the processor is idle
+static void eval_decide(EvalRun *run, uint64_t nowUs)
+{
+    static const SchedulerTaskView viewTemplate = {eval_view_read, eval_view_fault_factor, NULL};
+    SchedulerTaskView view = viewTemplate;
+    view.context = run;
+
+    if (run->runningSlot >= 0 || run->eligible == 0)
+    {
+        return;
+    }
+
+    uint64_t start = eval_now_ns();
+    ScheduleDecision decision = sched_policy_pick(&run->instance, run->hot, &run->state, &view);
+    uint64_t elapsed = eval_now_ns() - start;
+    run->result.decisions++;
+    run->result.decideNs += elapsed;
+    if (elapsed > run->result.maxDecideNs)
+    {
+        run->result.maxDecideNs = elapsed;
+    }
+
+    if (decision.taskId == TASK_INVALID_ID)
+    {
+        return;
+    }
+
+    int slot = (int)TASK_HANDLE_SLOT(decision.taskId);
+    EvalTask *task = &run->tasks[slot];
+    run->running = task->jobs[task->head];
+    task->head = (task->head + 1) % task->capacity;
+    task->count--;
+    eval_update_eligible(run, slot);
+
+    // As update_task_metrics does when the scheduler picks a task
+    Task *cold = task_table_cold(run->hot, slot);
+    for (int i = 9; i > 0; i--)
+    {
+        cold->executionHistory[i] = cold->executionHistory[i - 1];
+    }
+    cold->executionHistory[0] = (float)cold->lastExecutionTime;
+
+    run->runningSlot = slot;
+    run->busyUntilUs = nowUs + run->running.demandUs;
+}
+
+static void eval_apply(EvalRun *run, size_t index)
+{
+    const SchedLogRecord *record = &g_records[index];
+    if (record->type == SCHED_LOG_STATE)
+    {
+        run->state.cpuLoad = record->values[0];
+        run->state.memoryUsage = record->values[1];
+        run->state.temperature = record->values[2];
+        run->state.powerConsumption = record->values[3];
+        run->state.activeTaskCount = record->taskId;
+        run->state.state = (SystemState)record->flags;
+        return;
+    }
+
+    int slot = (int)TASK_HANDLE_SLOT(record->taskId);
+    EvalTask *task = &run->tasks[slot];
+    Task *cold = task_table_cold(run->hot, slot);
+    int current = task->present && cold->id == record->taskId;
+    uint8_t eligible;
+
+    switch (record->type)
+    {
+    case SCHED_LOG_TASK:
+        if (!current)
+        {
+            // New task, or a recycled slot: start from task_create's state
+            eval_drop_jobs(task);
+            memset(cold, 0, sizeof(Task));
+            cold->id = record->taskId;
+            for (int i = 0; i < 10; i++)
+            {
+                cold->executionHistory[i] = (float)record->args[2];
+            }
+            run->hot->generation[slot] = (uint16_t)TASK_HANDLE_GENERATION(record->taskId);
+        }
+        cold->periodMs = record->args[0];
+        cold->deadlineMs = record->args[1];
+        cold->executionTimeMs = record->args[2];
+        cold->basePriority = record->args[3];
+        cold->dynamicPriority = record->args[3];
+        cold->criticality = (CriticalityLevel)record->criticality;
+        cold->active = (record->flags & SCHED_LOG_FLAG_ACTIVE) != 0;
+        cold->sporadic = (record->flags & SCHED_LOG_FLAG_SPORADIC) != 0;
+        eligible = run->hot->active[slot];
+        task_table_store(run->hot, slot, cold);
+        run->hot->active[slot] = eligible; // Eligibility is the replay's, recomputed below
+        task->present = 1;
+        task->enabled = cold->active;
+        break;
+
+    case SCHED_LOG_REMOVE:
+        if (current)
+        {
+            task->present = 0;
+            eval_drop_jobs(task);
+        }
+        break;
+
+    case SCHED_LOG_RELEASE:
+        if (current)
+        {
+            EvalJob job;
+            job.releaseUs = record->timeUs;
+            job.deadlineUs = record->timeUs + (uint64_t)cold->deadlineMs * 1000;
+            job.demandUs = g_demandUs[index];
+            if (eval_push_job(task, &job) != 0)
+            {
+                // Out of memory; the job is lost and counted against the policy
+                run->result.judged++;
+                run->result.misses++;
+            }
+            else
+            {
+                sched_policy_release(&run->instance, cold->id, record->timeUs);
+            }
+        }
+        break;
+
+    case SCHED_LOG_FAULT:
+        if (current)
+        {
+            task->faultCount++;
+        }
+        return;
+
+    default:
+        return;
+    }
+
+    eval_update_eligible(run, slot);
+}
+
+// Jobs still pending when the log ends: late ones are misses (tardiness is
+// a lower bound), the rest unfinished
+static void eval_settle(EvalRun *run, int slot, const EvalJob *job, uint64_t endUs)
+{
+    if (job->deadlineUs < endUs)
+    {
+        Task *cold = task_table_cold(run->hot, slot);
+        int level = cold->criticality <= DAL_D ? cold->criticality : DAL_D;
+        run->result.judged++;
+        run->result.misses++;
+        run->result.missesByLevel[level]++;
+        run->result.tardinessUs += endUs - job->deadlineUs;
+        if (endUs - job->deadlineUs > run->result.maxTardinessUs)
+        {
+            run->result.maxTardinessUs = endUs - job->deadlineUs;
+        }
+    }
+    else
+    {
+        run->result.unfinished++;
+    }
+}
+
+static DWORD WINAPI eval_thread_func(LPVOID lpParam)
+{
+    EvalRun *run = (EvalRun *)lpParam;
+    uint64_t endUs = g_records[g_recordCount - 1].timeUs;
+    size_t i = 0;
+
+    while (i < g_recordCount)
+    {
+        if (run->runningSlot >= 0 && run->busyUntilUs <= g_records[i].timeUs)
+        {
+            int slot = run->runningSlot;
+            run->runningSlot = -1;
+            eval_account(run, slot, &run->running, run->busyUntilUs);
+            eval_decide(run, run->busyUntilUs);
+            continue;
+        }
+
+        eval_apply(run, i);
+        eval_decide(run, g_records[i].timeUs);
+        i++;
+    }
+
+    if (run->runningSlot >= 0)
+    {
+        eval_settle(run, run->runningSlot, &run->running, endUs);
+    }
+    for (int slot = 0; slot < g_slotCount; slot++)
+    {
+        EvalTask *task = &run->tasks[slot];
+        for (uint32_t j = 0; task->present && j < task->count; j++)
+        {
+            eval_settle(run, slot, &task->jobs[(task->head + j) % task->capacity], endUs);
+        }
+    }
+    return 0;
+}
+
+static int eval_run_init(EvalRun *run, const SchedPolicy *policy)
+{
+    memset(run, 0, sizeof(EvalRun));
+    run->policy = policy->name;
+    run->runningSlot = -1;
+    if (sched_policy_instance_init(&run->instance, policy) != 0)
+    {
+        return -1;
+    }
+
+    int chunks = (g_slotCount + TASK_TABLE_CHUNK_SIZE - 1) / TASK_TABLE_CHUNK_SIZE;
+    for (int c = 0; c < chunks; c++)
+    {
+        run->chunks[c] = (Task *)calloc(TASK_TABLE_CHUNK_SIZE, sizeof(Task));
+        if (!run->chunks[c])
+        {
+            return -1;
+        }
+    }
+
+    run->tasks = (EvalTask *)calloc(g_slotCount, sizeof(EvalTask));
+    run->hot = task_table_create(chunks * TASK_TABLE_CHUNK_SIZE, run->chunks);
+    if (!run->tasks || !run->hot)
+    {
+        return -1;
+    }
+    run->hot->count = g_slotCount;
+    return 0;
+}
+
+static void eval_run_free(EvalRun *run)
+{
+    for (int slot = 0; run->tasks && slot < g_slotCount; slot++)
+    {
+        free(run->tasks[slot].jobs);
+    }
+    free(run->tasks);
+    sched_policy_instance_destroy(&run->instance);
+    task_table_destroy(run->hot);
+    for (int c = 0; c < TASK_TABLE_MAX_CHUNKS; c++)
+    {
+        free(run->chunks[c]);
+    }
+}
+
+static void eval_report(const EvalRun *runs, int count, const char *outputPath)
+{
+    printf("\n%-10s %9s %9s %7s %12s %12s %12s %10s %10s %10s\n", "Policy", "Jobs", "Misses", "Miss%",
+           "Tardy avg", "Tardy max", "Resp avg", "Decisions", "Decide avg", "Decide max");
+    printf("%-10s %9s %9s %7s %12s %12s %12s %10s %10s %10s\n", "", "", "", "", "us", "us", "us", "", "ns", "ns");
+    for (int p = 0; p < count; p++)
+    {
+        const EvalResult *r = &runs[p].result;
+        printf("%-10s %9llu %9llu %6.2f%% %12.1f %12llu %12.1f %10llu %10.0f %10llu\n",
+               runs[p].policy,
+               (unsigned long long)r->jobs,
+               (unsigned long long)r->misses,
+               r->judged ? 100.0 * (double)r->misses / (double)r->judged : 0.0,
+               r->misses ? (double)r->tardinessUs / (double)r->misses : 0.0,
+               (unsigned long long)r->maxTardinessUs,
+               r->jobs ? (double)r->responseUs / (double)r->jobs : 0.0,
+               (unsigned long long)r->decisions,
+               r->decisions ? (double)r->decideNs / (double)r->decisions : 0.0,
+               (unsigned long long)r->maxDecideNs);
+    }
+    printf("\nModel: %s\n", EVAL_MODEL_NOTE);
+    printf("\nMisses by criticality (DAL_A/B/C/D):\n");
+    for (int p = 0; p < count; p++)
+    {
+        const EvalResult *r = &runs[p].result;
+        printf("  %-10s %llu/%llu/%llu/%llu\n", runs[p].policy,
+               (unsigned long long)r->missesByLevel[DAL_A], (unsigned long long)r->missesByLevel[DAL_B],
+               (unsigned long long)r->missesByLevel[DAL_C], (unsigned long long)r->missesByLevel[DAL_D]);
+    }
+
+    if (!outputPath)
+    {
+        return;
+    }
+
+    FILE *out = fopen(outputPath, "w");
+    if (!out)
+    {
+        printf("Error: Cannot create %s\n", outputPath);
+        return;
+    }
+    fprintf(out, "{\n  \"records\": %zu,\n  \"durationUs\": %llu,\n  \"model\": \"%s\",\n  \"policies\": [",
+            g_recordCount, (unsigned long long)(g_records[g_recordCount - 1].timeUs - g_records[0].timeUs),
+            EVAL_MODEL_NOTE);
+    for (int p = 0; p < count; p++)
+    {
+        const EvalResult *r = &runs[p].result;
+        fprintf(out, "%s\n    {\"policy\": \"%s\", \"jobs\": %llu, \"misses\": %llu, \"unfinished\": %llu, "
+                     "\"tardinessUs\": %llu, \"maxTardinessUs\": %llu, \"responseUs\": %llu, "
+                     "\"missesByLevel\": [%llu, %llu, %llu, %llu], \"jobsByLevel\": [%llu, %llu, %llu, %llu], "
+                     "\"decisions\": %llu, \"decideNs\": %llu, \"maxDecideNs\": %llu}",
+                p ? "," : "", runs[p].policy,
+                (unsigned long long)r->jobs, (unsigned long long)r->misses, (unsigned long long)r->unfinished,
+                (unsigned long long)r->tardinessUs, (unsigned long long)r->maxTardinessUs,
+                (unsigned long long)r->responseUs,
+                (unsigned long long)r->missesByLevel[0], (unsigned long long)r->missesByLevel[1],
+                (unsigned long long)r->missesByLevel[2], (unsigned long long)r->missesByLevel[3],
+                (unsigned long long)r->jobsByLevel[0], (unsigned long long)r->jobsByLevel[1],
+                (unsigned long long)r->jobsByLevel[2], (unsigned long long)r->jobsByLevel[3],
+                (unsigned long long)r->decisions, (unsigned long long)r->decideNs,
+                (unsigned long long)r->maxDecideNs);
+    }
+    fprintf(out, "\n  ]\n}\n");
+    fclose(out);
+    printf("\nReport written to %s\n", outputPath);
+}
+
+int main(int argc, char *argv[])
+{
+    static char policyList[256] = "";
+    const SchedPolicy *policies[EVAL_MAX_POLICIES];
+    const char *outputPath = NULL;
+    int policyCount = 0;
+
+    if (argc < 2 || argc % 2 != 0)
+    {
+        printf("Usage: %s <sched.log> [--policies RMS,EDF,...] [--output <report.json>]\n", argv[0]);
+        return 1;
+    }
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--policies") == 0)
+        {
+            strncpy(policyList, argv[i + 1], sizeof(policyList) - 1);
+        }
+        else if (strcmp(argv[i], "--output") == 0)
+        {
+            outputPath = argv[i + 1];
+        }
+        else
+        {
+            printf("Error: Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    for (char *name = strtok(policyList, ","); name && policyCount < EVAL_MAX_POLICIES; name = strtok(NULL, ","))
+    {
+        policies[policyCount] = sched_policy_find(name);
+        if (!policies[policyCount])
+        {
+            printf("Error: Unknown scheduling policy %s\n", name);
+            return 1;
+        }
+        policyCount++;
+    }
+    for (int p = 0; policyList[0] == '\0' && p < sched_policy_count(); p++)
+    {
+        policies[policyCount++] = sched_policy_at(p); // Default: every registered policy
+    }
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    g_nsPerCount = 1000000000.0 / (double)frequency.QuadPart;
+
+    if (eval_load(argv[1]) != 0 || eval_assign_demands() != 0)
+    {
+        return 1;
+    }
+
+    // The ML policy needs the engine's model; the replays never start the kernel
+    kernel_init();
+
+    EvalRun *runs = (EvalRun *)calloc(policyCount, sizeof(EvalRun));
+    HANDLE threads[EVAL_MAX_POLICIES];
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+
+    printf("\nReplaying %zu records over %d task slots against %d policies\n", g_recordCount, g_slotCount, policyCount);
+    for (int p = 0; p < policyCount; p++)
+    {
+        if (!runs || eval_run_init(&runs[p], policies[p]) != 0)
+        {
+            printf("Error: Out of memory for the %s replay\n", policies[p]->name);
+            return 1;
+        }
+    }
+
+    uint64_t start = eval_now_ns();
+    for (int p = 0; p < policyCount; p++)
+    {
+        threads[p] = CreateThread(NULL, 0, eval_thread_func, &runs[p], 0, NULL);
+        if (!threads[p])
+        {
+            printf("Error: Failed to create replay thread\n");
+            return 1;
+        }
+        SetThreadAffinityMask(threads[p], (DWORD_PTR)1 << (p % systemInfo.dwNumberOfProcessors));
+    }
+    WaitForMultipleObjects(policyCount, threads, TRUE, INFINITE);
+    printf("Replays finished in %.1f ms\n", (double)(eval_now_ns() - start) / 1000000.0);
+
+    eval_report(runs, policyCount, outputPath);
+
+    for (int p = 0; p < policyCount; p++)
+    {
+        CloseHandle(threads[p]);
+        eval_run_free(&runs[p]);
+    }
+    free(runs);
+    free(g_records);
+    free(g_demandUs);
+    return 0;
+}
@@ -0,0 +1,255 @@
+// Offline trace decoder: converts a binary trace written by trace_start into
+// Chrome trace event JSON, which loads in chrome://tracing and Perfetto.
+// Usage: trace_decode <trace.bin> <trace.json>
+
+#include "../include/trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+    char phase;
+    uint32_t category;
+    const char *name;
+    const char *args[4];
+} TraceEventInfo;
+
+#define TRACE_EVENT_INFO(event, category, phase, name, a0, a1, a2, a3) {phase, category, name, {a0, a1, a2, a3}},
+
+static const TraceEventInfo g_eventInfo[TRACE_EVENT_COUNT] = {TRACE_EVENT_LIST(TRACE_EVENT_INFO)};
+
+// Names collected from the metadata events
+typedef struct
+{
+    uint32_t id;
+    char name[32];
+} TraceName;
+
+typedef struct
+{
+    TraceName *names;
+    int count;
+    int capacity;
+} TraceNameTable;
+
+static TraceNameTable g_taskNames = {0};
+static TraceNameTable g_threadNames = {0};
+
+static const char *category_name(uint32_t category)
+{
+    switch (category)
+    {
+    case TRACE_CAT_META:
+        return "meta";
+    case TRACE_CAT_SCHED:
+        return "sched";
+    case TRACE_CAT_TASK:
+        return "task";
+    case TRACE_CAT_FAULT:
+        return "fault";
+    case TRACE_CAT_MEMORY:
+        return "memory";
+    case TRACE_CAT_TMR:
+        return "tmr";
+    case TRACE_CAT_BUDGET:
+        return "budget";
+    default:
+        return "unknown";
+    }
+}
+
+static TraceName *name_lookup(TraceNameTable *table, uint32_t id, int create)
+{
+    for (int i = 0; i < table->count; i++)
+    {
+        if (table->names[i].id == id)
+        {
+            return &table->names[i];
+        }
+    }
+    if (!create)
+    {
+        return NULL;
+    }
+
+    if (table->count == table->capacity)
+    {
+        int capacity = table->capacity ? table->capacity * 2 : 16;
+        TraceName *names = (TraceName *)realloc(table->names, capacity * sizeof(TraceName));
+        if (!names)
+        {
+            return NULL;
+        }
+        table->names = names;
+        table->capacity = capacity;
+    }
+
+    TraceName *entry = &table->names[table->count++];
+    memset(entry, 0, sizeof(TraceName));
+    entry->id = id;
+    return entry;
+}
+
+// Reassemble a name from its 8-character pieces
+static void name_collect(TraceNameTable *table, uint32_t id, const TraceEvent *record)
+{
+    uint32_t offset = record->args[1];
+    TraceName *entry = name_lookup(table, id, 1);
+    if (!entry || offset + 8 > sizeof(entry->name))
+    {
+        return;
+    }
+    memcpy(entry->name + offset, &record->args[2], 8);
+    entry->name[sizeof(entry->name) - 1] = '\0';
+}
+
+static void write_json_string(FILE *out, const char *text)
+{
+    fputc('"', out);
+    for (; *text; text++)
+    {
+        if (*text == '"' || *text == '\\')
+        {
+            fputc('\\', out);
+        }
+        if ((unsigned char)*text >= 0x20)
+        {
+            fputc(*text, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void write_event(FILE *out, const TraceEvent *record, const TraceFileHeader *header)
+{
+    const TraceEventInfo *info = &g_eventInfo[record->event];
+    double ts = record->tsc > header->startTsc ? (double)(record->tsc - header->startTsc) / header->tscPerUs : 0.0;
+
+    char name[80];
+    const TraceName *task = strcmp(info->args[0], "taskId") == 0 ? name_lookup(&g_taskNames, record->args[0], 0) : NULL;
+    if (task)
+    {
+        snprintf(name, sizeof(name), "%s %s", info->name, task->name);
+    }
+    else
+    {
+        snprintf(name, sizeof(name), "%s", info->name);
+    }
+
+    fprintf(out, ",\n{\"name\":");
+    write_json_string(out, name);
+    fprintf(out, ",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u",
+            category_name(info->category), info->phase, ts, record->threadId);
+    if (info->phase == 'i')
+    {
+        fprintf(out, ",\"s\":\"t\"");
+    }
+
+    fprintf(out, ",\"args\":{");
+    int first = 1;
+    for (int i = 0; i < 4; i++)
+    {
+        if (info->args[i][0])
+        {
+            fprintf(out, "%s\"%s\":%u", first ? "" : ",", info->args[i], record->args[i]);
+            first = 0;
+        }
+    }
+    fprintf(out, "}}");
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        printf("Usage: %s <trace.bin> <trace.json>\n", argv[0]);
+        return 1;
+    }
+
+    FILE *in = fopen(argv[1], "rb");
+    if (!in)
+    {
+        printf("Error: Cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    TraceFileHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1 || memcmp(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TRACE_FILE_VERSION || header.eventSize != sizeof(TraceEvent) || header.tscPerUs <= 0.0)
+    {
+        printf("Error: %s is not a version %d trace\n", argv[1], TRACE_FILE_VERSION);
+        fclose(in);
+        return 1;
+    }
+
+    // Names may be emitted after the events that use them, so load everything first
+    fseek(in, 0, SEEK_END);
+    long bytes = ftell(in) - (long)sizeof(header);
+    fseek(in, (long)sizeof(header), SEEK_SET);
+    size_t count = bytes > 0 ? (size_t)bytes / sizeof(TraceEvent) : 0;
+    TraceEvent *records = (TraceEvent *)malloc(count ? count * sizeof(TraceEvent) : 1);
+    if (!records || fread(records, sizeof(TraceEvent), count, in) != count)
+    {
+        printf("Error: Failed to read %zu events from %s\n", count, argv[1]);
+        free(records);
+        fclose(in);
+        return 1;
+    }
+    fclose(in);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (records[i].event == TRACE_TASK_NAME)
+        {
+            name_collect(&g_taskNames, records[i].args[0], &records[i]);
+        }
+        else if (records[i].event == TRACE_THREAD_NAME)
+        {
+            name_collect(&g_threadNames, records[i].threadId, &records[i]);
+        }
+    }
+
+    FILE *out = fopen(argv[2], "w");
+    if (!out)
+    {
+        printf("Error: Cannot create %s\n", argv[2]);
+        free(records);
+        return 1;
+    }
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"ml_rtos\"}}");
+    for (int i = 0; i < g_threadNames.count; i++)
+    {
+        fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                g_threadNames.names[i].id);
+        write_json_string(out, g_threadNames.names[i].name);
+        fprintf(out, "}}");
+    }
+
+    size_t written = 0, unknown = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (records[i].event >= TRACE_EVENT_COUNT)
+        {
+            unknown++;
+        }
+        else if (g_eventInfo[records[i].event].phase != 'M')
+        {
+            write_event(out, &records[i], &header);
+            written++;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    fclose(out);
+
+    printf("Decoded %zu events (%d tasks, %d named threads, %zu unknown) into %s\n",
+           written, g_taskNames.count, g_threadNames.count, unknown, argv[2]);
+
+    free(records);
+    free(g_taskNames.names);
+    free(g_threadNames.names);
+    return 0;
+}